@@ -10,22 +10,152 @@
 #include <functional>
 #include <iomanip>
 #include <iostream>
+#include <memory_resource>
+#include <optional>
 #include <print>
 #include <ranges>
 #include <sstream>
+#include <stop_token>
 #include <string>
+#include <thread>
+#include <utility>
 #include <variant>
 #include <vector>
 
+#include "batch_parser.hpp"
+#include "budget.hpp"
+#include "diff.hpp"
 #include "file.hpp"
 #include "function.hpp"
 #include "metric.hpp"
 #include "metric_accumulator.hpp"
+#include "prefetcher.hpp"
 
 namespace analyzer {
 
 namespace rv = std::ranges::views;
 namespace rs = std::ranges;
+
+/**
+ * @brief Анализирует один файл и передаёт каждую функцию вместе с результатами её метрик в `consumer`.
+ *
+ * Функции и результаты метрик размещаются в ресурсе памяти файла — обычно это его арена
+ * (`std::pmr::monotonic_buffer_resource`), которая освобождается целиком после обработки файла.
+ * Поэтому `consumer` не должен сохранять ссылки на переданные объекты: если они нужны дольше, их копируют.
+ *
+ * Если файл выходит за `budget` (время отсчитывается от `started`, то есть включает разбор файла),
+ * `consumer` не вызывается ни разу, а возвращается описание пропуска: частичные результаты файла не попадают
+ * ни в анализ, ни в кэш результатов `metric_extractor` — в кэш они записываются, только когда файл принят.
+ *
+ * Какие функции извлекаются (вложенные, лямбды), задаёт `function_extractor`.
+ */
+std::optional<analyzer::file::SkippedFile>
+AnalyseFile(const analyzer::file::File &file, const analyzer::metric::MetricExtractor &metric_extractor,
+            auto &&consumer, const analyzer::file::Budget &budget = {},
+            analyzer::file::Budget::Clock::time_point started = analyzer::file::Budget::Clock::now(),
+            const analyzer::function::FunctionExtractor &function_extractor = {}) {
+    if (auto skipped = budget.CheckFile(file))
+        return skipped;
+
+    auto functions = function_extractor.Get(file);
+    std::pmr::vector<analyzer::metric::MetricResults> results{file.Resource()};
+    std::pmr::vector<analyzer::metric::Fingerprint> fingerprints(functions.size(), file.Resource());
+    results.reserve(functions.size());
+    for (size_t i = 0; i < functions.size(); ++i) {
+        if (auto skipped = budget.CheckDeadline(file.name, started))
+            return skipped;
+        results.push_back(metric_extractor.GetUncommitted(functions[i], fingerprints[i]));
+    }
+    for (size_t i = 0; i < functions.size(); ++i) {
+        metric_extractor.Commit(fingerprints[i], functions[i], results[i]);
+        consumer(functions[i], results[i]);
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Анализирует файлы по одному и передаёт каждую функцию вместе с результатами её метрик в `consumer`,
+ * не накапливая результатов.
+ *
+ * AST получаются пакетами через `parser`: один процесс tree-sitter на `batch_size` файлов,
+ * `jobs` процессов одновременно. Файлы, для которых пакетный разбор не удался, разбираются по одному.
+ * Каждый файл обрабатывается в собственной арене, поэтому, как и в AnalyseFile, `consumer` не должен
+ * сохранять ссылки на переданные объекты.
+ *
+ * При ненулевом `prefetch_depth` чтение и разбор файлов идут в фоне (`Prefetcher`), опережая анализ
+ * не более чем на `prefetch_depth` файлов.
+ *
+ * Файлы, вышедшие за `budget`, пропускаются: в stderr печатается предупреждение, а описание пропуска
+ * добавляется в `skipped`, если он передан.
+ *
+ * Когда у `stop` запрошена остановка (например, самим `consumer`), оставшиеся функции в `consumer`
+ * не передаются, следующие файлы не анализируются, а упреждающее чтение прекращается после
+ * уже запущенных пакетов.
+ */
+void StreamFunctions(const std::vector<std::string> &files, const analyzer::metric::MetricExtractor &metric_extractor,
+                     auto &&consumer, const analyzer::file::BatchParser &parser = analyzer::file::BatchParser{},
+                     size_t prefetch_depth = 0, const analyzer::file::Budget &budget = {},
+                     std::vector<analyzer::file::SkippedFile> *skipped = nullptr, std::stop_token stop = {},
+                     const analyzer::function::FunctionExtractor &function_extractor = {}) {
+    auto consume = [&consumer, &stop](const auto &function, const auto &results) {
+        if (!stop.stop_requested())
+            consumer(function, results);
+    };
+
+    // `parse_time` — доля файла во времени пакетного разбора: таймаут бюджета включает и её. Если пакетного
+    // AST нет, файл разбирается уже здесь, после засечки времени.
+    auto analyse = [&](const std::string &filename, std::optional<std::string_view> ast,
+                       std::optional<std::string_view> source, analyzer::file::Budget::Clock::duration parse_time) {
+        const auto started = analyzer::file::Budget::Clock::now() - parse_time;
+        // Слишком большой AST отсекается до того, как его скопируют в арену файла.
+        auto over_budget = ast ? budget.CheckAstSize(filename, ast->size()) : std::nullopt;
+        if (!over_budget) {
+            std::pmr::monotonic_buffer_resource arena;
+            auto analyse_file = [&](const analyzer::file::File &file) {
+                return AnalyseFile(file, metric_extractor, consume, budget, started, function_extractor);
+            };
+            if (ast && source) {
+                over_budget = analyse_file(analyzer::file::File(filename, *ast, *source, &arena));
+            } else if (ast) {
+                over_budget = analyse_file(analyzer::file::File(filename, *ast, &arena));
+            } else {
+                over_budget = analyse_file(analyzer::file::File(filename, &arena));
+            }
+        }
+        if (over_budget) {
+            std::println(stderr, "{}", analyzer::file::FormatWarning(*over_budget));
+            if (skipped)
+                skipped->push_back(std::move(*over_budget));
+        }
+    };
+
+    if (prefetch_depth > 0) {
+        analyzer::file::Prefetcher prefetcher(files, parser, prefetch_depth);
+        while (!stop.stop_requested()) {
+            auto prefetched = prefetcher.Next();
+            if (!prefetched)
+                break;
+            // Без исходника файл не открылся: File(filename) сообщит об этом так же, как без упреждения.
+            analyse(prefetched->filename, prefetched->source ? prefetched->ast : std::nullopt, prefetched->source,
+                    prefetched->parse_time);
+        }
+        return;
+    }
+
+    // Разбираем файлы группами, чтобы в памяти одновременно были AST только одной группы.
+    const size_t group_size = parser.batch_size * parser.jobs;
+    for (size_t group_start = 0; group_start < files.size() && !stop.stop_requested(); group_start += group_size) {
+        std::vector<std::string> group(files.begin() + group_start,
+                                       files.begin() + std::min(files.size(), group_start + group_size));
+        auto parsed = parser.Parse(group);
+        for (const auto &[filename, ast, parse_time] : rv::zip(group, parsed.asts, parsed.parse_times)) {
+            if (stop.stop_requested())
+                break;
+            analyse(filename, ast, std::nullopt, parse_time);
+        }
+    }
+}
+
 /**
  * @brief Анализирует список Python-файлов и извлекает метрики для всех функций и методов.
  *
@@ -37,10 +167,46 @@ namespace rs = std::ranges;
  * 4. Объединяет все функции из всех файлов в один плоский список (`join`).
  * 5. Для каждой функции вычисляет набор метрик через переданный `metric_extractor`.
  * 6. Возвращает вектор пар: (функция, результаты её метрик).
+ *
+ * Файлы читаются и разбираются так же, как в StreamFunctions. В результат попадают копии,
+ * которые размещаются в обычной куче и переживают арены файлов.
+ */
+inline auto AnalyseFunctions(const std::vector<std::string> &files,
+                             const analyzer::metric::MetricExtractor &metric_extractor,
+                             const analyzer::file::BatchParser &parser = analyzer::file::BatchParser{},
+                             size_t prefetch_depth = 0, const analyzer::file::Budget &budget = {},
+                             std::vector<analyzer::file::SkippedFile> *skipped = nullptr,
+                             const analyzer::function::FunctionExtractor &function_extractor = {}) {
+    std::vector<std::pair<analyzer::function::Function, analyzer::metric::MetricResults>> analysis;
+    auto collect = [&analysis](const auto &function, const auto &results) { analysis.emplace_back(function, results); };
+    StreamFunctions(files, metric_extractor, collect, parser, prefetch_depth, budget, skipped, {}, function_extractor);
+    return analysis;
+}
+
+/**
+ * @brief Анализирует только функции файла, которые пересекаются с изменёнными строками `changed`.
+ *
+ * Метрики остальных функций не считаются, поэтому стоимость анализа растёт с размером изменения,
+ * а не файла. Функции извлекаются так же, как при обычном анализе с тем же `function_extractor`:
+ * без вложенных функций изменение во вложенной функции относится к объемлющей.
  */
-auto AnalyseFunctions(const std::vector<std::string> &files,
-                      const analyzer::metric::MetricExtractor &metric_extractor) {
-    // здесь ваш код
+inline auto AnalyseChangedFunctions(const std::string &filename, const std::vector<analyzer::diff::LineRange> &changed,
+                                    const analyzer::metric::MetricExtractor &metric_extractor,
+                                    const analyzer::function::FunctionExtractor &function_extractor = {}) {
+    std::vector<std::pair<analyzer::function::Function, analyzer::metric::MetricResults>> analysis;
+    if (changed.empty())
+        return analysis;
+
+    std::pmr::monotonic_buffer_resource arena;
+    analyzer::file::File file(filename, &arena);
+    for (const auto &function : function_extractor.Get(file)) {
+        if (!function.span || !analyzer::diff::Touches(changed, *function.span))
+            continue;
+        // Результаты размещены в арене файла, поэтому в ответ попадают их копии.
+        const auto results = metric_extractor.Get(function);
+        analysis.emplace_back(function, results);
+    }
+    return analysis;
 }
 
 /**
@@ -62,7 +228,11 @@ auto AnalyseFunctions(const std::vector<std::string> &files,
  * действительно исчезают из результата.
  */
 auto SplitByClasses(const auto &analysis) {
-    // здесь ваш код
+    // Одноимённые классы соседних файлов — разные классы, поэтому граница группы — и смена файла.
+    return analysis | rv::filter([](const auto &elem) { return elem.first.class_name.has_value(); }) |
+           rv::chunk_by([](const auto &lhs, const auto &rhs) {
+               return lhs.first.filename == rhs.first.filename && lhs.first.class_name == rhs.first.class_name;
+           });
 }
 
 /**
@@ -74,7 +244,8 @@ auto SplitByClasses(const auto &analysis) {
  * - Использует `chunk_by`, поэтому **порядок функций в `analysis` должен быть по файлам**.
  */
 auto SplitByFiles(const auto &analysis) {
-    // здесь ваш код
+    return analysis |
+           rv::chunk_by([](const auto &lhs, const auto &rhs) { return lhs.first.filename == rhs.first.filename; });
 }
 
 /**
@@ -83,11 +254,42 @@ auto SplitByFiles(const auto &analysis) {
  * Эта функция:
  * - Проходит по каждому элементу результата `AnalyseFunctions`
  *   (то есть по каждой функции и её метрикам).
- * - Передаёт результаты метрик (`elem.second`) в аккумулятор через `AccumulateNextFunctionResults`.
+ * - Передаёт функцию (`elem.first`) и результаты её метрик (`elem.second`) в аккумулятор
+ *   через `AccumulateNextFunctionResults`.
  */
 void AccumulateFunctionAnalysis(const auto &analysis,
                                 const analyzer::metric_accumulator::MetricsAccumulator &accumulator) {
-    // здесь ваш код
+    rs::for_each(analysis, [&accumulator](const auto &elem) {
+        accumulator.AccumulateNextFunctionResults(elem.first, elem.second);
+    });
+}
+
+/**
+ * @brief Агрегирует метрики всех функций в `jobs` потоков.
+ *
+ * Каждый поток получает непрерывный кусок `analysis` и пишет в свой слот аккумулятора, поэтому
+ * аккумулятор переводится в режим слотов, если ещё не в нём. Слоты сливаются при получении результата
+ * через GetFinalizedAccumulator.
+ */
+void AccumulateFunctionAnalysis(const auto &analysis, analyzer::metric_accumulator::MetricsAccumulator &accumulator,
+                                size_t jobs) {
+    const size_t size = rs::size(analysis);
+    jobs = std::min(jobs, size);
+    if (jobs <= 1) {
+        AccumulateFunctionAnalysis(analysis, std::as_const(accumulator));
+        return;
+    }
+    if (!accumulator.IsSharded())
+        accumulator.EnableSharding(jobs);
+
+    std::vector<std::jthread> workers;
+    workers.reserve(jobs);
+    for (size_t worker = 0; worker < jobs; ++worker) {
+        workers.emplace_back([&analysis, &accumulator, begin = size * worker / jobs, end = size * (worker + 1) / jobs] {
+            for (size_t i = begin; i < end; ++i)
+                accumulator.AccumulateNextFunctionResults(analysis[i].first, analysis[i].second);
+        });
+    }
 }
 
 }  // namespace analyzer
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace analyzer::file {
+
+/**
+ * @brief Пакетный разбор файлов через CLI tree-sitter.
+ *
+ * Вместо отдельного процесса на каждый файл один вызов `tree-sitter parse --paths <список>` получает
+ * сразу `batch_size` файлов, а несколько таких процессов (`jobs`) работают параллельно.
+ * Общий вывод процесса разбивается обратно на AST отдельных файлов: деревья печатаются по одному
+ * на файл в порядке списка, каждое — сбалансированное S-выражение, начинающееся с новой строки.
+ */
+struct BatchParser {
+    static constexpr size_t kDefaultBatchSize = 256;
+
+    // Результат разбора группы файлов. AST не копируются: это участки буферов с выводом процессов.
+    struct ParsedAsts {
+        std::vector<std::string> outputs;
+        std::vector<std::optional<std::string_view>> asts;
+        // Доля файла во времени разбора его пакета: отдельно по файлам tree-sitter время не сообщает.
+        // Нулевая у файлов без AST: они разбираются заново поодиночке, и это время учитывается там.
+        std::vector<std::chrono::steady_clock::duration> parse_times;
+    };
+
+    explicit BatchParser(size_t batch_size = kDefaultBatchSize,
+                         size_t jobs = std::max(1u, std::thread::hardware_concurrency()));
+
+    // AST для каждого файла в порядке `filenames`. Если вывод пакета не удалось сопоставить с файлами
+    // (например, процесс упал на одном из них), пакет разбирается заново по половинам, и std::nullopt
+    // возвращается только для файлов, которые не удалось разобрать даже поодиночке.
+    ParsedAsts Parse(const std::vector<std::string> &filenames) const;
+
+    // Разбивает вывод tree-sitter на S-выражения верхнего уровня, начинающиеся с новой строки. Остальной
+    // текст, включая строки сводки с `(ERROR ...)` для файлов с синтаксическими ошибками, игнорируется.
+    static std::vector<std::string_view> SplitTrees(std::string_view output);
+
+    // Делит время пакета `elapsed` между его файлами пропорционально размеру их AST. Целиком оно
+    // досталось бы каждому файлу, и с таймаутом на файл все файлы медленного пакета вышли бы за бюджет.
+    static void ShareBatchTime(std::chrono::steady_clock::duration elapsed,
+                               std::span<const std::optional<std::string_view>> asts,
+                               std::span<std::chrono::steady_clock::duration> parse_times);
+
+    size_t batch_size;
+    size_t jobs;
+
+private:
+    void ParseBatch(std::span<const std::string> filenames, std::string &output,
+                    std::span<std::optional<std::string_view>> asts) const;
+};
+
+}  // namespace analyzer::file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+namespace analyzer {
+
+/**
+ * @brief Очередь ограниченной ёмкости между потоком-производителем и потоком-потребителем.
+ *
+ * Push блокируется, пока очередь заполнена, поэтому производитель опережает потребителя
+ * не более чем на `capacity` элементов. После Close новые элементы не принимаются,
+ * а Pop отдаёт оставшиеся и затем возвращает std::nullopt.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity{capacity == 0 ? 1 : capacity} {}
+
+    // Возвращает false, если очередь закрыта и элемент не принят.
+    bool Push(T value) {
+        std::unique_lock lock(mutex);
+        blocked_producers++;
+        not_full.wait(lock, [this] { return closed || items.size() < capacity; });
+        blocked_producers--;
+        if (closed)
+            return false;
+        items.push_back(std::move(value));
+        not_empty.notify_one();
+        return true;
+    }
+
+    std::optional<T> Pop() {
+        std::unique_lock lock(mutex);
+        not_empty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty())
+            return std::nullopt;
+        T value = std::move(items.front());
+        items.pop_front();
+        not_full.notify_one();
+        return value;
+    }
+
+    size_t Size() const {
+        std::lock_guard lock(mutex);
+        return items.size();
+    }
+
+    // Число потоков, ждущих в Push свободного места: снаружи счётчик виден только во время ожидания.
+    size_t BlockedProducers() const {
+        std::lock_guard lock(mutex);
+        return blocked_producers;
+    }
+
+    void Close() {
+        std::lock_guard lock(mutex);
+        closed = true;
+        not_full.notify_all();
+        not_empty.notify_all();
+    }
+
+private:
+    const size_t capacity;
+    mutable std::mutex mutex;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+    std::deque<T> items;
+    size_t blocked_producers = 0;
+    bool closed = false;
+};
+
+}  // namespace analyzer
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "file.hpp"
+
+namespace analyzer::file {
+
+enum class SkipReason { Timeout, AstSize, FunctionCount };
+
+std::string_view ToString(SkipReason reason);
+
+// Файл, пропущенный из-за превышения бюджета. Для таймаута limit и actual — в миллисекундах.
+struct SkippedFile {
+    std::string filename;
+    SkipReason reason;
+    size_t limit;
+    size_t actual;
+};
+
+// Предупреждение в формате ключ=значение, удобном для разбора логов:
+// warning: file skipped file="a.py" reason=ast_size limit=1000 actual=2048
+std::string FormatWarning(const SkippedFile &skipped);
+
+/**
+ * @brief Ограничения на обработку одного файла; нулевое значение снимает ограничение.
+ *
+ * Защищают от патологических (например, сгенерированных) файлов: слишком большой AST или слишком
+ * много функций отсекаются до извлечения функций, а время разбора и анализа проверяется
+ * между функциями. Файл, вышедший за бюджет, пропускается целиком, остальные обрабатываются как обычно.
+ */
+struct Budget {
+    using Clock = std::chrono::steady_clock;
+
+    std::chrono::milliseconds timeout{0};
+    size_t max_ast_bytes = 0;
+    size_t max_functions = 0;
+
+    std::optional<SkippedFile> CheckAstSize(const std::string &filename, size_t ast_bytes) const;
+    // Проверяет размер AST и число функций в уже построенном индексе файла.
+    std::optional<SkippedFile> CheckFile(const File &file) const;
+    std::optional<SkippedFile> CheckDeadline(const std::string &filename, Clock::time_point started) const;
+};
+
+}  // namespace analyzer::file
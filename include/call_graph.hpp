@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "function.hpp"
+
+namespace analyzer::call_graph {
+
+// Номер функции в графе: позиция в списке, из которого граф построен.
+using FunctionId = std::uint32_t;
+
+// Место вызова: имя вызываемой функции и то, у чего она вызвана.
+struct CallSite {
+    std::string_view name;
+    // Последний компонент выражения перед именем: "self" в `self.bar()`, "ns" в `ns::bar()`, "b" в `a.b.bar()`;
+    // пусто у простого вызова `bar()`.
+    std::string_view receiver;
+
+    bool operator==(const CallSite &) const = default;
+};
+
+/**
+ * @brief Места вызовов в `f` с повторами; вложенный вызов `f(g(x))` идёт раньше внешнего.
+ *
+ * Место вызова — узел категории Call языка функции. Имя вызываемой функции — последний идентификатор
+ * в поле "function:" этого узла: `foo` в `foo(x)`, `bar` в `self.bar()` или `ns::bar()`. Текст имени берётся
+ * из f.source, поэтому у функции, собранной вручную без исходника, вызовов нет. Вызовы во вложенных
+ * функциях и lambda относятся к объемлющей функции, как и остальные её метрики.
+ */
+std::vector<CallSite> ExtractCallSites(const function::Function &f);
+
+// Имена из ExtractCallSites.
+std::vector<std::string_view> ExtractCallees(const function::Function &f);
+
+// Связность класса с остальным кодом.
+struct ClassCoupling {
+    int fan_in = 0;   // Функции вне класса, которые вызывают его методы.
+    int fan_out = 0;  // Функции вне класса, которые вызываются из его методов.
+};
+
+/**
+ * @brief Граф вызовов набора функций в формате CSR (compressed sparse row).
+ *
+ * Вызываемые функции каждой вершины лежат в одном массиве подряд, а offsets[id]..offsets[id + 1] задаёт
+ * её отрезок; так же хранятся обратные рёбра. Ребро занимает по 4 байта в каждом направлении, поэтому
+ * миллионы рёбер укладываются в десятки мегабайт.
+ *
+ * Вызов разрешается среди одноимённых функций по тому, у чего он сделан: `self.f()`, `this->f()` и
+ * `cls.f()` в методе ведут к методам его класса, `Foo.f()` — к методам класса Foo, `utils.f()` — к функциям
+ * файла utils.*. Иначе ребро ведёт к одноимённым функциям файла вызывающей функции, а если их нет —
+ * к единственной одноимённой функции других файлов. Вызов, которому подходят несколько функций других
+ * файлов (`get`, `run`), в граф не попадает и считается неразрешённым: ребро ко всем им раздуло бы граф
+ * и сделало бы fan-in таких имён бессмысленным. Вызовы функций, которых нет среди проанализированных
+ * (библиотечных), и рекурсивные вызовы в граф не попадают. Повторные вызовы одной функции дают одно ребро.
+ */
+class CallGraph {
+public:
+    /**
+     * Частичные графы файлов строятся параллельно в `jobs` потоков (каждый поток берёт очередной файл
+     * и разрешает вызовы его функций), затем сливаются в CSR подсчётом степеней без общей сортировки.
+     * Функции одного файла не обязаны идти подряд.
+     */
+    static CallGraph Build(std::span<const function::Function *const> functions, size_t jobs = 1);
+
+    // Номер функции по файлу, полному имени и строке объявления; std::nullopt, если её нет в графе.
+    std::optional<FunctionId> Find(const function::Function &f) const;
+
+    size_t FunctionCount() const { return callees_offsets.empty() ? 0 : callees_offsets.size() - 1; }
+    size_t EdgeCount() const { return callees.size(); }
+    // Вызовы проанализированных имён, отброшенные из-за неоднозначности.
+    size_t UnresolvedCalls() const { return unresolved_calls; }
+
+    std::span<const FunctionId> Callees(FunctionId id) const;
+    std::span<const FunctionId> Callers(FunctionId id) const;
+
+    int FanOut(FunctionId id) const { return static_cast<int>(Callees(id).size()); }
+    int FanIn(FunctionId id) const { return static_cast<int>(Callers(id).size()); }
+
+    ClassCoupling ForClass(std::string_view filename, std::string_view class_name) const;
+
+private:
+    static std::string Key(const function::Function &f);
+
+    std::unordered_map<std::string, FunctionId> ids;
+    // Класс каждой функции: номер пары (файл, класс) в class_keys или kNoClass.
+    static constexpr std::uint32_t kNoClass = static_cast<std::uint32_t>(-1);
+    std::vector<std::uint32_t> class_of;
+    std::unordered_map<std::string, std::uint32_t> class_keys;
+    std::vector<std::vector<FunctionId>> class_members;
+
+    std::vector<std::uint32_t> callees_offsets;
+    std::vector<FunctionId> callees;
+    std::vector<std::uint32_t> callers_offsets;
+    std::vector<FunctionId> callers;
+    size_t unresolved_calls = 0;
+};
+
+}  // namespace analyzer::call_graph
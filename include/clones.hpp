@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "function.hpp"
+
+namespace analyzer::clones {
+
+// Отпечаток: хэш k-граммы нормализованных лексем и номер её первой лексемы в функции.
+struct Fingerprint {
+    std::uint64_t hash;
+    std::uint32_t position;
+};
+
+/**
+ * @brief Хэши лексем функции, в которых все идентификаторы и все литералы неразличимы.
+ *
+ * Ключевые слова и знаки операций сохраняются, поэтому `total = price * count` и `s = a * b`
+ * совпадают, а `s = a + b` — нет. Лексемы читаются из f.source тем же разбором, что и для метрик
+ * Холстеда (metric_impl/tokens.hpp).
+ */
+std::vector<std::uint64_t> NormalizedTokenHashes(const function::Function &f);
+
+/**
+ * @brief Winnowing (Schleimer, Wilkerson, Aiken): из хэшей всех k-грамм `tokens` в каждом окне
+ * из `window` подряд идущих k-грамм выбирается минимальный (при равенстве — самый правый).
+ *
+ * Соседние окна обычно выбирают одну и ту же k-грамму, и она попадает в результат один раз. Любой общий
+ * двум последовательностям фрагмент длиной не меньше k + window - 1 лексем даёт
+ * им хотя бы один общий отпечаток. Хэши k-грамм считаются скользящим полиномиальным хэшем за O(n).
+ */
+std::vector<Fingerprint> Winnow(std::span<const std::uint64_t> tokens, size_t k, size_t window);
+
+struct CloneOptions {
+    size_t min_tokens = 50;  // Наименьшая длина общего фрагмента, о которой сообщается.
+    size_t gram_tokens = 8;  // k: длина k-граммы; более короткие совпадения считаются шумом.
+    size_t window = 4;       // Окно winnowing; меньше окно — точнее оценка длины, но больше отпечатков.
+};
+
+// Сколько раз хэш может встретиться во всех функциях, чтобы его совпадения ещё учитывались.
+constexpr size_t kMaxPostings = 64;
+
+// Пара функций с общим фрагментом. Номера — позиции в списке, переданном в FindClones; first < second.
+struct ClonePair {
+    std::uint32_t first;
+    std::uint32_t second;
+    size_t shared_tokens;  // Оценка длины общих фрагментов в лексемах first.
+    double similarity;     // shared_tokens относительно длины меньшей из функций, от 0 до 1.
+};
+
+/**
+ * @brief Находит пары функций с общими фрагментами не короче options.min_tokens нормализованных лексем.
+ *
+ * Отпечатки функций считаются в `jobs` потоков, и каждый поток сразу раскладывает их по сегментам
+ * (shards) индекса по старшим битам хэша. Затем сегменты обрабатываются параллельно: отпечатки
+ * сегмента сортируются по хэшу, и каждая группа с одинаковым хэшем даёт совпавшие позиции для всех
+ * пар своих функций. Хэши, встречающиеся больше чем в kMaxPostings местах, — общие шаблоны кода
+ * вроде `return self.x`, а не копии, и пропускаются: так время остаётся почти линейным.
+ *
+ * Длина общего фрагмента оценивается по совпавшим отпечаткам первой функции: отпечатки, идущие не дальше
+ * окна друг от друга, образуют один фрагмент от первой k-граммы до конца последней, поэтому оценка
+ * занижает длину не больше чем на окно с каждой стороны. Повторы внутри одной функции не сообщаются.
+ * Пары упорядочены по убыванию shared_tokens.
+ */
+std::vector<ClonePair> FindClones(std::span<const function::Function *const> functions,
+                                  const CloneOptions &options = {}, size_t jobs = 1);
+
+}  // namespace analyzer::clones
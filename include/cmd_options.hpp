@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <iostream>
 #include <string>
 #include <unordered_map>
 
@@ -12,12 +14,61 @@ public:
     ProgramOptions();
     ~ProgramOptions();
 
-    bool Parse(int argc, char *argv[]);
+    bool Parse(int argc, char *argv[], std::ostream &out = std::cout, std::ostream &err = std::cerr);
 
     const std::vector<std::string> &GetFiles() const { return files_; }
+    size_t GetTop() const { return top_; }
+    size_t GetParseBatchSize() const { return parse_batch_size_; }
+    size_t GetParseJobs() const { return parse_jobs_; }
+    size_t GetPrefetchDepth() const { return prefetch_depth_; }
+    size_t GetFileTimeoutMs() const { return file_timeout_ms_; }
+    size_t GetMaxAstBytes() const { return max_ast_bytes_; }
+    size_t GetMaxFunctions() const { return max_functions_; }
+    bool GetReportDuplicates() const { return report_duplicates_; }
+    size_t GetCloneMinTokens() const { return clone_min_tokens_; }
+    const std::string &GetServe() const { return serve_; }
+    const std::string &GetConnect() const { return connect_; }
+    const std::string &GetDiff() const { return diff_; }
+    const std::string &GetDiffBase() const { return diff_base_; }
+    const std::string &GetHistoryStore() const { return history_store_; }
+    const std::string &GetHistory() const { return history_; }
+    const std::string &GetPolicy() const { return policy_; }
+    bool GetFailFast() const { return fail_fast_; }
+    bool GetNestedFunctions() const { return nested_functions_; }
+    bool GetLambdas() const { return lambdas_; }
+    double GetSampleRate() const { return sample_rate_; }
+    size_t GetSampleFiles() const { return sample_files_; }
+    std::uint64_t GetSampleSeed() const { return sample_seed_; }
+    // Анализируется ли только выборка файлов (--sample-rate или --sample-files).
+    bool IsSampling() const { return sample_rate_ > 0 || sample_files_ > 0; }
+    // Аргументы командной строки без имени программы и без --connect.
+    const std::vector<std::string> &GetForwardedArgs() const { return forwarded_args_; }
 
 private:
     std::vector<std::string> files_;
+    size_t top_ = 0;
+    size_t parse_batch_size_ = 0;
+    size_t parse_jobs_ = 0;
+    size_t prefetch_depth_ = 0;
+    size_t file_timeout_ms_ = 0;
+    size_t max_ast_bytes_ = 0;
+    size_t max_functions_ = 0;
+    bool report_duplicates_ = false;
+    size_t clone_min_tokens_ = 0;
+    std::string serve_;
+    std::string connect_;
+    std::string diff_;
+    std::string diff_base_;
+    std::string history_store_;
+    std::string history_;
+    std::string policy_;
+    bool fail_fast_ = false;
+    bool nested_functions_ = false;
+    bool lambdas_ = false;
+    double sample_rate_ = 0;
+    size_t sample_files_ = 0;
+    std::uint64_t sample_seed_ = 0;
+    std::vector<std::string> forwarded_args_;
     boost::program_options::options_description desc_;
 };
 
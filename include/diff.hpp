@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "sexpr.hpp"
+
+namespace analyzer::diff {
+
+// Диапазон строк [first, last] с нумерацией от нуля, как у координат tree-sitter.
+struct LineRange {
+    size_t first;
+    size_t last;
+    auto operator<=>(const LineRange &) const = default;
+};
+
+// Изменения одного файла. Путь "/dev/null" означает, что файл добавлен или удалён.
+struct FileDiff {
+    std::string old_path;
+    std::string new_path;
+    std::vector<LineRange> old_lines;  // Удалённые строки старой версии.
+    std::vector<LineRange> new_lines;  // Добавленные строки новой версии.
+};
+
+inline constexpr std::string_view kNullPath = "/dev/null";
+
+/**
+ * @brief Разбирает unified diff (вывод `git diff` или `diff -u`).
+ *
+ * Учитываются только действительно изменённые строки, а не контекст ханка. Чистое удаление отмечает
+ * в новой версии строку перед местом удаления, чистая вставка — такую же строку в старой версии:
+ * функция, из которой удалили или в которую добавили строки, тоже считается изменённой.
+ * Префиксы "a/" и "b/" у путей отбрасываются. Соседние строки объединяются в один диапазон.
+ */
+std::vector<FileDiff> ParseUnifiedDiff(std::istream &in);
+
+// Пересекается ли диапазон узла с одним из изменённых диапазонов (отсортированных по началу).
+bool Touches(const std::vector<LineRange> &changed, const sexpr::Span &span);
+
+}  // namespace analyzer::diff
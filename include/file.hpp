@@ -3,23 +3,45 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <memory_resource>
 #include <ranges>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "language.hpp"
+#include "sexpr.hpp"
+
 namespace analyzer::file {
 
+// AST и строки исходника размещаются в переданном ресурсе памяти. Обычно это арена файла
+// (std::pmr::monotonic_buffer_resource), из которой затем берут память и функции, и результаты метрик.
+// Всё это освобождается разом, когда арена уничтожается.
+// Индекс функций и классов (structure) строится потоковым токенизатором, пока AST ещё читается.
 struct File {
     static inline const std::string command_prefix =
         "tree-sitter parse --config-path /root/.config/tree-sitter/config.json ";
-    File(const std::string &filename);
+    File(const std::string &filename, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    // AST уже получен заранее (например, пакетным разбором BatchParser): он копируется в ресурс файла
+    // и индексируется за один проход.
+    File(const std::string &filename, std::string_view parsed_ast,
+         std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    // AST и текст исходника уже прочитаны заранее (например, стадией Prefetcher), диск не читается.
+    File(const std::string &filename, std::string_view parsed_ast, std::string_view source,
+         std::pmr::memory_resource *resource = std::pmr::get_default_resource());
     std::string name;
-    std::string ast;
-    std::vector<std::string> source_lines;
+    const language::Language *language;
+    std::pmr::string ast;
+    sexpr::StructureIndex structure;
+    std::pmr::vector<std::pmr::string> source_lines;
+
+    std::pmr::memory_resource *Resource() const { return ast.get_allocator().resource(); }
 
 private:
-    std::vector<std::string> ReadSourceFile(std::ifstream &file);
-    std::string GetAst(const std::string &filename);
+    std::pmr::vector<std::pmr::string> ReadSourceFile(std::ifstream &file);
+    std::pmr::vector<std::pmr::string> SplitSource(std::string_view source);
+    void IndexAst();
+    std::pmr::string GetAst(const std::string &filename);
 };
 
 }  // namespace analyzer::file
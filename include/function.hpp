@@ -10,6 +10,8 @@
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <memory_resource>
+#include <optional>
 #include <ranges>
 #include <sstream>
 #include <string>
@@ -17,6 +19,8 @@
 #include <vector>
 
 #include "file.hpp"
+#include "language.hpp"
+#include "sexpr.hpp"
 
 namespace fs = std::filesystem;
 namespace rv = std::ranges::views;
@@ -24,38 +28,85 @@ namespace rs = std::ranges;
 
 namespace analyzer::function {
 
+// Сводка управляющих конструкций функции, общая для метрик сложности (см. metric_impl/control_flow.hpp).
+struct ControlFlowSummary {
+    int decision_points = 0;       // Узлы категорий Branch и Loop.
+    int cognitive_complexity = 0;  // Ветвления, взвешенные глубиной вложенности.
+    int max_nesting = 0;           // Наибольшая вложенность ветвлений и циклов.
+};
+
+// Счётчики лексем функции для метрик Холстеда (см. metric_impl/tokens.hpp).
+struct TokenSummary {
+    int distinct_operators = 0;  // n1: разные операторы, ключевые слова и знаки препинания.
+    int distinct_operands = 0;   // n2: разные идентификаторы и литералы.
+    int total_operators = 0;     // N1.
+    int total_operands = 0;      // N2.
+};
+
+// Сводка, посчитанная для конкретной функции. При копировании не переносится: копию функции могут
+// изменить (например, подменить AST или язык), и сводка бы устарела.
+template <typename Summary>
+struct SummaryCache {
+    mutable std::optional<Summary> summary;
+
+    // noexcept нужен, чтобы перемещение Function оставалось noexcept: иначе pmr::vector<Function> при росте
+    // копирует функции, и их строки уходят из арены файла в ресурс по умолчанию.
+    SummaryCache() = default;
+    SummaryCache(const SummaryCache &) noexcept {}
+    SummaryCache &operator=(const SummaryCache &) noexcept {
+        summary.reset();
+        return *this;
+    }
+};
+
 struct Function {
-    std::string filename;
-    std::optional<std::string> class_name;
-    std::string name;
-    std::string ast;
+    std::pmr::string filename;
+    std::optional<std::pmr::string> class_name;
+    std::pmr::string name;
+    std::pmr::string ast;
+    const language::Language *language = &language::Python();
+    // Диапазон функции, уже разобранный при индексации файла. Пуст, если функция собрана вручную из AST.
+    std::optional<sexpr::Span> span = std::nullopt;
+    // Исходный текст функции в границах span. Пуст, если функция собрана вручную из AST.
+    std::pmr::string source = {};
+    // Путь имён объемлющих классов и функций, как __qualname__ в Python: "Outer.method.<locals>.inner".
+    // Пуст, если функция собрана вручную из AST.
+    std::pmr::string qualified_name = {};
+    // Сводки заполняются первой метрикой, которой они нужны, чтобы остальные не проходили AST заново.
+    // Метрики одной функции считаются последовательно, поэтому кэш не синхронизируется.
+    SummaryCache<ControlFlowSummary> control_flow = {};
+    SummaryCache<TokenSummary> tokens = {};
 };
 
+// "Class::method" или имя свободной функции. Для вложенных функций, лямбд и методов вложенных классов,
+// у которых класса и имени недостаточно, — полный путь вида "Outer.method.<locals>.inner".
+std::string QualifiedName(const Function &function);
+
+/**
+ * @brief Извлекает функции файла из индекса structure за один проход по нему.
+ *
+ * По умолчанию извлекаются только функции, не вложенные в другие функции: тела вложенных функций
+ * входят в объемлющую. С `nested_functions` вложенные функции тоже извлекаются отдельно, а с `lambdas` —
+ * и лямбды под именем "<lambda>" (вложенные в функции — только вместе с `nested_functions`).
+ * Лямбда считается объемлющей функцией только вместе с `lambdas`: без него функции внутри
+ * JavaScript IIFE и колбэков извлекаются как функции верхнего уровня.
+ * Декораторы и async на извлечение не влияют: определение функции внутри decorated_definition
+ * индексируется как обычное.
+ *
+ * class_name — ближайший объемлющий класс, даже если между ним и функцией есть другие функции.
+ */
 struct FunctionExtractor {
-    std::vector<Function> Get(const analyzer::file::File &file);
+    bool nested_functions = false;
+    bool lambdas = false;
+
+    // Функции и их строки размещаются в том же ресурсе памяти, что и AST файла.
+    std::pmr::vector<Function> Get(const analyzer::file::File &file) const;
 
 private:
-    struct Position {
-        size_t line;
-        size_t col;
-    };
-
-    struct FunctionNameLocation {
-        Position start;
-        Position end;
-        std::string name;
-    };
-
-    struct ClassInfo {
-        std::string name;
-        Position start;
-        Position end;
-    };
-
-    FunctionNameLocation GetNameLocation(const std::string &function_ast);
-    std::string GetNameFromSource(const std::string &function_ast, const std::vector<std::string> &lines);
-    std::optional<ClassInfo> FindEnclosingClass(const std::string &ast, const FunctionNameLocation &func_loc);
-    std::string GetClassNameFromSource(const ClassInfo &class_info, const std::vector<std::string> &lines);
+    static std::pmr::string GetSource(const sexpr::Span &span, const std::pmr::vector<std::pmr::string> &lines,
+                                      std::pmr::memory_resource *resource);
+    static std::string_view GetNameFromSource(const std::optional<sexpr::Span> &loc,
+                                              const std::pmr::vector<std::pmr::string> &lines);
 };
 
 }  // namespace analyzer::function
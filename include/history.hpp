@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "function.hpp"
+#include "metric.hpp"
+
+namespace analyzer::history {
+
+// Изменение метрики одной функции по всем записанным запускам.
+struct FunctionTrend {
+    std::uint32_t function;  // Номер функции в хранилище, см. HistoryStore::FunctionName.
+    double first;            // Значение в первом запуске, где функция встретилась.
+    double previous;         // Значение в предыдущем таком запуске; совпадает с first, если запуск один.
+    double last;             // Значение в последнем таком запуске.
+    std::uint32_t runs;      // Число запусков, в которых функция встретилась.
+    std::uint32_t last_run;  // Номер последнего из них, начиная с 1.
+};
+
+/**
+ * @brief Дописываемое хранилище результатов метрик по запускам анализатора.
+ *
+ * Каталог хранилища содержит словари и по одному сегменту на запуск:
+ * - functions.dict — личности функций "файл\tкласс\tимя" или "файл\t\tполное_имя", по одной на строку;
+ *   номер строки — номер функции;
+ * - metrics.dict — названия метрик, по одному на строку;
+ * - run-NNNNNNNN.seg — столбцовый сегмент запуска NNNNNNNN.
+ *
+ * Сегмент — заголовок, каталог столбцов и сами столбцы. Столбец метрики — массив float, индексированный
+ * номером функции, с NaN у функций, которых в запуске не было или у которых значение не числовое.
+ * Сегменты читаются через mmap, и запрос по одной метрике касается только заголовка, каталога
+ * и своего столбца каждого сегмента. Записанные файлы не меняются: словари только дописываются,
+ * а сегмент пишется во временный файл и публикуется жёсткой ссылкой, поэтому прерванная запись не портит
+ * историю. Несколько процессов могут писать в одно хранилище: Append держит исключительную блокировку
+ * flock на файле lock и перед записью перечитывает словари и число запусков.
+ *
+ * Функция опознаётся по файлу, классу и имени, а если её полное имя этим не исчерпывается (вложенная
+ * функция, метод класса внутри функции) — по файлу и полному имени. Если в запуске несколько функций
+ * с одной личностью (например, функция, определённая дважды в одной ветке if), записывается первая.
+ */
+class HistoryStore {
+public:
+    // Открывает хранилище в `directory`, создавая каталог при необходимости.
+    explicit HistoryStore(std::filesystem::path directory);
+
+    // Записывает числовые результаты метрик всех функций как новый запуск и возвращает его номер.
+    std::uint32_t Append(std::span<const std::pair<function::Function, metric::MetricResults>> analysis,
+                         std::int64_t timestamp);
+
+    size_t RunCount() const { return runs; }
+
+    // Тренды всех функций, у которых в истории есть значения метрики `metric_name`, по номерам функций.
+    std::vector<FunctionTrend> Trends(std::string_view metric_name) const;
+
+    // "файл::Класс::имя", "файл::имя" или "файл::полное.имя".
+    std::string FunctionName(std::uint32_t function) const;
+
+    // Время запуска `run` (секунды Unix), записанное при Append.
+    std::int64_t RunTimestamp(std::uint32_t run) const;
+
+private:
+    // Словарь строк с номерами по порядку добавления; новые строки дописываются в файл при Flush.
+    struct Dictionary {
+        std::vector<std::string> names;
+        std::unordered_map<std::string, std::uint32_t> ids;
+        std::string pending;
+
+        std::uint32_t Intern(std::string name);
+    };
+
+    // Перечитывает словари и число запусков с диска; вызывается под блокировкой.
+    void Reload();
+    void Load(Dictionary &dictionary, std::string_view filename) const;
+    void Flush(Dictionary &dictionary, std::string_view filename) const;
+    std::filesystem::path SegmentPath(std::uint32_t run) const;
+
+    std::filesystem::path directory;
+    std::uint32_t runs = 0;
+    Dictionary functions;
+    Dictionary metrics;
+};
+
+}  // namespace analyzer::history
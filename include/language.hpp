@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace analyzer::language {
+
+// Абстрактные категории узлов AST, с которыми работают извлечение функций и метрики.
+enum class NodeCategory {
+    Other,
+    Function,
+    Class,
+    Lambda,  // Анонимная функция: lambda в Python, стрелочная функция в JavaScript.
+    Branch,
+    Loop,
+    Parameters,
+    Comment,
+    Call,
+};
+
+// Лексика языка для метрик, которые читают исходный текст функции, а не её AST (см. metric_impl/tokens.hpp).
+struct Lexicon {
+    std::string line_comment;              // "#" или "//".
+    bool block_comments = false;           // Комментарии /* ... */.
+    bool triple_quoted_strings = false;    // Строки """...""" и '''...'''.
+    std::vector<std::string> keywords;     // Ключевые слова, которые считаются операторами; отсортированы.
+
+    bool IsKeyword(std::string_view word) const;
+};
+
+/**
+ * @brief Описание грамматики tree-sitter: какие типы узлов к какой категории относятся.
+ *
+ * Метрики и FunctionExtractor спрашивают категорию узла у языка файла, а не сравнивают
+ * типы узлов с именами из конкретной грамматики, поэтому одинаково работают для всех языков из таблицы.
+ */
+struct Language {
+    std::string name;
+    std::vector<std::string> extensions;
+    // Поле узла функции, внутри которого находится её имя ("name:" в Python, "declarator:" в C++).
+    std::string function_name_field;
+    Lexicon lexicon;
+
+    NodeCategory Categorize(std::string_view node_kind) const;
+    const std::vector<std::string> &KindsOf(NodeCategory category) const;
+
+    Language(std::string name, std::vector<std::string> extensions, std::string function_name_field,
+             const std::vector<std::pair<std::string_view, NodeCategory>> &node_kinds, Lexicon lexicon);
+
+private:
+    struct NodeKindHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view node_kind) const { return std::hash<std::string_view>{}(node_kind); }
+    };
+
+    std::unordered_map<std::string, NodeCategory, NodeKindHash, std::equal_to<>> categories;
+    std::unordered_map<NodeCategory, std::vector<std::string>> kinds;
+};
+
+const std::vector<Language> &SupportedLanguages();
+
+const Language &Python();
+
+// Выбирает язык по расширению файла; для неизвестного расширения бросает std::invalid_argument.
+const Language &LanguageForFile(std::string_view filename);
+
+// Вызывает callback для типа каждого узла S-выражения (слова сразу после открывающей скобки)
+// вместе с позицией этой скобки. Один линейный проход по строке.
+template <typename Callback>
+void ForEachNodeKind(std::string_view ast, Callback &&callback) {
+    for (size_t pos = ast.find('('); pos != std::string_view::npos; pos = ast.find('(', pos + 1)) {
+        size_t kind_end = ast.find_first_of(" \n[()", pos + 1);
+        if (kind_end == std::string_view::npos)
+            kind_end = ast.size();
+        callback(ast.substr(pos + 1, kind_end - pos - 1), pos);
+    }
+}
+
+}  // namespace analyzer::language
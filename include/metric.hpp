@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <any>
 #include <array>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -11,6 +12,7 @@
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <memory_resource>
 #include <ranges>
 #include <sstream>
 #include <string>
@@ -18,6 +20,8 @@
 #include <vector>
 
 #include "function.hpp"
+#include "metric_value.hpp"
+#include "small_vector.hpp"
 
 namespace fs = std::filesystem;
 namespace rv = std::ranges::views;
@@ -26,11 +30,11 @@ namespace rs = std::ranges;
 namespace analyzer::metric {
 
 struct MetricResult {
-    using ValueType = int;
-    // using ValueType = std::variant<int, std::string>; // если захотите реализовывать метрику
-    // naming style
-    std::string metric_name;  // Название метрики
-    ValueType value;          // Значение метрики
+    // Числовое, категориальное (номер в CategoryRegistry) или небольшое массивное значение в 16 байтах.
+    using ValueType = MetricValue;
+    // Название метрики: указывает на строку, которую вернул IMetric::Name, поэтому не владеет памятью.
+    std::string_view metric_name;
+    ValueType value;  // Значение метрики
 };
 
 struct IMetric {
@@ -41,16 +45,30 @@ struct IMetric {
 
 protected:
     virtual MetricResult::ValueType CalculateImpl(const function::Function &f) const = 0;
-    virtual std::string Name() const = 0;
+    // Строка названия должна жить не меньше результатов метрики (обычно это статическое поле kName).
+    virtual std::string_view Name() const = 0;
 };
 
-using MetricResults = std::vector<MetricResult>;
+// Десять метрик функции и две метрики графа вызовов помещаются во встроенный буфер без аллокаций.
+inline constexpr size_t kInlineMetricResults = 12;
+using MetricResults = SmallVector<MetricResult, kInlineMetricResults>;
+
+class ResultCache;
+using Fingerprint = std::uint64_t;
 
 struct MetricExtractor {
     void RegisterMetric(std::unique_ptr<IMetric> metric);
 
+    // Результаты лежат внутри MetricResults; лишь при большом числе метрик буфер берётся из ресурса памяти
+    // функции (обычно — из арены её файла).
     MetricResults Get(const function::Function &func) const;
+    // Как Get, но в result_cache ничего не записывается, пока для функции не вызван Commit с тем же
+    // `fingerprint`: так файл, который бюджет отверг на полпути, не оставляет в кэше ни результатов, ни мест.
+    MetricResults GetUncommitted(const function::Function &func, Fingerprint &fingerprint) const;
+    void Commit(Fingerprint fingerprint, const function::Function &func, const MetricResults &results) const;
     std::vector<std::unique_ptr<IMetric>> metrics;
+    // Если кэш задан, метрики считаются один раз для всех функций с одинаковым отпечатком.
+    ResultCache *result_cache = nullptr;
 };
 
 }  // namespace analyzer::metric
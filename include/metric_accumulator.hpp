@@ -11,9 +11,14 @@
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <ranges>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -26,31 +31,123 @@ namespace analyzer::metric_accumulator {
 
 struct IAccumulator {
     virtual void Accumulate(const metric::MetricResult &metric_result) = 0;
+    // Аккумуляторам, которым важно, к какой функции относится значение, передаётся и сама функция.
+    virtual void Accumulate(const function::Function &, const metric::MetricResult &metric_result) {
+        Accumulate(metric_result);
+    }
     virtual void Finalize() = 0;
     virtual void Reset() = 0;
+    // Пустой аккумулятор с теми же настройками (границами корзин, K и т. п.): слот для отдельного потока.
+    virtual std::unique_ptr<IAccumulator> CloneEmpty() const = 0;
+    // Добавляет состояние аккумулятора того же типа, накопленное независимо.
+    virtual void MergeFrom(const IAccumulator &other) = 0;
     virtual ~IAccumulator() = default;
 
 protected:
     bool is_finalized = false;
 };
 
+// Реализует CloneEmpty и MergeFrom через копирование и метод Derived::Merge(const Derived &).
+template <typename Derived>
+struct MergeableAccumulator : public IAccumulator {
+    std::unique_ptr<IAccumulator> CloneEmpty() const override {
+        auto clone = std::make_unique<Derived>(static_cast<const Derived &>(*this));
+        clone->Reset();
+        return clone;
+    }
+    void MergeFrom(const IAccumulator &other) override {
+        static_cast<Derived &>(*this).Merge(dynamic_cast<const Derived &>(other));
+    }
+};
+
+/**
+ * @brief Раздаёт результаты метрик зарегистрированным аккумуляторам.
+ *
+ * По умолчанию AccumulateNextFunctionResults нельзя вызывать из нескольких потоков. После EnableSharding
+ * у каждого из слотов появляются свои пустые копии аккумуляторов, и поток пишет в слот, выбранный по его
+ * идентификатору. Мьютекс у каждого слота свой, поэтому при числе слотов не меньше числа потоков
+ * они почти не конкурируют. Слоты сливаются в основные аккумуляторы в GetFinalizedAccumulator;
+ * на время слияния накопление должно быть остановлено.
+ */
 struct MetricsAccumulator {
+    // Для одной метрики можно зарегистрировать несколько аккумуляторов разных типов.
     template <typename Accumulator>
     void RegisterAccumulator(const std::string &metric_name, std::unique_ptr<Accumulator> acc) {
-        accumulators.emplace(metric_name, std::move(acc));
+        std::shared_ptr<IAccumulator> target = std::move(acc);
+        for (auto &shard : shards) {
+            shard->slots.emplace(metric_name, ShardSlot{.accumulator = target->CloneEmpty(), .target = target.get()});
+        }
+        accumulators.emplace(metric_name, std::move(target));
     }
     template <typename Accumulator>
     const Accumulator &GetFinalizedAccumulator(const std::string &metric_name) const {
-        auto metric_accululator = accumulators.at(metric_name);
-        metric_accululator->Finalize();
-        return dynamic_cast<const Accumulator&>(*metric_accululator);
+        MergeShards();
+        auto [first, last] = accumulators.equal_range(metric_name);
+        for (auto it = first; it != last; ++it) {
+            if (auto metric_accumulator = std::dynamic_pointer_cast<Accumulator>(it->second)) {
+                metric_accumulator->Finalize();
+                return *metric_accumulator;
+            }
+        }
+        throw std::out_of_range("No accumulator of requested type for metric " + metric_name);
     }
-    void AccumulateNextFunctionResults(const std::vector<metric::MetricResult> &metric_results) const;
+    void AccumulateNextFunctionResults(const metric::MetricResults &metric_results) const;
+    void AccumulateNextFunctionResults(const function::Function &function,
+                                       const metric::MetricResults &metric_results) const;
+
+    // Включает потокобезопасное накопление в `shards_count` слотов (0 — выключает, слив накопленное).
+    void EnableSharding(size_t shards_count);
+    bool IsSharded() const { return !shards.empty(); }
 
     void ResetAccumulators();
 
 private:
-    std::unordered_map<std::string, std::shared_ptr<IAccumulator>> accumulators;
+    // Прозрачный хеш позволяет искать аккумуляторы по названию метрики из результата без создания std::string.
+    struct MetricNameHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view metric_name) const { return std::hash<std::string_view>{}(metric_name); }
+    };
+
+    template <typename Value>
+    using ByMetricName = std::unordered_multimap<std::string, Value, MetricNameHash, std::equal_to<>>;
+
+    struct ShardSlot {
+        std::unique_ptr<IAccumulator> accumulator;
+        IAccumulator *target;  // Основной аккумулятор, в который сливается слот.
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        ByMetricName<ShardSlot> slots;
+    };
+
+    // Передаёт каждый результат всем аккумуляторам его метрики: основным или слотам текущего потока.
+    template <typename Callback>
+    void Dispatch(const metric::MetricResults &metric_results, Callback &&callback) const {
+        if (shards.empty()) {
+            for (const auto &metric_result : metric_results) {
+                auto [first, last] = accumulators.equal_range(std::string_view(metric_result.metric_name));
+                for (auto it = first; it != last; ++it) {
+                    callback(*it->second, metric_result);
+                }
+            }
+            return;
+        }
+
+        Shard &shard = *shards[std::hash<std::thread::id>{}(std::this_thread::get_id()) % shards.size()];
+        std::lock_guard lock(shard.mutex);
+        for (const auto &metric_result : metric_results) {
+            auto [first, last] = shard.slots.equal_range(std::string_view(metric_result.metric_name));
+            for (auto it = first; it != last; ++it) {
+                callback(*it->second.accumulator, metric_result);
+            }
+        }
+    }
+
+    void MergeShards() const;
+
+    ByMetricName<std::shared_ptr<IAccumulator>> accumulators;
+    std::vector<std::unique_ptr<Shard>> shards;
 };
 
 }  // namespace analyzer::metric_accumulator
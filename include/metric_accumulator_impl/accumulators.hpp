@@ -3,4 +3,7 @@
 #include "../metric_accumulator.hpp"
 #include "average_accumulator.hpp"
 #include "categorical_accumulator.hpp"
+#include "histogram_accumulator.hpp"
+#include "quantile_accumulator.hpp"
 #include "sum_average_accumulator.hpp"
+#include "top_k_accumulator.hpp"
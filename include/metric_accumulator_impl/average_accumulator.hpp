@@ -20,17 +20,19 @@
 
 namespace analyzer::metric_accumulator::metric_accumulator_impl {
 
-struct AverageAccumulator : public IAccumulator {
+struct AverageAccumulator : public MergeableAccumulator<AverageAccumulator> {
     void Accumulate(const metric::MetricResult &metric_result) override;
 
     void Finalize() override;
 
-    void Reset();
+    void Reset() override;
+
+    void Merge(const AverageAccumulator &other);
 
     double Get() const;
 
 private:
-    int sum = 0;
+    double sum = 0;
     int count = 0;
     double average = 0;
 };
@@ -20,16 +20,20 @@
 
 namespace analyzer::metric_accumulator::metric_accumulator_impl {
 
-struct CategoricalAccumulator : public IAccumulator {
+struct CategoricalAccumulator : public MergeableAccumulator<CategoricalAccumulator> {
     void Accumulate(const metric::MetricResult &metric_result) override;
 
     virtual void Finalize() override;
 
     virtual void Reset() override;
 
+    void Merge(const CategoricalAccumulator &other);
+
     const std::unordered_map<std::string, int> &Get() const;
 
 private:
+    // Во время накопления считаются номера категорий, строки появляются только в Finalize.
+    std::unordered_map<metric::CategoryId, int> ids_freq;
     std::unordered_map<std::string, int> categories_freq;
 };
 
@@ -0,0 +1,54 @@
+#pragma once
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "metric_accumulator.hpp"
+
+namespace analyzer::metric_accumulator::metric_accumulator_impl {
+
+/**
+ * @brief Гистограмма значений метрики с фиксированными границами корзин.
+ *
+ * Границы задаются при создании по возрастанию: значение попадает в первую корзину,
+ * верхняя граница которой не меньше значения. Всё, что больше последней границы,
+ * попадает в дополнительную корзину с границей std::numeric_limits<int>::max().
+ */
+struct HistogramAccumulator : public MergeableAccumulator<HistogramAccumulator> {
+    struct Bucket {
+        int upper_bound;
+        int count;
+        auto operator<=>(const Bucket &) const = default;
+    };
+
+    explicit HistogramAccumulator(std::vector<int> upper_bounds);
+
+    void Accumulate(const metric::MetricResult &metric_result) override;
+
+    virtual void Finalize() override;
+
+    virtual void Reset() override;
+
+    // Складывает счётчики корзин; границы гистограмм должны совпадать.
+    void Merge(const HistogramAccumulator &other);
+
+    const std::vector<Bucket> &Get() const;
+
+private:
+    std::vector<Bucket> buckets;
+};
+
+}  // namespace analyzer::metric_accumulator::metric_accumulator_impl
@@ -0,0 +1,75 @@
+#pragma once
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "metric_accumulator.hpp"
+
+namespace analyzer::metric_accumulator::metric_accumulator_impl {
+
+/**
+ * @brief Потоковая оценка квантилей распределения метрики (KLL-скетч).
+ *
+ * Значения складываются в уровни-компакторы: элемент уровня h "весит" 2^h исходных значений.
+ * Когда суммарный размер уровней превышает ёмкость, самый нижний переполненный уровень сортируется,
+ * и каждый второй его элемент переносится на уровень выше. Память — O(k * log(n / k)),
+ * амортизированная стоимость Accumulate не зависит от числа уже накопленных значений.
+ * Пока значений меньше k, квантили считаются точно. Максимум отслеживается всегда точно.
+ */
+struct QuantileAccumulator : public MergeableAccumulator<QuantileAccumulator> {
+    static constexpr size_t kDefaultCapacity = 200;
+
+    struct Quantiles {
+        int p50;
+        int p90;
+        int p99;
+        int max;
+        auto operator<=>(const Quantiles &) const = default;
+    };
+
+    explicit QuantileAccumulator(size_t capacity = kDefaultCapacity);
+
+    void Accumulate(const metric::MetricResult &metric_result) override;
+
+    virtual void Finalize() override;
+
+    virtual void Reset() override;
+
+    // Объединяет скетч с другим (например, посчитанным в другом потоке).
+    void Merge(const QuantileAccumulator &other);
+
+    // Оценка значения с рангом q * count, q в диапазоне [0, 1].
+    int Quantile(double q) const;
+
+    Quantiles Get() const;
+
+private:
+    void Insert(int value);
+    void Compress();
+    size_t LevelCapacity(size_t level) const;
+    size_t TotalCapacity() const;
+
+    size_t capacity;
+    std::vector<std::vector<int>> levels;
+    size_t total_capacity = 0;
+    size_t retained = 0;
+    size_t count = 0;
+    int max = 0;
+    bool compaction_offset = false;
+    Quantiles quantiles{};
+};
+
+}  // namespace analyzer::metric_accumulator::metric_accumulator_impl
@@ -20,7 +20,7 @@
 
 namespace analyzer::metric_accumulator::metric_accumulator_impl {
 
-struct SumAverageAccumulator : public IAccumulator {
+struct SumAverageAccumulator : public MergeableAccumulator<SumAverageAccumulator> {
     struct SumAverage {
         int sum;
         double average;
@@ -32,6 +32,8 @@ struct SumAverageAccumulator : public IAccumulator {
 
     virtual void Reset() override;
 
+    void Merge(const SumAverageAccumulator &other);
+
     SumAverage Get() const;
 
 private:
@@ -0,0 +1,63 @@
+#pragma once
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "metric_accumulator.hpp"
+
+namespace analyzer::metric_accumulator::metric_accumulator_impl {
+
+/**
+ * @brief Запоминает K функций с наибольшими значениями метрики.
+ *
+ * Хранит min-кучу из не более чем K элементов, поэтому память — O(K) независимо от размера репозитория.
+ * Строки с именем функции копируются только для значений, которые попадают в кучу.
+ * Частичные результаты, посчитанные независимо, объединяются через Merge().
+ */
+struct TopKAccumulator : public MergeableAccumulator<TopKAccumulator> {
+    struct Entry {
+        std::string filename;
+        std::optional<std::string> class_name;
+        std::string function_name;
+        int value;
+        auto operator<=>(const Entry &) const = default;
+    };
+
+    explicit TopKAccumulator(size_t k);
+
+    void Accumulate(const metric::MetricResult &metric_result) override;
+
+    void Accumulate(const function::Function &function, const metric::MetricResult &metric_result) override;
+
+    virtual void Finalize() override;
+
+    virtual void Reset() override;
+
+    void Merge(const TopKAccumulator &other);
+
+    // Функции в порядке убывания значения метрики.
+    const std::vector<Entry> &Get() const;
+
+private:
+    bool Admits(int value) const;
+    void Push(Entry entry);
+
+    size_t k;
+    std::vector<Entry> heap;
+    std::vector<Entry> top;
+};
+
+}  // namespace analyzer::metric_accumulator::metric_accumulator_impl
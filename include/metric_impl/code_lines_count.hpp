@@ -24,7 +24,7 @@ struct CodeLinesCountMetric final : IMetric {
     static inline const std::string kName = "Code lines count";
 
 protected:
-    std::string Name() const override;
+    std::string_view Name() const override;
 
     MetricResult::ValueType CalculateImpl(const function::Function& f) const override;};
 
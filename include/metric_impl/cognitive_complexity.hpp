@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "metric.hpp"
+
+namespace analyzer::metric::metric_impl {
+
+// Когнитивная сложность: ветвления и циклы, взвешенные глубиной вложенности (см. control_flow.hpp).
+struct CognitiveComplexityMetric : IMetric {
+    static inline const std::string kName = "Cognitive Complexity";
+
+protected:
+    std::string_view Name() const override;
+
+    MetricResult::ValueType CalculateImpl(const function::Function& f) const override;
+};
+
+}  // namespace analyzer::metric::metric_impl
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string_view>
+
+#include "function.hpp"
+#include "language.hpp"
+
+namespace analyzer::metric::metric_impl {
+
+/**
+ * @brief Один проход по AST функции с отслеживанием вложенности ветвлений и циклов.
+ *
+ * Ветвлениями и циклами считаются узлы категорий Branch и Loop языка функции. За тот же проход
+ * считаются:
+ * - число таких узлов (из него получается цикломатическая сложность);
+ * - когнитивная сложность: каждое ветвление или цикл добавляет 1 плюс текущую глубину вложенности.
+ *   Продолжения условия (узлы в поле "alternative:", т. е. elif/else/else if) добавляют ровно 1
+ *   и глубину не увеличивают, как и if, записанный первым потомком else-ветки. Вложенная функция
+ *   (lambda, def внутри def) увеличивает глубину для своего тела, но сама не штрафуется;
+ * - наибольшая глубина вложенности ветвлений и циклов.
+ */
+function::ControlFlowSummary SummarizeControlFlow(std::string_view ast, const language::Language &language);
+
+// Сводка функции: при первом обращении считается и запоминается в f.control_flow.
+const function::ControlFlowSummary &GetControlFlow(const function::Function &f);
+
+}  // namespace analyzer::metric::metric_impl
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "call_graph.hpp"
+#include "function.hpp"
+#include "metric.hpp"
+
+namespace analyzer::metric::metric_impl {
+
+/**
+ * @brief Число различных проанализированных функций, которые вызывают данную (Fan In) и которые
+ * вызываются из неё (Fan Out).
+ *
+ * В отличие от остальных метрик зависят от всего набора функций, поэтому считаются по готовому графу
+ * вызовов и не кэшируются по отпечатку функции. Функция, которой нет в графе, получает 0.
+ */
+struct FanInMetric : IMetric {
+    static inline const std::string kName = "Fan In";
+
+    explicit FanInMetric(const call_graph::CallGraph &graph) : graph{graph} {}
+
+protected:
+    std::string_view Name() const override;
+
+    MetricResult::ValueType CalculateImpl(const function::Function& f) const override;
+
+private:
+    const call_graph::CallGraph &graph;
+};
+
+struct FanOutMetric : IMetric {
+    static inline const std::string kName = "Fan Out";
+
+    explicit FanOutMetric(const call_graph::CallGraph &graph) : graph{graph} {}
+
+protected:
+    std::string_view Name() const override;
+
+    MetricResult::ValueType CalculateImpl(const function::Function& f) const override;
+
+private:
+    const call_graph::CallGraph &graph;
+};
+
+}  // namespace analyzer::metric::metric_impl
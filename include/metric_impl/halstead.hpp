@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "function.hpp"
+#include "metric.hpp"
+
+namespace analyzer::metric::metric_impl {
+
+/**
+ * @brief Метрики Холстеда по операторам и операндам функции (см. tokens.hpp).
+ *
+ * Из n1, n2 различных и N1, N2 всех операторов и операндов:
+ * объём V = (N1 + N2) * log2(n1 + n2), сложность D = n1 / 2 * N2 / n2, трудоёмкость E = D * V.
+ * Значения вещественные и округляются до сотых.
+ */
+double HalsteadVolume(const function::TokenSummary &tokens);
+double HalsteadDifficulty(const function::TokenSummary &tokens);
+
+struct HalsteadVolumeMetric : IMetric {
+    static inline const std::string kName = "Halstead Volume";
+
+protected:
+    std::string_view Name() const override;
+
+    MetricResult::ValueType CalculateImpl(const function::Function& f) const override;
+};
+
+struct HalsteadDifficultyMetric : IMetric {
+    static inline const std::string kName = "Halstead Difficulty";
+
+protected:
+    std::string_view Name() const override;
+
+    MetricResult::ValueType CalculateImpl(const function::Function& f) const override;
+};
+
+struct HalsteadEffortMetric : IMetric {
+    static inline const std::string kName = "Halstead Effort";
+
+protected:
+    std::string_view Name() const override;
+
+    MetricResult::ValueType CalculateImpl(const function::Function& f) const override;
+};
+
+}  // namespace analyzer::metric::metric_impl
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "metric.hpp"
+
+namespace analyzer::metric::metric_impl {
+
+/**
+ * @brief Индекс сопровождаемости в шкале 0..100 (как в Visual Studio):
+ * max(0, (171 - 5.2 ln V - 0.23 CC - 16.2 ln LOC) * 100 / 171).
+ *
+ * V — объём Холстеда, CC — цикломатическая сложность, LOC — число строк функции вместе с объявлением.
+ * Строки берутся из диапазона функции, а не из метрики строк кода, чтобы не проходить AST ещё раз.
+ */
+struct MaintainabilityIndexMetric : IMetric {
+    static inline const std::string kName = "Maintainability Index";
+
+protected:
+    std::string_view Name() const override;
+
+    MetricResult::ValueType CalculateImpl(const function::Function& f) const override;
+};
+
+}  // namespace analyzer::metric::metric_impl
@@ -2,6 +2,11 @@
 
 #include "../metric.hpp"
 #include "code_lines_count.hpp"
+#include "cognitive_complexity.hpp"
 #include "cyclomatic_complexity.hpp"
+#include "fan_in_out.hpp"
+#include "halstead.hpp"
+#include "maintainability_index.hpp"
 #include "naming_style.hpp"
+#include "nesting_depth.hpp"
 #include "parameters_count.hpp"
@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -13,6 +14,7 @@
 #include <ranges>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -20,13 +22,119 @@
 
 namespace analyzer::metric::metric_impl {
 
+namespace naming {
+
+enum class CharClass : std::uint8_t { Other, Lower, Upper, Digit, Underscore, Hyphen };
+
+// Классы всех 256 байтов; не зависит от локали, в отличие от isupper/islower.
+inline constexpr std::array<CharClass, 256> kCharClasses = [] {
+    std::array<CharClass, 256> classes{};
+    for (int c = 'a'; c <= 'z'; ++c)
+        classes[c] = CharClass::Lower;
+    for (int c = 'A'; c <= 'Z'; ++c)
+        classes[c] = CharClass::Upper;
+    for (int c = '0'; c <= '9'; ++c)
+        classes[c] = CharClass::Digit;
+    classes['_'] = CharClass::Underscore;
+    classes['-'] = CharClass::Hyphen;
+    return classes;
+}();
+
+enum class Style : std::uint8_t {
+    Unknown,
+    LowerCase,
+    SnakeCase,
+    ScreamingSnakeCase,
+    CamelCase,
+    PascalCase,
+    KebabCase,
+    Dunder,
+    kCount
+};
+
+inline constexpr std::array<std::string_view, static_cast<size_t>(Style::kCount)> kStyleNames = {
+    "Unknown", "Lower Case", "Snake Case", "Screaming Snake Case", "Camel Case", "Pascal Case", "Kebab Case", "Dunder"};
+
+inline constexpr std::array<std::string_view, static_cast<size_t>(Style::kCount)> kPrivateStyleNames = {
+    "Unknown",           "Private Lower Case", "Private Snake Case", "Private Screaming Snake Case",
+    "Private Camel Case", "Private Pascal Case", "Private Kebab Case", "Dunder"};
+
+struct Classification {
+    Style style;
+    bool is_private;  // Имя начинается с '_' (кроме dunder-имён вроде __init__).
+};
+
+/**
+ * @brief Определяет стиль имени за один проход по символам.
+ *
+ * Автомат из двух состояний: ведущие подчёркивания и тело имени. В теле копируются только битовые
+ * признаки встреченных классов символов, счётчик подчёркиваний и длина хвоста из подчёркиваний,
+ * по которым стиль выбирается уже без обращения к строке. Хвостовое '_' (`class_`) стиль не меняет.
+ */
+constexpr Classification Classify(std::string_view name) {
+    auto bit = [](CharClass cls) { return 1u << static_cast<unsigned>(cls); };
+
+    size_t leading = 0;
+    size_t trailing = 0;
+    size_t underscores = 0;
+    unsigned seen = 0;
+    CharClass first = CharClass::Other;
+    bool in_body = false;
+    for (char c : name) {
+        const CharClass cls = kCharClasses[static_cast<unsigned char>(c)];
+        if (!in_body) {
+            if (cls == CharClass::Underscore) {
+                leading++;
+                continue;
+            }
+            in_body = true;
+            first = cls;
+        }
+        seen |= bit(cls);
+        if (cls == CharClass::Underscore) {
+            underscores++;
+            trailing++;
+        } else {
+            trailing = 0;
+        }
+    }
+
+    if (!in_body || (seen & bit(CharClass::Other)) || first == CharClass::Digit || first == CharClass::Hyphen)
+        return {Style::Unknown, false};
+    if (leading >= 2 && trailing >= 2)
+        return {Style::Dunder, false};
+
+    const bool is_private = leading > 0;
+    const bool has_lower = seen & bit(CharClass::Lower);
+    const bool has_upper = seen & bit(CharClass::Upper);
+    const bool has_separator = underscores > trailing;
+    if (seen & bit(CharClass::Hyphen)) {
+        const bool kebab = !has_upper && underscores == 0 && name.back() != '-';
+        return {kebab ? Style::KebabCase : Style::Unknown, is_private};
+    }
+    if (has_upper && !has_lower)
+        return {Style::ScreamingSnakeCase, is_private};
+    if (has_separator)
+        return {has_upper ? Style::Unknown : Style::SnakeCase, is_private};
+    if (has_upper)
+        return {first == CharClass::Upper ? Style::PascalCase : Style::CamelCase, is_private};
+    return {Style::LowerCase, is_private};
+}
+
+constexpr std::string_view ToString(Classification classification) {
+    const auto index = static_cast<size_t>(classification.style);
+    return classification.is_private ? kPrivateStyleNames[index] : kStyleNames[index];
+}
+
+}  // namespace naming
+
 struct NamingStyleMetric : IMetric {
     static inline const std::string kName = "Naming style";
 
 protected:
-    std::string Name() const override;
+    std::string_view Name() const override;
 
     MetricResult::ValueType CalculateImpl(const function::Function& f) const override;
-};};
+};
 
 }  // namespace analyzer::metric::metric_impl
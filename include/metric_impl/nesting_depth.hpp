@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "metric.hpp"
+
+namespace analyzer::metric::metric_impl {
+
+// Наибольшая глубина вложенности ветвлений и циклов; 0 для функции без них.
+struct MaxNestingDepthMetric : IMetric {
+    static inline const std::string kName = "Max Nesting Depth";
+
+protected:
+    std::string_view Name() const override;
+
+    MetricResult::ValueType CalculateImpl(const function::Function& f) const override;
+};
+
+}  // namespace analyzer::metric::metric_impl
@@ -20,7 +20,7 @@ struct CountParametersMetric final : public IMetric {
     static inline const std::string kName = "Parameters count";
 
 protected:
-    std::string Name() const override;
+    std::string_view Name() const override;
 
     MetricResult::ValueType CalculateImpl(const function::Function& f) const override;};
 
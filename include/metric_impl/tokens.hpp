@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "function.hpp"
+#include "language.hpp"
+
+namespace analyzer::metric::metric_impl {
+
+// Роль лексемы: операнды Холстеда делятся на идентификаторы и литералы, которые поиск клонов обобщает по-разному.
+enum class TokenKind {
+    Operator,    // Ключевое слово, знак операции или препинания.
+    Identifier,
+    Literal,     // Число или строка.
+};
+
+struct Token {
+    std::string_view text;  // Подстрока исходного текста.
+    TokenKind kind;
+};
+
+/**
+ * @brief Один проход по исходному тексту функции, перечисляющий все её лексемы для метрик Холстеда.
+ *
+ * tree-sitter выводит только именованные узлы, а ключевые слова, знаки операций и скобки в S-выражение
+ * не попадают, поэтому лексемы читаются прямо из `source` (Function::source), который к тому же
+ * в десятки раз короче AST. Лексика берётся из language.lexicon:
+ * - идентификаторы, числа и строковые литералы (целиком, с префиксами вроде f"...") — операнды;
+ * - ключевые слова языка, знаки операций и знаки препинания — операторы;
+ * - комментарии и пробельные символы пропускаются.
+ *
+ * Множества различных лексем — открытые хэш-таблицы на поток, которые очищаются за O(1)
+ * и на следующих функциях память не выделяют.
+ */
+function::TokenSummary SummarizeTokens(std::string_view source, const language::Language &language);
+
+// Лексемы `source` по порядку, разобранные так же, как в SummarizeTokens. Буфер `tokens` очищается
+// и переиспользуется вызывающим.
+void Tokenize(std::string_view source, const language::Language &language, std::vector<Token> &tokens);
+
+// Сводка функции: при первом обращении считается и запоминается в f.tokens. У функции без исходного
+// текста (собранной вручную из AST) сводка пустая.
+const function::TokenSummary &GetTokens(const function::Function &f);
+
+}  // namespace analyzer::metric::metric_impl
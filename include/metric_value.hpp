@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+namespace analyzer::metric {
+
+// Номер строки в глобальном словаре категорий.
+using CategoryId = std::uint32_t;
+
+/**
+ * @brief Словарь значений категориальных метрик (стилей именования и т. п.).
+ *
+ * Каждая строка хранится один раз на весь процесс, а результаты метрик держат только её номер,
+ * поэтому категориальное значение копируется без выделения памяти. Потокобезопасен; строки
+ * не удаляются, и string_view из Name() действителен до конца работы программы.
+ */
+class CategoryRegistry {
+public:
+    static CategoryId Intern(std::string_view name);
+    static std::string_view Name(CategoryId id);
+};
+
+/**
+ * @brief Значение метрики: 16 байт без выделений памяти.
+ *
+ * Хранит одно из: целое (int64), вещественное (double), номер категории из CategoryRegistry или
+ * до kMaxInlineItems целых int32 (например, небольшое распределение). Полезная нагрузка лежит в трёх
+ * 32-битных словах, за ними — тег вида и длина массива.
+ */
+class MetricValue {
+public:
+    enum class Kind : std::uint8_t { Integer, Real, Category, Distribution };
+
+    static constexpr size_t kMaxInlineItems = 3;
+
+    constexpr MetricValue() : MetricValue(std::int64_t{0}) {}
+
+    template <std::integral T>
+    constexpr MetricValue(T value) : kind{Kind::Integer} {
+        StoreWide(std::bit_cast<std::uint64_t>(static_cast<std::int64_t>(value)));
+    }
+
+    constexpr MetricValue(double value) : kind{Kind::Real} { StoreWide(std::bit_cast<std::uint64_t>(value)); }
+
+    static constexpr MetricValue FromCategory(CategoryId id) {
+        MetricValue value;
+        value.kind = Kind::Category;
+        value.words = {id, 0, 0};
+        return value;
+    }
+
+    static MetricValue FromCategory(std::string_view name) { return FromCategory(CategoryRegistry::Intern(name)); }
+
+    // Больше kMaxInlineItems элементов не помещается: это ошибка вызывающей стороны.
+    static constexpr MetricValue FromItems(std::span<const std::int32_t> items) {
+        if (items.size() > kMaxInlineItems)
+            throw std::length_error("MetricValue holds at most 3 inline items");
+        MetricValue value;
+        value.kind = Kind::Distribution;
+        value.size = static_cast<std::uint8_t>(items.size());
+        value.words = {};
+        for (size_t i = 0; i < items.size(); ++i)
+            value.words[i] = std::bit_cast<std::uint32_t>(items[i]);
+        return value;
+    }
+
+    constexpr Kind GetKind() const { return kind; }
+
+    constexpr std::int64_t AsInteger() const {
+        Expect(Kind::Integer);
+        return std::bit_cast<std::int64_t>(LoadWide());
+    }
+
+    constexpr double AsReal() const {
+        Expect(Kind::Real);
+        return std::bit_cast<double>(LoadWide());
+    }
+
+    constexpr CategoryId AsCategory() const {
+        Expect(Kind::Category);
+        return words[0];
+    }
+
+    std::string_view CategoryName() const { return CategoryRegistry::Name(AsCategory()); }
+
+    constexpr std::array<std::int32_t, kMaxInlineItems> Items() const {
+        Expect(Kind::Distribution);
+        std::array<std::int32_t, kMaxInlineItems> items{};
+        for (size_t i = 0; i < size; ++i)
+            items[i] = std::bit_cast<std::int32_t>(words[i]);
+        return items;
+    }
+
+    constexpr size_t ItemsCount() const { return kind == Kind::Distribution ? size : 0; }
+
+    // Вызывает visitor с int64_t, double, std::string_view (имя категории) или std::span<const int32_t>.
+    template <typename Visitor>
+    decltype(auto) Visit(Visitor &&visitor) const {
+        switch (kind) {
+        case Kind::Real:
+            return visitor(AsReal());
+        case Kind::Category:
+            return visitor(CategoryName());
+        case Kind::Distribution: {
+            const auto items = Items();
+            return visitor(std::span<const std::int32_t>(items.data(), size));
+        }
+        case Kind::Integer:
+            break;
+        }
+        return visitor(AsInteger());
+    }
+
+    constexpr bool operator==(const MetricValue &other) const {
+        return kind == other.kind && size == other.size && words == other.words;
+    }
+
+private:
+    constexpr void StoreWide(std::uint64_t bits) {
+        words = {static_cast<std::uint32_t>(bits), static_cast<std::uint32_t>(bits >> 32), 0};
+    }
+
+    constexpr std::uint64_t LoadWide() const { return (std::uint64_t{words[1]} << 32) | words[0]; }
+
+    constexpr void Expect(Kind expected) const {
+        if (kind != expected)
+            throw std::bad_variant_access();
+    }
+
+    std::array<std::uint32_t, kMaxInlineItems> words{};
+    Kind kind = Kind::Integer;
+    std::uint8_t size = 0;  // Число элементов для Kind::Distribution.
+};
+
+static_assert(sizeof(MetricValue) == 16);
+
+}  // namespace analyzer::metric
+
+// Печатает значение так же, как его вариант: число, имя категории или "[a, b, c]".
+template <>
+struct std::formatter<analyzer::metric::MetricValue> : std::formatter<std::string_view> {
+    auto format(const analyzer::metric::MetricValue &value, std::format_context &ctx) const {
+        return value.Visit([&ctx, this](const auto &payload) {
+            using Payload = std::decay_t<decltype(payload)>;
+            if constexpr (std::is_same_v<Payload, std::span<const std::int32_t>>) {
+                std::string text = "[";
+                for (size_t i = 0; i < payload.size(); ++i)
+                    text += (i == 0 ? "" : ", ") + std::to_string(payload[i]);
+                text += "]";
+                return std::formatter<std::string_view>::format(text, ctx);
+            } else if constexpr (std::is_same_v<Payload, std::string_view>) {
+                return std::formatter<std::string_view>::format(payload, ctx);
+            } else {
+                return std::formatter<std::string_view>::format(std::format("{}", payload), ctx);
+            }
+        });
+    }
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace analyzer::file {
+
+// Размер одного чтения из канала: столько же, сколько вмещает буфер канала в Linux.
+inline constexpr size_t kPipeChunkSize = 64 * 1024;
+
+// Закрывает канал popen и дожидается команды, в том числе когда чтение прервано исключением.
+struct PipeCloser {
+    void operator()(FILE *pipe) const { pclose(pipe); }
+};
+
+/**
+ * @brief Запускает команду и дописывает её stdout в конец `out`.
+ *
+ * Вывод читается вызовами read(2) крупными блоками сразу в память строки (resize_and_overwrite),
+ * без промежуточного буфера, поиска конца строки и лишней инициализации. Ёмкость строки растёт
+ * геометрически, поэтому число перевыделений — O(log размера вывода). Возвращает статус из pclose.
+ *
+ * Каждый прочитанный блок сразу передаётся в on_chunk(std::string_view), так что разбор вывода
+ * идёт параллельно с работой команды.
+ */
+template <typename String, typename OnChunk>
+int RunCommand(const std::string &command, String &out, OnChunk &&on_chunk) {
+    std::unique_ptr<FILE, PipeCloser> pipe(popen(command.c_str(), "r"));
+    if (!pipe) {
+        throw std::runtime_error("Failed to execute command: " + std::string(std::strerror(errno)));
+    }
+
+    const int fd = fileno(pipe.get());
+    ssize_t read_bytes = 0;
+    do {
+        const size_t size = out.size();
+        out.resize_and_overwrite(size + kPipeChunkSize, [&](char *data, size_t) {
+            do {
+                read_bytes = read(fd, data + size, kPipeChunkSize);
+            } while (read_bytes == -1 && errno == EINTR);
+            return size + static_cast<size_t>(std::max<ssize_t>(read_bytes, 0));
+        });
+        if (read_bytes > 0) {
+            on_chunk(std::string_view(out).substr(size));
+        }
+    } while (read_bytes > 0);
+
+    return pclose(pipe.release());
+}
+
+template <typename String>
+int RunCommand(const std::string &command, String &out) {
+    return RunCommand(command, out, [](std::string_view) {});
+}
+
+// Описание ненулевого статуса команды или пустая строка, если команда завершилась успешно.
+inline std::string DescribeCommandFailure(int status) {
+    if (status == -1 || !WIFEXITED(status))
+        return "Command terminated abnormally";
+    if (WEXITSTATUS(status) != 0)
+        return "Command failed with exit code " + std::to_string(WEXITSTATUS(status));
+    return {};
+}
+
+}  // namespace analyzer::file
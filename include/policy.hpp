@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "metric.hpp"
+
+namespace analyzer::policy {
+
+// Предел метрики для файлов, путь которых подходит под glob.
+struct Rule {
+    std::string glob;
+    std::string metric;
+    double threshold;
+    size_t line;  // Строка файла политики, начиная с 1.
+};
+
+// Значение метрики функции, превысившее предел.
+struct Violation {
+    const Rule *rule;  // Указывает в Policy, которая проверяла функцию.
+    double value;
+};
+
+/**
+ * @brief Пределы метрик для проверки в CI.
+ *
+ * Файл политики — строки "Название метрики = предел" и заголовки секций "[glob]"; пустые строки
+ * и строки, начинающиеся с '#', пропускаются:
+ *
+ *     Cyclomatic Complexity = 15
+ *     Parameters count = 6
+ *
+ *     [*_test.py]
+ *     Cyclomatic Complexity = 25
+ *
+ * Правила до первой секции относятся ко всем файлам. Glob сопоставляется с путём файла в том виде,
+ * в каком он передан анализатору, по правилам fnmatch(3): `*` совпадает и с '/', так что секция выше
+ * относится к тестам в любом каталоге. Если функции подходят несколько правил одной метрики, действует
+ * записанное последним, поэтому частные секции пишутся после общих. Нарушение — числовое значение
+ * метрики строго больше предела.
+ */
+class Policy {
+public:
+    // Бросает std::invalid_argument с номером строки, если строка не разбирается.
+    static Policy Parse(std::istream &in);
+    static Policy Load(const std::string &path);
+
+    // Бросает std::invalid_argument с номером строки первого правила, метрика которого не `is_known`:
+    // опечатка в названии метрики иначе молча отключила бы правило.
+    void RequireKnownMetrics(const std::function<bool(std::string_view)> &is_known) const;
+
+    // Нарушения среди результатов метрик одной функции из файла `filename`.
+    std::vector<Violation> Check(std::string_view filename, const metric::MetricResults &results) const;
+
+    // Есть ли правила для метрики: метрики без правил при проверке можно не считать.
+    bool UsesMetric(std::string_view metric) const { return rules_by_metric.contains(metric); }
+
+    const std::vector<Rule> &Rules() const { return rules; }
+
+private:
+    struct MetricHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view metric) const { return std::hash<std::string_view>{}(metric); }
+    };
+
+    std::vector<Rule> rules;
+    // Номера правил каждой метрики в порядке записи.
+    std::unordered_map<std::string, std::vector<size_t>, MetricHash, std::equal_to<>> rules_by_metric;
+};
+
+}  // namespace analyzer::policy
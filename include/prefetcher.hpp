@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "batch_parser.hpp"
+#include "bounded_queue.hpp"
+
+namespace analyzer::file {
+
+// Файл, прочитанный и разобранный заранее.
+struct PrefetchedFile {
+    std::string filename;
+    std::optional<std::string> source;    // std::nullopt, если файл не удалось открыть.
+    std::optional<std::string_view> ast;  // std::nullopt, если пакетный разбор не удался.
+    std::shared_ptr<const BatchParser::ParsedAsts> parsed;  // Владеет буфером, на который указывает ast.
+    std::chrono::steady_clock::duration parse_time{};       // Доля файла во времени разбора пакета, без очереди.
+};
+
+/**
+ * @brief Стадия упреждающего чтения: пока анализируются одни файлы, следующие уже читаются и разбираются.
+ *
+ * Фоновый поток запускает до `jobs` процессов tree-sitter на пакеты по `batch_size` файлов (меньше, если
+ * файлов не хватает на два пакета на процесс) и, пока они работают, читает исходники первого пакета. Файлы
+ * разобранного пакета сразу складываются в очередь глубиной `depth` файлов, а на его место запускается
+ * следующий пакет. Так ожидание диска и процессов tree-sitter перекрывается с подсчётом метрик, а память
+ * ограничена глубиной очереди и `jobs` пакетами AST.
+ * Файлы выдаются в исходном порядке. Ошибка фонового потока пробрасывается из Next().
+ */
+class Prefetcher {
+public:
+    Prefetcher(std::vector<std::string> filenames, const BatchParser &parser, size_t depth);
+    ~Prefetcher();
+    Prefetcher(const Prefetcher &) = delete;
+    Prefetcher &operator=(const Prefetcher &) = delete;
+
+    // Следующий файл или std::nullopt, когда файлы закончились.
+    std::optional<PrefetchedFile> Next();
+
+private:
+    void Run();
+
+    std::vector<std::string> filenames;
+    const BatchParser &parser;
+    BoundedQueue<PrefetchedFile> queue;
+    std::exception_ptr error;
+    std::thread reader;
+};
+
+}  // namespace analyzer::file
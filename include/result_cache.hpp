@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "function.hpp"
+#include "metric.hpp"
+
+namespace analyzer::metric {
+
+/**
+ * @brief Отпечаток функции: 64-битный FNV-1a хэш её нормализованного AST.
+ *
+ * Столбцы и разница в пробельных символах не учитываются, номера строк берутся относительно
+ * первой строки функции. Поэтому одинаковые функции в разных файлах и на разных строках получают
+ * один отпечаток. В AST нет текста идентификаторов, поэтому имя функции, язык и исходный текст функции
+ * (с точностью до пробелов) хэшируются отдельно: от них зависят стиль именования и метрики Холстеда.
+ */
+Fingerprint FingerprintFunction(const function::Function &f);
+
+/**
+ * @brief Потокобезопасный кэш результатов метрик по отпечатку функции.
+ *
+ * MetricExtractor с подключённым кэшем считает метрики один раз на уникальный отпечаток, а для копий
+ * возвращает сохранённые результаты. Кэш разбит на шарды со своими мьютексами, поэтому потоки,
+ * обрабатывающие разные функции, почти не ждут друг друга. Попутно запоминается, где встретилась
+ * каждая функция, что даёт список групп дубликатов. Кэш рассчитан на один набор метрик:
+ * разные MetricExtractor не должны использовать один кэш.
+ *
+ * Результаты могут переживать отдельный анализ (как в демоне --serve), а места и статистика относятся
+ * к текущему анализу: BeginAnalysis сбрасывает их перед следующим. Чтобы кэш долгоживущего процесса
+ * не рос с каждой правкой, BeginAnalysis выбрасывает и результаты функций, которых не было
+ * в предыдущем анализе, так что в кэше остаётся не больше функций, чем в одном анализе.
+ */
+class ResultCache {
+public:
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        double HitRate() const;
+    };
+
+    struct Location {
+        std::string filename;
+        std::string qualified_name;  // Имя функции в отчёте, как function::QualifiedName.
+        size_t line;                 // Номер строки с объявлением, начиная с 1; 0, если неизвестен.
+        auto operator<=>(const Location &) const = default;
+    };
+
+    struct Cluster {
+        Fingerprint fingerprint;
+        std::vector<Location> locations;
+    };
+
+    // Результаты, ранее сохранённые для `fingerprint`, копируются в `resource`. Ни место функции,
+    // ни попадание при этом не учитываются: это делает Record.
+    std::optional<MetricResults> Find(Fingerprint fingerprint, std::pmr::memory_resource *resource) const;
+
+    // Запоминает место функции `f` и учитывает попадание или промах. Результаты сохраняются, только если
+    // для `fingerprint` их ещё нет (например, другой поток успел сохранить их раньше).
+    void Record(Fingerprint fingerprint, const function::Function &f, const MetricResults &results);
+
+    Stats GetStats() const;
+
+    // Забывает места функций и статистику попаданий. Результаты сохраняются только для функций,
+    // встреченных после прошлого вызова, остальные выбрасываются.
+    void BeginAnalysis();
+
+    // Группы из двух и более функций с одинаковым отпечатком: сначала самые большие.
+    std::vector<Cluster> DuplicateClusters() const;
+
+private:
+    static constexpr size_t kShardsCount = 16;
+
+    struct Entry {
+        std::vector<MetricResult> results;  // Копии в обычной куче, переживают арены файлов.
+        // Множество: повторный анализ той же функции не делает её копией самой себя.
+        std::set<Location> locations;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<Fingerprint, Entry> entries;
+    };
+
+    Shard &ShardFor(Fingerprint fingerprint) { return shards[fingerprint % kShardsCount]; }
+    const Shard &ShardFor(Fingerprint fingerprint) const { return shards[fingerprint % kShardsCount]; }
+
+    std::array<Shard, kShardsCount> shards;
+    std::atomic<size_t> hits{0};
+    std::atomic<size_t> misses{0};
+};
+
+}  // namespace analyzer::metric
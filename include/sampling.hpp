@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "function.hpp"
+#include "metric.hpp"
+
+namespace analyzer::sampling {
+
+// Число файлов в выборке доли `rate` из (0, 1]: округление вверх, но не меньше одного файла, если файлы есть.
+size_t SampleSize(size_t population, double rate);
+
+/**
+ * @brief Воспроизводимая случайная выборка `count` файлов.
+ *
+ * Каждому файлу сопоставляется псевдослучайный ключ — хэш пути, перемешанный с `seed`, — и берутся `count`
+ * файлов с наименьшими ключами. Поэтому выборка зависит только от набора путей и seed, но не от порядка
+ * файлов в списке, а при добавлении файлов в репозиторий прежние файлы выпадают из неё лишь изредка.
+ * Выбранные файлы возвращаются в исходном порядке.
+ */
+std::vector<std::string> SampleFiles(const std::vector<std::string> &files, size_t count, std::uint64_t seed);
+
+// Оценка суммы по всем файлам с полушириной 95% доверительного интервала.
+struct Estimate {
+    double total;
+    // 0, если в выборку попали все файлы; бесконечность, если разброс по одному файлу не оценить.
+    double margin;
+};
+
+/**
+ * @brief Экстраполирует суммы метрик с выборки файлов на все файлы.
+ *
+ * Выборка файлов простая случайная без возвращения, поэтому сумма по всем N файлам оценивается как
+ * N · (среднее по n файлам выборки), а её стандартная ошибка — N · sqrt((1 - n/N) · s² / n), где s² —
+ * выборочная дисперсия сумм по файлам. Так оцениваются суммы числовых метрик и числа функций
+ * каждой категории категориальных метрик. Файлы выборки без функций участвуют в оценке нулями.
+ *
+ * Функции одного файла передаются в Add подряд, как их выдаёт AnalyseFunctions; перед запросом оценок
+ * вызывается Finalize.
+ */
+class TotalEstimator {
+public:
+    TotalEstimator(size_t population, size_t sample_size);
+
+    void Add(const function::Function &function, const metric::MetricResults &results);
+    void Finalize();
+
+    // Сумма числовой метрики `metric` по всем файлам.
+    Estimate Sum(std::string_view metric) const;
+    // Числа функций с каждой категорией метрики `metric` по всем файлам, по убыванию оценки.
+    std::vector<std::pair<std::string, Estimate>> Categories(std::string_view metric) const;
+
+private:
+    // Сумма и сумма квадратов значений по файлам выборки.
+    struct Totals {
+        double sum = 0;
+        double sum_squares = 0;
+    };
+
+    void FlushFile();
+    Estimate Extrapolate(const Totals &totals) const;
+
+    size_t population;
+    size_t sample_size;
+    std::string current_file;
+    // Ключ — название числовой метрики или "метрика\0категория".
+    std::unordered_map<std::string, double> file_values;
+    std::unordered_map<std::string, Totals> totals;
+};
+
+}  // namespace analyzer::sampling
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace analyzer::server {
+
+// Обрабатывает один запрос: аргументы командной строки клиента (без имени программы) и поток,
+// в который пишется отчёт. Возвращает код завершения для клиента.
+using RequestHandler = std::function<int(const std::vector<std::string> &args, std::FILE *out)>;
+
+/**
+ * @brief Демон, который принимает запросы на анализ через Unix-сокет.
+ *
+ * Процесс живёт между вызовами, поэтому таблицы языков, зарегистрированные метрики и кэш результатов
+ * остаются прогретыми, а клиент платит только за подключение и сам анализ.
+ *
+ * Протокол: клиент отправляет рабочий каталог, число аргументов и сами аргументы, каждое значение
+ * завершается '\0'. Сервер переходит в рабочий каталог клиента (относительные пути файлов остаются
+ * верными), отвечает текстом отчёта, затем '\0' и кодом завершения, и закрывает соединение.
+ * Запросы обрабатываются по одному.
+ */
+class Server {
+public:
+    // Создаёт сокет; оставшийся от прошлого запуска файл сокета удаляется.
+    Server(std::string socket_path, RequestHandler handler);
+    ~Server();
+    Server(const Server &) = delete;
+    Server &operator=(const Server &) = delete;
+
+    // Принимает одно соединение и обрабатывает запрос из него.
+    void ServeOne();
+    [[noreturn]] void ServeForever();
+
+private:
+    std::string socket_path;
+    RequestHandler handler;
+    int listen_fd = -1;
+};
+
+// Отправляет аргументы демону и печатает его отчёт в `out`. Возвращает код завершения, полученный от демона.
+int RunClient(const std::string &socket_path, const std::vector<std::string> &args, std::FILE *out = stdout);
+
+}  // namespace analyzer::server
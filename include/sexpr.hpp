@@ -0,0 +1,282 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "language.hpp"
+
+namespace analyzer::sexpr {
+
+struct Position {
+    size_t line = 0;
+    size_t col = 0;
+};
+
+// Диапазон узла в исходнике: "[row, col] - [row, col]" из вывода tree-sitter.
+struct Span {
+    Position start;
+    Position end;
+};
+
+/**
+ * @brief Разбирает диапазон "[row, col] - [row, col]", начинающийся с первой '[' не раньше `pos`.
+ *
+ * Числа читаются std::from_chars прямо из строки, без подстрок и выделений памяти. При успехе `pos`
+ * сдвигается за вторую ']'; если диапазона нет или он повреждён, возвращается std::nullopt.
+ */
+std::optional<Span> DecodeSpan(std::string_view text, size_t &pos);
+
+// Символы, на которых заканчивается тип узла или слово поля.
+constexpr bool IsDelimiter(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '(' || c == ')' || c == '[' || c == '"';
+}
+
+// Открывающийся узел S-выражения. kind и field действительны только во время вызова обработчика.
+struct Node {
+    std::string_view kind;
+    std::string_view field;  // Поле родителя вместе с двоеточием ("name:") или пустая строка.
+    size_t offset;           // Смещение открывающей скобки от начала потока.
+    size_t depth;            // Глубина узла; у корня дерева 0.
+    Span span;
+};
+
+/**
+ * @brief Потоковый токенизатор S-выражений из вывода `tree-sitter parse`.
+ *
+ * Принимает текст произвольными кусками по мере чтения (лексема может быть разрезана границей куска)
+ * и сообщает обработчику о каждом узле: handler.OnOpen(const Node &) после того, как прочитаны тип,
+ * поле и диапазон узла, и handler.OnClose(end, depth) на закрывающей скобке, где end — смещение
+ * за ней. Координаты разбираются по символу, без построения подстрок. Скобки внутри кавычек
+ * (например, `(MISSING ")")`) на вложенность не влияют, текст вне деревьев пропускается.
+ */
+template <typename Handler>
+class Tokenizer {
+public:
+    Tokenizer(Handler &handler, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : handler{handler}, kind{resource}, word{resource}, field{resource}, node_field{resource} {}
+
+    void Feed(std::string_view chunk) {
+        for (char c : chunk) {
+            Consume(c);
+            offset++;
+        }
+    }
+
+    // Сообщает об узле, у которого так и не встретился диапазон (например, в конце обрезанного вывода).
+    void Finish() { EmitPending(); }
+
+private:
+    enum class State { Text, Kind, Word, Coordinates, Quoted };
+
+    void Consume(char c) {
+        switch (state) {
+        case State::Quoted:
+            if (c == '"')
+                state = State::Text;
+            return;
+        case State::Coordinates:
+            if (c >= '0' && c <= '9') {
+                number = number * 10 + static_cast<size_t>(c - '0');
+            } else if (c == ',') {
+                row = number;
+                number = 0;
+            } else if (c == ']') {
+                Position &target = brackets_read == 0 ? pending.span.start : pending.span.end;
+                target = {row, number};
+                state = State::Text;
+                if (++brackets_read == 2)
+                    EmitPending();
+            }
+            return;
+        case State::Kind:
+            if (!IsDelimiter(c)) {
+                kind.push_back(c);
+                return;
+            }
+            state = State::Text;
+            break;
+        case State::Word:
+            if (!IsDelimiter(c)) {
+                word.push_back(c);
+                return;
+            }
+            if (word.ends_with(':'))
+                field.swap(word);
+            state = State::Text;
+            break;
+        case State::Text:
+            break;
+        }
+
+        switch (c) {
+        case '(':
+            EmitPending();
+            node_field.swap(field);
+            field.clear();
+            kind.clear();
+            pending = {.kind = {}, .field = {}, .offset = offset, .depth = depth, .span = {}};
+            has_pending = true;
+            brackets_read = 0;
+            depth++;
+            state = State::Kind;
+            break;
+        case ')':
+            EmitPending();
+            if (depth > 0) {
+                depth--;
+                handler.OnClose(offset + 1, depth);
+            }
+            break;
+        case '[':
+            if (has_pending) {
+                number = 0;
+                row = 0;
+                state = State::Coordinates;
+            }
+            break;
+        case '"':
+            if (depth > 0)
+                state = State::Quoted;
+            break;
+        case ' ':
+        case '\n':
+        case '\r':
+        case '\t':
+            break;
+        default:
+            word.assign(1, c);
+            state = State::Word;
+            break;
+        }
+    }
+
+    void EmitPending() {
+        if (!has_pending)
+            return;
+        has_pending = false;
+        pending.kind = kind;
+        pending.field = node_field;
+        handler.OnOpen(pending);
+    }
+
+    Handler &handler;
+    State state = State::Text;
+    size_t offset = 0;
+    size_t depth = 0;
+
+    std::pmr::string kind;
+    std::pmr::string word;
+    std::pmr::string field;       // Последнее прочитанное поле; относится к следующему узлу.
+    std::pmr::string node_field;  // Поле узла, ожидающего диапазон.
+
+    Node pending{};
+    bool has_pending = false;
+    size_t brackets_read = 0;
+    size_t number = 0;
+    size_t row = 0;
+};
+
+/**
+ * @brief Обходит уже прочитанное S-выражение целиком, сообщая обработчику те же события, что и Tokenizer.
+ *
+ * В отличие от Tokenizer текст не копируется посимвольно: тип и поле узла — подстроки `ast`, а поиск
+ * скобок идёт через find_first_of. Диапазоны узлов не разбираются (Node::span пуст), поэтому обход
+ * подходит метрикам, которым важны только типы узлов и их вложенность.
+ */
+template <typename Handler>
+void WalkNodes(std::string_view ast, Handler &handler) {
+    // find_first_of сверяет каждый символ со всем набором через отдельный поиск, поэтому здесь простые циклы.
+    auto next_special = [ast](size_t pos) {
+        for (; pos < ast.size(); ++pos) {
+            const char c = ast[pos];
+            if (c == '(' || c == ')' || c == '"')
+                return pos;
+        }
+        return std::string_view::npos;
+    };
+    size_t depth = 0;
+    for (size_t pos = next_special(0); pos != std::string_view::npos; pos = next_special(pos + 1)) {
+        if (ast[pos] == '"') {
+            // Скобки внутри кавычек, например `(MISSING ")")`, на вложенность не влияют.
+            if (depth > 0 && (pos = ast.find('"', pos + 1)) == std::string_view::npos)
+                break;
+            continue;
+        }
+        if (ast[pos] == ')') {
+            if (depth > 0) {
+                depth--;
+                handler.OnClose(pos + 1, depth);
+            }
+            continue;
+        }
+
+        size_t kind_end = pos + 1;
+        while (kind_end < ast.size() && !IsDelimiter(ast[kind_end]))
+            kind_end++;
+        // Поле — слово с двоеточием непосредственно перед скобкой ("alternative: (...").
+        std::string_view field;
+        size_t field_end = pos;
+        while (field_end > 0 && (ast[field_end - 1] == ' ' || ast[field_end - 1] == '\n'))
+            field_end--;
+        if (field_end > 0 && ast[field_end - 1] == ':') {
+            const size_t field_start = ast.find_last_of(" \n\t()", field_end - 1);
+            const size_t start = field_start == std::string_view::npos ? 0 : field_start + 1;
+            field = ast.substr(start, field_end - start);
+        }
+        handler.OnOpen(Node{.kind = ast.substr(pos + 1, kind_end - pos - 1),
+                            .field = field,
+                            .offset = pos,
+                            .depth = depth,
+                            .span = {}});
+        depth++;
+    }
+}
+
+// Функция, лямбда или класс, найденные при чтении AST.
+struct StructureNode {
+    static constexpr size_t kNoParent = static_cast<size_t>(-1);
+
+    language::NodeCategory category;
+    size_t begin;  // Смещение открывающей скобки узла.
+    size_t end;    // Смещение за закрывающей скобкой; 0, пока узел не закрыт.
+    size_t depth;
+    Span span;
+    std::optional<Span> name;
+    size_t parent = kNoParent;  // Индекс ближайшей объемлющей функции, лямбды или класса.
+};
+
+// Функции, лямбды и классы в порядке появления в AST, поэтому родитель всегда стоит раньше потомка.
+using StructureIndex = std::pmr::vector<StructureNode>;
+
+// Ближайший объемлющий узел категории `category` или nullptr.
+const StructureNode *FindAncestor(const StructureIndex &index, const StructureNode &node,
+                                  language::NodeCategory category);
+
+/**
+ * @brief Обработчик для Tokenizer, который строит StructureIndex прямо во время чтения AST.
+ *
+ * Имя функции — идентификатор в поле language.function_name_field, имя класса — в поле "name:".
+ * В C++ имя вложено в деклараторы: путь к нему идёт по полям "declarator:" и "name:", так что
+ * у `Foo<T>::bar` именем будет bar, а у `operator==` — весь operator_name.
+ */
+class StructureIndexBuilder {
+public:
+    StructureIndexBuilder(const language::Language &language, StructureIndex &index);
+
+    void OnOpen(const Node &node);
+    void OnClose(size_t end, size_t depth);
+
+private:
+    static constexpr size_t kNoField = static_cast<size_t>(-1);
+
+    const language::Language &language;
+    StructureIndex &index;
+    std::pmr::vector<size_t> open;       // Индексы незакрытых узлов индекса: стек областей видимости.
+    size_t name_field_depth = kNoField;  // Глубина последнего узла на пути к имени, пока имя не найдено.
+};
+
+}  // namespace analyzer::sexpr
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace analyzer {
+
+/**
+ * @brief Вектор тривиально копируемых элементов, первые `N` из которых хранятся внутри самого объекта.
+ *
+ * Пока элементов не больше `N`, ни создание, ни копирование вектора не обращаются к памяти: так
+ * результаты метрик функции переносятся из арены файла в общий список анализа без аллокаций.
+ * При переполнении элементы переезжают в буфер из polymorphic_allocator, как у std::pmr::vector,
+ * и распределитель так же не передаётся при присваивании и обмене.
+ */
+template <typename T, size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable_v<T>, "SmallVector копирует элементы через memcpy");
+
+public:
+    using value_type = T;
+    using allocator_type = std::pmr::polymorphic_allocator<T>;
+    using size_type = size_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    SmallVector() = default;
+    explicit SmallVector(const allocator_type &alloc) : alloc{alloc} {}
+
+    SmallVector(const SmallVector &other)
+        : SmallVector(other, other.alloc.select_on_container_copy_construction()) {}
+    SmallVector(const SmallVector &other, const allocator_type &alloc) : alloc{alloc} { Assign(other); }
+
+    SmallVector(SmallVector &&other) noexcept : alloc{other.alloc} { Steal(other); }
+    SmallVector(SmallVector &&other, const allocator_type &alloc) : alloc{alloc} {
+        if (alloc == other.alloc)
+            Steal(other);
+        else
+            Assign(other);
+    }
+
+    SmallVector &operator=(const SmallVector &other) {
+        if (this != &other)
+            Assign(other);
+        return *this;
+    }
+
+    SmallVector &operator=(SmallVector &&other) {
+        if (this == &other)
+            return *this;
+        if (alloc == other.alloc) {
+            Release();
+            Steal(other);
+        } else {
+            Assign(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector() { Release(); }
+
+    void push_back(const T &value) { emplace_back(value); }
+
+    template <typename... Args>
+    T &emplace_back(Args &&...args) {
+        // Значение собирается до возможного переезда: аргумент может ссылаться на элемент этого же вектора.
+        T value(std::forward<Args>(args)...);
+        if (count == capacity_)
+            Grow(count + 1);
+        T *slot = ::new (static_cast<void *>(data_ + count)) T(value);
+        ++count;
+        return *slot;
+    }
+
+    void reserve(size_t n) {
+        if (n > capacity_)
+            Grow(n);
+    }
+
+    void clear() { count = 0; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t capacity() const { return capacity_; }
+
+    T *data() { return data_; }
+    const T *data() const { return data_; }
+    iterator begin() { return data_; }
+    iterator end() { return data_ + count; }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + count; }
+
+    T &operator[](size_t i) { return data_[i]; }
+    const T &operator[](size_t i) const { return data_[i]; }
+    T &front() { return data_[0]; }
+    const T &front() const { return data_[0]; }
+    T &back() { return data_[count - 1]; }
+    const T &back() const { return data_[count - 1]; }
+
+    allocator_type get_allocator() const { return alloc; }
+
+    friend bool operator==(const SmallVector &lhs, const SmallVector &rhs)
+        requires std::equality_comparable<T>
+    {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+private:
+    bool IsInline() const { return data_ == InlineData(); }
+    T *InlineData() { return reinterpret_cast<T *>(inline_storage); }
+    const T *InlineData() const { return reinterpret_cast<const T *>(inline_storage); }
+
+    void Grow(size_t n) {
+        const size_t new_capacity = std::max(2 * capacity_, n);
+        T *buffer = alloc.allocate(new_capacity);
+        if (count > 0)
+            std::memcpy(static_cast<void *>(buffer), data_, count * sizeof(T));
+        Release();
+        data_ = buffer;
+        capacity_ = new_capacity;
+    }
+
+    void Assign(const SmallVector &other) {
+        count = 0;
+        reserve(other.count);
+        if (other.count > 0)
+            std::memcpy(static_cast<void *>(data_), other.data_, other.count * sizeof(T));
+        count = other.count;
+    }
+
+    // Забирает содержимое `other` с тем же распределителем; `other` остаётся пустым.
+    void Steal(SmallVector &other) {
+        if (other.IsInline()) {
+            if (other.count > 0)
+                std::memcpy(static_cast<void *>(InlineData()), other.data_, other.count * sizeof(T));
+        } else {
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+            other.data_ = other.InlineData();
+            other.capacity_ = N;
+        }
+        count = other.count;
+        other.count = 0;
+    }
+
+    void Release() {
+        if (!IsInline())
+            alloc.deallocate(data_, capacity_);
+        data_ = InlineData();
+        capacity_ = N;
+    }
+
+    alignas(T) std::byte inline_storage[N * sizeof(T)];
+    T *data_ = InlineData();
+    size_t count = 0;
+    size_t capacity_ = N;
+    allocator_type alloc;
+};
+
+}  // namespace analyzer
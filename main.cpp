@@ -2,103 +2,567 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <filesystem>
+#include <format>
 #include <fstream>
 #include <functional>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
 #include <print>
 #include <ranges>
 #include <sstream>
+#include <stop_token>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
 #include "analyse.hpp"
+#include "batch_parser.hpp"
+#include "budget.hpp"
+#include "call_graph.hpp"
+#include "clones.hpp"
 #include "cmd_options.hpp"
+#include "diff.hpp"
 #include "file.hpp"
 #include "function.hpp"
+#include "history.hpp"
 #include "metric.hpp"
 #include "metric_accumulator.hpp"
 #include "metric_accumulator_impl/accumulators.hpp"
 #include "metric_impl/metrics.hpp"
+#include "policy.hpp"
+#include "result_cache.hpp"
+#include "sampling.hpp"
+#include "server.hpp"
 
-int main(int argc, char *argv[]) {
-    analyzer::cmd::ProgramOptions options;
-    if (!options.Parse(argc, argv))
+namespace {
+using namespace analyzer::metric::metric_impl;
+
+// Метрики, которые считаются по одной функции; порядок списка — порядок метрик в отчёте.
+template <typename... Metrics>
+struct MetricList {
+    static void Register(analyzer::metric::MetricExtractor &extractor,
+                         const std::function<bool(std::string_view)> &wanted) {
+        (..., (wanted(Metrics::kName) ? extractor.RegisterMetric(std::make_unique<Metrics>()) : void()));
+    }
+
+    static bool Contains(std::string_view name) { return (... || (Metrics::kName == name)); }
+};
+
+using FunctionMetrics =
+    MetricList<CyclomaticComplexityMetric, CognitiveComplexityMetric, MaxNestingDepthMetric, CodeLinesCountMetric,
+               NamingStyleMetric, CountParametersMetric, HalsteadVolumeMetric, HalsteadDifficultyMetric,
+               HalsteadEffortMetric, MaintainabilityIndexMetric>;
+
+using analyzer::function::QualifiedName;
+
+// Печатает метрики функций, задетых diff из --diff. Если задан --diff-base, те же функции старой версии
+// анализируются по удалённым строкам, и для каждой метрики печатается изменение "было -> стало".
+int RunDiff(const analyzer::cmd::ProgramOptions &options, const analyzer::metric::MetricExtractor &metric_extractor,
+            const analyzer::function::FunctionExtractor &function_extractor, std::FILE *out) {
+    std::ifstream diff_file;
+    std::istream *diff_stream = &std::cin;
+    if (options.GetDiff() != "-") {
+        diff_file.open(options.GetDiff());
+        if (!diff_file) {
+            std::println(out, "Error: can't open diff {}", options.GetDiff());
+            return 1;
+        }
+        diff_stream = &diff_file;
+    }
+
+    auto is_supported = [](std::string_view path) {
+        const std::string extension = std::filesystem::path(path).extension().string();
+        return std::ranges::any_of(analyzer::language::SupportedLanguages(), [&](const auto &language) {
+            return std::ranges::find(language.extensions, extension) != language.extensions.end();
+        });
+    };
+
+    using analyzer::metric::MetricValue;
+    auto print_value = [out](const MetricValue &value) { std::println(out, "{}", value); };
+    auto print_delta = [out](const MetricValue &before, const MetricValue &after) {
+        if (before.GetKind() != after.GetKind())
+            std::println(out, "{} -> {}", before, after);
+        else if (after.GetKind() == MetricValue::Kind::Integer)
+            std::println(out, "{} -> {} ({:+})", before, after, after.AsInteger() - before.AsInteger());
+        else if (after.GetKind() == MetricValue::Kind::Real)
+            std::println(out, "{} -> {} ({:+})", before, after, after.AsReal() - before.AsReal());
+        else
+            std::println(out, "{} -> {}", before, after);
+    };
+
+    std::println(out, "Analysis for changed functions:");
+    for (const auto &file_diff : analyzer::diff::ParseUnifiedDiff(*diff_stream)) {
+        if (file_diff.new_path == analyzer::diff::kNullPath || !is_supported(file_diff.new_path))
+            continue;
+
+        auto after = analyzer::AnalyseChangedFunctions(file_diff.new_path, file_diff.new_lines, metric_extractor,
+                                                       function_extractor);
+        if (options.GetDiffBase().empty()) {
+            for (const auto &[function, metrics] : after) {
+                std::println(out, "  {}::{}: ", function.filename, QualifiedName(function));
+                for (const auto &result : metrics) {
+                    std::print(out, "    {}: ", result.metric_name);
+                    print_value(result.value);
+                }
+            }
+            continue;
+        }
+
+        decltype(after) before;
+        if (file_diff.old_path != analyzer::diff::kNullPath) {
+            const auto old_path = std::filesystem::path(options.GetDiffBase()) / file_diff.old_path;
+            before = analyzer::AnalyseChangedFunctions(old_path.string(), file_diff.old_lines, metric_extractor,
+                                                       function_extractor);
+        }
+        std::map<std::string, const analyzer::metric::MetricResults *> before_by_name;
+        for (const auto &[function, metrics] : before) {
+            before_by_name.emplace(QualifiedName(function), &metrics);
+        }
+
+        for (const auto &[function, metrics] : after) {
+            const std::string name = QualifiedName(function);
+            auto it = before_by_name.find(name);
+            std::println(out, "  {}::{}{}: ", file_diff.new_path, name, it == before_by_name.end() ? " (added)" : "");
+            for (const auto &result : metrics) {
+                std::print(out, "    {}: ", result.metric_name);
+                const analyzer::metric::MetricResult *old_result = nullptr;
+                if (it != before_by_name.end()) {
+                    auto old_it = std::ranges::find(*it->second, result.metric_name,
+                                                    &analyzer::metric::MetricResult::metric_name);
+                    if (old_it != it->second->end())
+                        old_result = &*old_it;
+                }
+                if (old_result)
+                    print_delta(old_result->value, result.value);
+                else
+                    print_value(result.value);
+            }
+            if (it != before_by_name.end())
+                before_by_name.erase(it);
+        }
+        for (const auto &[name, metrics] : before_by_name) {
+            std::println(out, "  {}::{} (removed)", file_diff.old_path, name);
+        }
+    }
+    return 0;
+}
+
+// Печатает по хранилищу из --history-store, как менялась метрика --history: функции с наибольшим ростом
+// с первого запуска и функции, у которых она выросла в последнем запуске.
+int RunHistory(const analyzer::cmd::ProgramOptions &options, std::FILE *out) {
+    const analyzer::history::HistoryStore store(options.GetHistoryStore());
+    auto trends = store.Trends(options.GetHistory());
+    if (trends.empty()) {
+        std::println(out, "Error: no history of {} in {}", options.GetHistory(), options.GetHistoryStore());
         return 1;
-    using namespace analyser::metric::metric_impl;
-    analyser::metric::MetricExtractor metric_extractor;
-    metric_extractor.RegisterMetric(std::make_unique<CyclomaticComplexityMetric>());
-    metric_extractor.RegisterMetric(std::make_unique<CodeLinesCountMetric>());
-    metric_extractor.RegisterMetric(std::make_unique<NamingStyleMetric>());
-    metric_extractor.RegisterMetric(std::make_unique<CountParametersMetric>());
+    }
+    const size_t top = options.GetTop() > 0 ? options.GetTop() : 10;
+    const auto last_run = static_cast<std::uint32_t>(store.RunCount());
+    std::println(out, "History of {}: {} runs, {} functions", options.GetHistory(), last_run, trends.size());
+
+    auto print_top = [&](std::string_view title, auto &&selected, auto delta) {
+        std::ranges::sort(selected, std::greater<>{}, delta);
+        std::println(out);
+        std::println(out, "{} ({} functions):", title, selected.size());
+        for (const auto &trend : selected | std::views::take(top)) {
+            std::println(out, "  {}: {} -> {} ({:+}) over {} runs", store.FunctionName(trend.function), trend.first,
+                         trend.last, delta(trend), trend.runs);
+        }
+    };
+    auto growth = [](const auto &trend) { return trend.last - trend.first; };
+    auto last_change = [](const auto &trend) { return trend.last - trend.previous; };
+
+    std::vector<analyzer::history::FunctionTrend> grown;
+    std::vector<analyzer::history::FunctionTrend> regressed;
+    for (const auto &trend : trends) {
+        if (growth(trend) > 0)
+            grown.push_back(trend);
+        if (trend.last_run == last_run && trend.runs > 1 && last_change(trend) > 0)
+            regressed.push_back(trend);
+    }
+    print_top("Largest increase since first run", grown, growth);
+    print_top(std::format("Regressions in run {}", last_run), regressed, last_change);
+    return 0;
+}
+
+// Проверяет функции по политике из --policy без полного отчёта: считаются только метрики из правил,
+// а нарушения печатаются, как только проанализирован файл. С --fail-fast анализ останавливается
+// на первом нарушении. Файл, пропущенный по бюджету, не проверен и поэтому тоже нарушает политику.
+// Возвращает 1, если политика нарушена, и 2, если файл политики не разобран или называет неизвестную метрику.
+int RunPolicy(const analyzer::cmd::ProgramOptions &options, const analyzer::file::BatchParser &parser,
+              const analyzer::file::Budget &budget, const analyzer::function::FunctionExtractor &function_extractor,
+              std::FILE *out) {
+    std::optional<analyzer::policy::Policy> policy;
+    try {
+        policy = analyzer::policy::Policy::Load(options.GetPolicy());
+        policy->RequireKnownMetrics(&FunctionMetrics::Contains);
+    } catch (const std::invalid_argument &e) {
+        std::println(out, "Error: {}", e.what());
+        return 2;
+    }
+    analyzer::metric::MetricExtractor metric_extractor;
+    FunctionMetrics::Register(metric_extractor, [&](std::string_view name) { return policy->UsesMetric(name); });
+
+    size_t functions_checked = 0;
+    size_t violations = 0;
+    std::vector<analyzer::file::SkippedFile> skipped_files;
+    size_t skipped_reported = 0;
+    std::stop_source stop;
+    // Пропуски дописываются в skipped_files между файлами, поэтому печатаются при следующей проверке и в конце.
+    auto report_skipped = [&] {
+        for (; skipped_reported < skipped_files.size(); ++skipped_reported) {
+            const auto &skipped = skipped_files[skipped_reported];
+            std::println(out, "{}: not checked, skipped over budget ({} limit {}, actual {})", skipped.filename,
+                         analyzer::file::ToString(skipped.reason), skipped.limit, skipped.actual);
+        }
+    };
+    auto check = [&](const analyzer::function::Function &function, const analyzer::metric::MetricResults &results) {
+        report_skipped();
+        if (!skipped_files.empty() && options.GetFailFast()) {
+            stop.request_stop();
+            return;
+        }
+        functions_checked++;
+        for (const auto &violation : policy->Check(function.filename, results)) {
+            violations++;
+            std::println(out, "{}:{} {}: {} = {} exceeds {} (policy line {})", function.filename,
+                         function.span ? function.span->start.line + 1 : 0, QualifiedName(function),
+                         violation.rule->metric, violation.value, violation.rule->threshold, violation.rule->line);
+        }
+        if (violations > 0 && options.GetFailFast())
+            stop.request_stop();
+    };
+    analyzer::StreamFunctions(options.GetFiles(), metric_extractor, check, parser, options.GetPrefetchDepth(), budget,
+                              &skipped_files, stop.get_token(), function_extractor);
+    report_skipped();
+
+    if (violations == 0 && skipped_files.empty()) {
+        std::println(out, "Policy passed: {} functions checked", functions_checked);
+        return 0;
+    }
+    std::println(out, "Policy violated: {} violations in {} functions checked, {} files skipped over budget{}",
+                 violations, functions_checked, skipped_files.size(),
+                 stop.stop_requested() ? ", stopped at the first violation" : "");
+    return 1;
+}
+
+// Анализирует файлы из `options` и печатает отчёт в `out`. Метрики и кэш результатов передаются извне,
+// чтобы демон (--serve) переиспользовал их между запросами.
+int Run(const analyzer::cmd::ProgramOptions &options, const analyzer::metric::MetricExtractor &metric_extractor,
+        const analyzer::metric::ResultCache &result_cache, std::FILE *out) {
+    const analyzer::function::FunctionExtractor function_extractor{.nested_functions = options.GetNestedFunctions(),
+                                                                   .lambdas = options.GetLambdas()};
+    if (!options.GetDiff().empty())
+        return RunDiff(options, metric_extractor, function_extractor, out);
+    if (!options.GetHistory().empty())
+        return RunHistory(options, out);
 
-    auto analysis = analyser::AnalyseFunctions(options.GetFiles(), metric_extractor);
+    analyzer::file::BatchParser parser(options.GetParseBatchSize(), options.GetParseJobs());
+    const analyzer::file::Budget budget{.timeout = std::chrono::milliseconds(options.GetFileTimeoutMs()),
+                                        .max_ast_bytes = options.GetMaxAstBytes(),
+                                        .max_functions = options.GetMaxFunctions()};
+    if (!options.GetPolicy().empty())
+        return RunPolicy(options, parser, budget, function_extractor, out);
+    std::vector<std::string> files = options.GetFiles();
+    if (options.IsSampling()) {
+        const size_t sample_size = options.GetSampleFiles() > 0
+                                       ? std::min(options.GetSampleFiles(), files.size())
+                                       : analyzer::sampling::SampleSize(files.size(), options.GetSampleRate());
+        files = analyzer::sampling::SampleFiles(files, sample_size, options.GetSampleSeed());
+    }
+    std::vector<analyzer::file::SkippedFile> skipped_files;
+    auto analysis = analyzer::AnalyseFunctions(files, metric_extractor, parser, options.GetPrefetchDepth(), budget,
+                                               &skipped_files, function_extractor);
 
-    std::println("Analysis for every function:");
+    // Fan In и Fan Out зависят от всех функций сразу, поэтому считаются по графу вызовов после анализа
+    // и дописываются к результатам каждой функции.
+    std::vector<const analyzer::function::Function *> functions;
+    functions.reserve(analysis.size());
+    for (const auto &[function, metrics] : analysis) {
+        functions.push_back(&function);
+    }
+    const auto call_graph = analyzer::call_graph::CallGraph::Build(functions, options.GetParseJobs());
+    analyzer::metric::MetricExtractor graph_metrics;
+    graph_metrics.RegisterMetric(std::make_unique<FanInMetric>(call_graph));
+    graph_metrics.RegisterMetric(std::make_unique<FanOutMetric>(call_graph));
+    for (auto &[function, metrics] : analysis) {
+        std::ranges::move(graph_metrics.Get(function), std::back_inserter(metrics));
+    }
+
+    std::println(out, "Analysis for every function:");
     std::ranges::for_each(analysis, [&](const auto &elem) {
         const auto &[function, metrics] = elem;
-        std::println("  {}::{}{}: ", function.filename,
-                     (function.class_name.has_value() ? function.class_name.value() + "::" : ""), function.name);
+        std::println(out, "  {}::{}: ", function.filename, QualifiedName(function));
         std::ranges::for_each(metrics, [&](const auto &result) {
-            std::print("    {}: ", result.metric_name);
-            std::visit([](auto &&val) { std::println("{}", val); }, result.value);
+            std::print(out, "    {}: ", result.metric_name);
+            std::println(out, "{}", result.value);
         });
     });
 
-    analyser::metric_accumulator::MetricsAccumulator accumulator;
-    using namespace analyser::metric_accumulator::metric_accumulator_impl;
+    analyzer::metric_accumulator::MetricsAccumulator accumulator;
+    using namespace analyzer::metric_accumulator::metric_accumulator_impl;
     accumulator.RegisterAccumulator(CyclomaticComplexityMetric::kName, std::make_unique<SumAverageAccumulator>());
     accumulator.RegisterAccumulator(NamingStyleMetric::kName, std::make_unique<CategoricalAccumulator>());
     accumulator.RegisterAccumulator(CodeLinesCountMetric::kName, std::make_unique<SumAverageAccumulator>());
     accumulator.RegisterAccumulator(CountParametersMetric::kName, std::make_unique<AverageAccumulator>());
+    accumulator.RegisterAccumulator(CognitiveComplexityMetric::kName, std::make_unique<SumAverageAccumulator>());
+    accumulator.RegisterAccumulator(CognitiveComplexityMetric::kName, std::make_unique<QuantileAccumulator>());
+    accumulator.RegisterAccumulator(MaxNestingDepthMetric::kName, std::make_unique<AverageAccumulator>());
+    accumulator.RegisterAccumulator(MaxNestingDepthMetric::kName, std::make_unique<QuantileAccumulator>());
+    accumulator.RegisterAccumulator(HalsteadVolumeMetric::kName, std::make_unique<AverageAccumulator>());
+    accumulator.RegisterAccumulator(MaintainabilityIndexMetric::kName, std::make_unique<AverageAccumulator>());
+    accumulator.RegisterAccumulator(FanInMetric::kName, std::make_unique<AverageAccumulator>());
+    accumulator.RegisterAccumulator(FanOutMetric::kName, std::make_unique<AverageAccumulator>());
+    accumulator.RegisterAccumulator(CyclomaticComplexityMetric::kName, std::make_unique<QuantileAccumulator>());
+    accumulator.RegisterAccumulator(CyclomaticComplexityMetric::kName,
+                                    std::make_unique<HistogramAccumulator>(std::vector{1, 5, 10, 20, 50}));
+    accumulator.RegisterAccumulator(CodeLinesCountMetric::kName, std::make_unique<QuantileAccumulator>());
+    accumulator.RegisterAccumulator(CodeLinesCountMetric::kName,
+                                    std::make_unique<HistogramAccumulator>(std::vector{5, 10, 25, 50, 100, 200}));
+    if (options.GetTop() > 0) {
+        for (const auto &metric_name :
+             {CyclomaticComplexityMetric::kName, CognitiveComplexityMetric::kName, MaxNestingDepthMetric::kName,
+              CodeLinesCountMetric::kName, CountParametersMetric::kName, FanInMetric::kName, FanOutMetric::kName}) {
+            accumulator.RegisterAccumulator(metric_name, std::make_unique<TopKAccumulator>(options.GetTop()));
+        }
+    }
+
+    auto print_distribution = [out](const auto &accumulator, const std::string &metric_name) {
+        auto &quantile_acc = accumulator.template GetFinalizedAccumulator<QuantileAccumulator>(metric_name);
+        auto quantiles = quantile_acc.Get();
+        std::println(out, "    {} p50: {}, p90: {}, p99: {}, max: {}", metric_name, quantiles.p50, quantiles.p90,
+                     quantiles.p99, quantiles.max);
+        auto &histogram_acc = accumulator.template GetFinalizedAccumulator<HistogramAccumulator>(metric_name);
+        int lower_bound = std::numeric_limits<int>::min();
+        std::ranges::for_each(histogram_acc.Get(), [&](const auto &bucket) {
+            if (bucket.upper_bound == std::numeric_limits<int>::max())
+                std::println(out, "    {} > {}: {}", metric_name, lower_bound, bucket.count);
+            else
+                std::println(out, "    {} <= {}: {}", metric_name, bucket.upper_bound, bucket.count);
+            lower_bound = bucket.upper_bound;
+        });
+    };
 
-    auto print_accumulated_analysis = [](const auto &accumulator) {
+    auto print_accumulated_analysis = [&print_distribution, out](const auto &accumulator) {
         auto &cc_acc_metric =
             accumulator.template GetFinalizedAccumulator<SumAverageAccumulator>(CyclomaticComplexityMetric::kName);
-        std::println("    Sum Cyclomatic Complexity: {}", cc_acc_metric.Get().sum);
-        std::println("    Average Cyclomatic Complexity per function: {}", cc_acc_metric.Get().average);
+        std::println(out, "    Sum Cyclomatic Complexity: {}", cc_acc_metric.Get().sum);
+        std::println(out, "    Average Cyclomatic Complexity per function: {}", cc_acc_metric.Get().average);
+        print_distribution(accumulator, CyclomaticComplexityMetric::kName);
         auto &naming_acc_metric =
             accumulator.template GetFinalizedAccumulator<CategoricalAccumulator>(NamingStyleMetric::kName);
-        std::ranges::for_each(naming_acc_metric.Get(), [](const auto &elem) {
-            std::println("    Naming style '{}' is occured {} times", elem.first, elem.second);
+        std::ranges::for_each(naming_acc_metric.Get(), [out](const auto &elem) {
+            std::println(out, "    Naming style '{}' is occured {} times", elem.first, elem.second);
         });
         auto &cl_acc_metric =
             accumulator.template GetFinalizedAccumulator<SumAverageAccumulator>(CodeLinesCountMetric::kName);
-        std::println("    Sum Code lines count: {}", cl_acc_metric.Get().sum);
-        std::println("    Average Code lines count per function: {}", cl_acc_metric.Get().average);
+        std::println(out, "    Sum Code lines count: {}", cl_acc_metric.Get().sum);
+        std::println(out, "    Average Code lines count per function: {}", cl_acc_metric.Get().average);
+        print_distribution(accumulator, CodeLinesCountMetric::kName);
         auto &cp_acc_metric =
             accumulator.template GetFinalizedAccumulator<AverageAccumulator>(CountParametersMetric::kName);
-        std::println("    Average Parameters count per function: {}", cp_acc_metric.Get());
+        std::println(out, "    Average Parameters count per function: {}", cp_acc_metric.Get());
+        auto &cog_acc_metric =
+            accumulator.template GetFinalizedAccumulator<SumAverageAccumulator>(CognitiveComplexityMetric::kName);
+        std::println(out, "    Sum Cognitive Complexity: {}", cog_acc_metric.Get().sum);
+        std::println(out, "    Average Cognitive Complexity per function: {}", cog_acc_metric.Get().average);
+        auto &cog_quantiles =
+            accumulator.template GetFinalizedAccumulator<QuantileAccumulator>(CognitiveComplexityMetric::kName);
+        std::println(out, "    {} p90: {}, max: {}", CognitiveComplexityMetric::kName, cog_quantiles.Get().p90,
+                     cog_quantiles.Get().max);
+        auto &nesting_acc_metric =
+            accumulator.template GetFinalizedAccumulator<AverageAccumulator>(MaxNestingDepthMetric::kName);
+        auto &nesting_quantiles =
+            accumulator.template GetFinalizedAccumulator<QuantileAccumulator>(MaxNestingDepthMetric::kName);
+        std::println(out, "    Average Max Nesting Depth per function: {}, max: {}", nesting_acc_metric.Get(),
+                     nesting_quantiles.Get().max);
+        auto &volume_acc_metric =
+            accumulator.template GetFinalizedAccumulator<AverageAccumulator>(HalsteadVolumeMetric::kName);
+        std::println(out, "    Average Halstead Volume per function: {}", volume_acc_metric.Get());
+        auto &mi_acc_metric =
+            accumulator.template GetFinalizedAccumulator<AverageAccumulator>(MaintainabilityIndexMetric::kName);
+        std::println(out, "    Average Maintainability Index per function: {}", mi_acc_metric.Get());
+        auto &fan_in_acc_metric = accumulator.template GetFinalizedAccumulator<AverageAccumulator>(FanInMetric::kName);
+        auto &fan_out_acc_metric =
+            accumulator.template GetFinalizedAccumulator<AverageAccumulator>(FanOutMetric::kName);
+        std::println(out, "    Average Fan In per function: {}, Fan Out: {}", fan_in_acc_metric.Get(),
+                     fan_out_acc_metric.Get());
     };
 
-    auto analysis_by_files = analyser::SplitByFiles(analysis);
+    auto analysis_by_files = analyzer::SplitByFiles(analysis);
 
-    std::ranges::for_each(analysis_by_files, [&accumulator, &print_accumulated_analysis](const auto &analysis) {
-        analyser::AccumulateFunctionAnalysis(analysis, accumulator);
-        std::println();
-        std::println("Accumulated Analysis for file {}:", analysis.front().first.filename);
+    std::ranges::for_each(analysis_by_files, [&accumulator, &print_accumulated_analysis, out](const auto &analysis) {
+        analyzer::AccumulateFunctionAnalysis(analysis, accumulator);
+        std::println(out);
+        std::println(out, "Accumulated Analysis for file {}:", analysis.front().first.filename);
         print_accumulated_analysis(accumulator);
         accumulator.ResetAccumulators();
     });
 
-    auto analysis_by_classes = analyser::SplitByClasses(analysis);
+    auto analysis_by_classes = analyzer::SplitByClasses(analysis);
 
-    std::ranges::for_each(analysis_by_classes, [&accumulator, &print_accumulated_analysis](const auto &analysis) {
-        analyser::AccumulateFunctionAnalysis(analysis, accumulator);
-        std::println();
-        std::println("Accumulated Analysis for сlass {}:", analysis.front().first.class_name.value());
+    std::ranges::for_each(analysis_by_classes, [&accumulator, &print_accumulated_analysis, out](const auto &analysis) {
+        analyzer::AccumulateFunctionAnalysis(analysis, accumulator);
+        std::println(out);
+        std::println(out, "Accumulated Analysis for сlass {}:", analysis.front().first.class_name.value());
         print_accumulated_analysis(accumulator);
         accumulator.ResetAccumulators();
     });
 
-    analyser::AccumulateFunctionAnalysis(analysis, accumulator);
-    std::println();
-    std::println("Accumulated Analysis for All Functions:");
+    analyzer::AccumulateFunctionAnalysis(analysis, accumulator, options.GetParseJobs());
+    std::println(out);
+    std::println(out, "Accumulated Analysis for All Functions:");
     print_accumulated_analysis(accumulator);
+    std::println(out, "    Files analysed: {}, skipped over budget: {}", files.size() - skipped_files.size(),
+                 skipped_files.size());
+    for (auto reason : {analyzer::file::SkipReason::Timeout, analyzer::file::SkipReason::AstSize,
+                        analyzer::file::SkipReason::FunctionCount}) {
+        auto count = std::ranges::count(skipped_files, reason, &analyzer::file::SkippedFile::reason);
+        if (count > 0)
+            std::println(out, "    Skipped by {}: {}", analyzer::file::ToString(reason), count);
+    }
+
+    // Суммы по выборке экстраполируются на все файлы; пропущенные по бюджету файлы считаются
+    // не попавшими в выборку.
+    if (options.IsSampling()) {
+        analyzer::sampling::TotalEstimator estimator(options.GetFiles().size(), files.size() - skipped_files.size());
+        for (const auto &[function, metrics] : analysis) {
+            estimator.Add(function, metrics);
+        }
+        estimator.Finalize();
+        std::println(out);
+        std::println(out, "Estimated totals for all {} files from a sample of {} (seed {}, 95% confidence):",
+                     options.GetFiles().size(), files.size(), options.GetSampleSeed());
+        for (const auto &metric_name :
+             {CyclomaticComplexityMetric::kName, CodeLinesCountMetric::kName, CognitiveComplexityMetric::kName}) {
+            const auto estimate = estimator.Sum(metric_name);
+            std::println(out, "    Sum {}: {:.0f} ± {:.0f}", metric_name, estimate.total, estimate.margin);
+        }
+        for (const auto &[category, estimate] : estimator.Categories(NamingStyleMetric::kName)) {
+            std::println(out, "    Naming style '{}': {:.0f} ± {:.0f} functions", category, estimate.total,
+                         estimate.margin);
+        }
+    }
+
+    if (options.GetTop() > 0) {
+        for (const auto &metric_name :
+             {CyclomaticComplexityMetric::kName, CognitiveComplexityMetric::kName, MaxNestingDepthMetric::kName,
+              CodeLinesCountMetric::kName, CountParametersMetric::kName, FanInMetric::kName, FanOutMetric::kName}) {
+            std::println(out);
+            std::println(out, "Top {} functions by {}:", options.GetTop(), metric_name);
+            auto &top_acc = accumulator.GetFinalizedAccumulator<TopKAccumulator>(metric_name);
+            std::ranges::for_each(top_acc.Get(), [out](const auto &entry) {
+                std::println(out, "  {}::{}{}: {}", entry.filename,
+                             (entry.class_name.has_value() ? entry.class_name.value() + "::" : ""),
+                             entry.function_name, entry.value);
+            });
+        }
+
+        // Связность класса — различные внешние функции, которые вызывают его методы или вызываются из них.
+        std::vector<std::pair<std::string_view, std::string_view>> classes;
+        for (const auto &[function, metrics] : analysis) {
+            if (function.class_name.has_value())
+                classes.emplace_back(function.filename, *function.class_name);
+        }
+        std::ranges::sort(classes);
+        classes.erase(std::unique(classes.begin(), classes.end()), classes.end());
+        std::vector<std::pair<analyzer::call_graph::ClassCoupling, size_t>> coupling;
+        for (size_t i = 0; i < classes.size(); ++i) {
+            coupling.emplace_back(call_graph.ForClass(classes[i].first, classes[i].second), i);
+        }
+        auto total = [](const auto &entry) { return entry.first.fan_in + entry.first.fan_out; };
+        std::ranges::stable_sort(coupling, std::greater<>{}, total);
+        std::println(out);
+        std::println(out, "Top {} classes by coupling:", options.GetTop());
+        for (const auto &[class_coupling, index] : coupling | std::views::take(options.GetTop())) {
+            std::println(out, "  {}::{}: fan in {}, fan out {}", classes[index].first, classes[index].second,
+                         class_coupling.fan_in, class_coupling.fan_out);
+        }
+        if (call_graph.UnresolvedCalls() > 0) {
+            std::println(out, "  Calls with ambiguous targets (not counted): {}", call_graph.UnresolvedCalls());
+        }
+    }
+
+    if (options.GetReportDuplicates()) {
+        const auto stats = result_cache.GetStats();
+        std::println(out);
+        std::println(out, "Metric result cache: {} hits, {} misses, hit rate {:.1f}%", stats.hits, stats.misses,
+                     stats.HitRate() * 100);
+        std::ranges::for_each(result_cache.DuplicateClusters(), [out](const auto &cluster) {
+            std::println(out, "Identical functions ({} copies):", cluster.locations.size());
+            std::ranges::for_each(cluster.locations, [out](const auto &location) {
+                std::println(out, "  {}:{} {}", location.filename, location.line, location.qualified_name);
+            });
+        });
+    }
+
+    if (options.GetCloneMinTokens() > 0) {
+        const auto clone_pairs = analyzer::clones::FindClones(
+            functions, {.min_tokens = options.GetCloneMinTokens()}, options.GetParseJobs());
+        auto location = [](const analyzer::function::Function &function) {
+            return std::format("{}:{} {}", function.filename, function.span ? function.span->start.line + 1 : 0,
+                               QualifiedName(function));
+        };
+        std::println(out);
+        std::println(out, "Clones of at least {} tokens ({} pairs):", options.GetCloneMinTokens(), clone_pairs.size());
+        std::ranges::for_each(clone_pairs, [&](const auto &pair) {
+            std::println(out, "  {} ~ {}: {} tokens, {:.0f}%", location(*functions[pair.first]),
+                         location(*functions[pair.second]), pair.shared_tokens, pair.similarity * 100);
+        });
+    }
+
+    if (!options.GetHistoryStore().empty()) {
+        analyzer::history::HistoryStore store(options.GetHistoryStore());
+        const auto timestamp =
+            std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
+        const auto run = store.Append(analysis, timestamp.count());
+        std::println(out);
+        std::println(out, "Recorded run {} in {}", run, options.GetHistoryStore());
+    }
     return 0;
 }
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    analyzer::cmd::ProgramOptions options;
+    if (!options.Parse(argc, argv))
+        return 1;
+
+    if (!options.GetConnect().empty())
+        return analyzer::server::RunClient(options.GetConnect(), options.GetForwardedArgs());
+
+    analyzer::metric::MetricExtractor metric_extractor;
+    FunctionMetrics::Register(metric_extractor, [](std::string_view) { return true; });
+    analyzer::metric::ResultCache result_cache;
+    metric_extractor.result_cache = &result_cache;
+
+    if (options.GetServe().empty())
+        return Run(options, metric_extractor, result_cache, stdout);
+
+    analyzer::server::Server server(options.GetServe(), [&](const std::vector<std::string> &args, std::FILE *out) {
+        std::vector<char *> argv_request{argv[0]};
+        for (const auto &arg : args) {
+            argv_request.push_back(const_cast<char *>(arg.c_str()));
+        }
+        std::ostringstream messages;
+        analyzer::cmd::ProgramOptions request;
+        if (!request.Parse(static_cast<int>(argv_request.size()), argv_request.data(), messages, messages)) {
+            std::fputs(messages.str().c_str(), out);
+            return 1;
+        }
+        // Результаты кэша остаются прогретыми, а дубликаты и статистика считаются заново для каждого запроса.
+        result_cache.BeginAnalysis();
+        return Run(request, metric_extractor, result_cache, out);
+    });
+    server.ServeForever();
+}
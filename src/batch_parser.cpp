@@ -0,0 +1,167 @@
+#include "batch_parser.hpp"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "file.hpp"
+#include "pipe.hpp"
+
+namespace analyzer::file {
+
+namespace rs = std::ranges;
+
+namespace {
+// Временный файл со списком путей для `tree-sitter parse --paths`, удаляется вместе с объектом.
+struct PathsFile {
+    explicit PathsFile(std::span<const std::string> filenames) {
+        std::string pattern = (std::filesystem::temp_directory_path() / "analyzer-paths-XXXXXX").string();
+        int fd = mkstemp(pattern.data());
+        if (fd == -1) {
+            throw std::runtime_error("Failed to create paths file: " + std::string(std::strerror(errno)));
+        }
+        close(fd);
+        path = pattern;
+
+        std::ofstream out(path);
+        for (const auto &filename : filenames) {
+            out << filename << '\n';
+        }
+    }
+    ~PathsFile() { std::filesystem::remove(path); }
+    PathsFile(const PathsFile &) = delete;
+    PathsFile &operator=(const PathsFile &) = delete;
+
+    std::string path;
+};
+}  // namespace
+
+BatchParser::BatchParser(size_t batch_size, size_t jobs)
+    : batch_size{std::max<size_t>(batch_size, 1)}, jobs{std::max<size_t>(jobs, 1)} {}
+
+std::vector<std::string_view> BatchParser::SplitTrees(std::string_view output) {
+    std::vector<std::string_view> trees;
+    size_t depth = 0;
+    size_t tree_start = 0;
+    bool in_quotes = false;
+    for (size_t pos = 0; pos < output.size(); ++pos) {
+        // Скобки внутри кавычек (например, `(MISSING ")")`) не влияют на вложенность, а экранированный
+        // символ (`\"`) не закрывает кавычки.
+        if (in_quotes && output[pos] == '\\') {
+            ++pos;
+        } else if (output[pos] == '"' && depth > 0) {
+            in_quotes = !in_quotes;
+        } else if (in_quotes) {
+            continue;
+        } else if (output[pos] == '(') {
+            // Корень дерева всегда в начале строки; скобки в строке сводки файла, например
+            // `a.py\tParse: 0.1 ms\t(ERROR [1, 0] - [1, 3])`, деревом не считаются.
+            if (depth == 0) {
+                if (pos > 0 && output[pos - 1] != '\n')
+                    continue;
+                tree_start = pos;
+            }
+            depth++;
+        } else if (output[pos] == ')' && depth > 0) {
+            depth--;
+            if (depth == 0)
+                trees.push_back(output.substr(tree_start, pos + 1 - tree_start));
+        }
+    }
+    return trees;
+}
+
+void BatchParser::ParseBatch(std::span<const std::string> filenames, std::string &output,
+                             std::span<std::optional<std::string_view>> asts) const {
+    PathsFile paths(filenames);
+
+    std::string full_cmd = File::command_prefix + "--paths " + paths.path;
+    int status = RunCommand(full_cmd, output);
+    if (status == -1)
+        return;
+    // Ненулевой код возврата tree-sitter выдаёт и для файлов с синтаксическими ошибками,
+    // поэтому пакет принимается, если число деревьев совпадает с числом файлов.
+    if (WIFEXITED(status)) {
+        auto trees = SplitTrees(output);
+        if (trees.size() == filenames.size()) {
+            rs::copy(trees, asts.begin());
+            return;
+        }
+    }
+    if (filenames.size() == 1)
+        return;
+
+    // Какой файл сбил вывод, неизвестно, поэтому пакет делится пополам, пока сбойный файл не останется
+    // один: по одному затем разбираются только такие файлы, а не весь пакет.
+    const size_t half = filenames.size() / 2;
+    std::array<std::string, 2> halves;
+    ParseBatch(filenames.first(half), halves[0], asts.first(half));
+    ParseBatch(filenames.subspan(half), halves[1], asts.subspan(half));
+
+    // Деревья половин переносятся в общий буфер пакета с тем же смещением.
+    output = halves[0] + halves[1];
+    for (size_t i = 0; i < asts.size(); ++i) {
+        if (!asts[i])
+            continue;
+        const std::string &source = halves[i < half ? 0 : 1];
+        const size_t offset = static_cast<size_t>(asts[i]->data() - source.data()) + (i < half ? 0 : halves[0].size());
+        asts[i] = std::string_view(output).substr(offset, asts[i]->size());
+    }
+}
+
+void BatchParser::ShareBatchTime(std::chrono::steady_clock::duration elapsed,
+                                 std::span<const std::optional<std::string_view>> asts,
+                                 std::span<std::chrono::steady_clock::duration> parse_times) {
+    size_t total_bytes = 0;
+    for (const auto &ast : asts)
+        total_bytes += ast ? ast->size() : 0;
+    for (size_t i = 0; i < asts.size(); ++i) {
+        const double share = asts[i] && total_bytes > 0 ? static_cast<double>(asts[i]->size()) / total_bytes : 0.0;
+        parse_times[i] = std::chrono::duration_cast<std::chrono::steady_clock::duration>(elapsed * share);
+    }
+}
+
+BatchParser::ParsedAsts BatchParser::Parse(const std::vector<std::string> &filenames) const {
+    ParsedAsts parsed;
+    const size_t batches_count = (filenames.size() + batch_size - 1) / batch_size;
+    // Буферы создаются заранее: потоки пишут каждый в свой, а string_view на них остаются валидными.
+    parsed.outputs.resize(batches_count);
+    parsed.asts.resize(filenames.size());
+    parsed.parse_times.resize(filenames.size());
+
+    for (size_t first_batch = 0; first_batch < batches_count; first_batch += jobs) {
+        // Одновременно запускается не более `jobs` процессов tree-sitter.
+        std::vector<std::future<void>> running;
+        for (size_t batch = first_batch; batch < std::min(batches_count, first_batch + jobs); ++batch) {
+            const size_t offset = batch * batch_size;
+            const size_t count = std::min(batch_size, filenames.size() - offset);
+            running.push_back(std::async(std::launch::async, [this, &filenames, &parsed, batch, offset, count] {
+                const auto started = std::chrono::steady_clock::now();
+                const auto asts = std::span(parsed.asts).subspan(offset, count);
+                ParseBatch(std::span(filenames).subspan(offset, count), parsed.outputs[batch], asts);
+                ShareBatchTime(std::chrono::steady_clock::now() - started, asts,
+                               std::span(parsed.parse_times).subspan(offset, count));
+            }));
+        }
+        for (auto &batch : running) {
+            batch.get();
+        }
+    }
+    return parsed;
+}
+
+}  // namespace analyzer::file
@@ -0,0 +1,72 @@
+// Микробенчмарк метрик сложности. Сравнивает цикломатическую сложность отдельно, три метрики
+// сложности на общей сводке и три независимых прохода по AST (как было бы без общей сводки).
+#include <chrono>
+#include <cstddef>
+#include <print>
+#include <string>
+#include <string_view>
+
+#include "function.hpp"
+#include "metric_impl/cognitive_complexity.hpp"
+#include "metric_impl/control_flow.hpp"
+#include "metric_impl/cyclomatic_complexity.hpp"
+#include "metric_impl/nesting_depth.hpp"
+
+namespace {
+constexpr size_t kStatements = 2'000;
+constexpr size_t kRepetitions = 200;
+
+using namespace analyzer::metric::metric_impl;
+
+// Тело из kStatements конструкций вида `if: for: if:` с вложенными узлами-выражениями.
+std::string MakeAst() {
+    std::string ast = "(function_definition [0, 0] - [" + std::to_string(kStatements * 3) + ", 0]\n";
+    ast += "  name: (identifier [0, 4] - [0, 5])\n  body: (block [1, 4] - [1, 4]\n";
+    for (size_t i = 0; i < kStatements; ++i) {
+        const std::string row = std::to_string(i * 3 + 1);
+        ast += "    (if_statement [" + row + ", 4] - [" + row + ", 40] condition: (identifier [" + row + ", 7] - [" +
+               row + ", 8])\n      consequence: (block [" + row + ", 8] - [" + row +
+               ", 40] (for_statement [" + row + ", 8] - [" + row + ", 40] left: (identifier [" + row +
+               ", 12] - [" + row + ", 13]) body: (block [" + row + ", 16] - [" + row + ", 40] (if_statement [" +
+               row + ", 16] - [" + row + ", 40] consequence: (pass_statement [" + row + ", 30] - [" + row +
+               ", 34]))))))\n";
+    }
+    ast += "))";
+    return ast;
+}
+
+template <typename Calculate>
+void Run(std::string_view name, analyzer::function::Function &function, Calculate &&calculate) {
+    long long checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kRepetitions; ++i) {
+        function.control_flow = {};  // Каждое повторение начинается без посчитанной сводки.
+        checksum += calculate(function);
+    }
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    std::println("{:<16} {:10.2f} us/function (checksum {})", name, elapsed.count() / kRepetitions, checksum);
+}
+}  // namespace
+
+int main() {
+    analyzer::function::Function function{.filename = "bench.py",
+                                          .class_name = std::nullopt,
+                                          .name = "f",
+                                          .ast = std::pmr::string(MakeAst()),
+                                          .language = &analyzer::language::Python()};
+    const CyclomaticComplexityMetric cyclomatic;
+    const CognitiveComplexityMetric cognitive;
+    const MaxNestingDepthMetric nesting;
+
+    Run("cyclomatic", function, [&](const auto &f) { return cyclomatic.Calculate(f).value.AsInteger(); });
+    Run("three metrics", function, [&](const auto &f) {
+        return cyclomatic.Calculate(f).value.AsInteger() + cognitive.Calculate(f).value.AsInteger() +
+               nesting.Calculate(f).value.AsInteger();
+    });
+    Run("three walks", function, [](const auto &f) {
+        long long total = 0;
+        for (int walk = 0; walk < 3; ++walk)
+            total += SummarizeControlFlow(f.ast, *f.language).cognitive_complexity;
+        return total;
+    });
+}
@@ -0,0 +1,61 @@
+// Микробенчмарк разбора координат "[row, col] - [row, col]" из AST.
+// Сравнивает прежний способ (find + substr + ToInt) с sexpr::DecodeSpan.
+#include <chrono>
+#include <cstddef>
+#include <print>
+#include <string>
+#include <string_view>
+
+#include "sexpr.hpp"
+#include "utils.hpp"
+
+namespace {
+constexpr size_t kNodes = 100'000;
+constexpr size_t kRepetitions = 20;
+
+std::string MakeAst() {
+    std::string ast;
+    for (size_t i = 0; i < kNodes; ++i) {
+        ast += "(expression_statement [" + std::to_string(i) + ", 4] - [" + std::to_string(i) + ", 27])\n";
+    }
+    return ast;
+}
+
+// Так координаты разбирались до появления DecodeSpan: подстрока на каждое число.
+size_t LegacyDecode(const std::string &ast) {
+    size_t checksum = 0;
+    for (size_t pos = ast.find('['); pos != std::string::npos; pos = ast.find('[', pos)) {
+        size_t comma = ast.find(',', pos);
+        size_t close = ast.find(']', comma);
+        checksum += ToInt(ast.substr(pos + 1, comma - pos - 1)) + ToInt(ast.substr(comma + 2, close - comma - 2));
+        pos = close;
+    }
+    return checksum;
+}
+
+size_t DecodeSpans(std::string_view ast) {
+    size_t checksum = 0;
+    size_t pos = 0;
+    while (auto span = analyzer::sexpr::DecodeSpan(ast, pos)) {
+        checksum += span->start.line + span->start.col + span->end.line + span->end.col;
+    }
+    return checksum;
+}
+
+template <typename Decode>
+void Run(std::string_view name, Decode &&decode) {
+    size_t checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kRepetitions; ++i) {
+        checksum += decode();
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    std::println("{:<12} {:8.2f} ns/span (checksum {})", name, elapsed.count() / (kNodes * kRepetitions), checksum);
+}
+}  // namespace
+
+int main() {
+    const std::string ast = MakeAst();
+    Run("legacy", [&] { return LegacyDecode(ast); });
+    Run("DecodeSpan", [&] { return DecodeSpans(ast); });
+}
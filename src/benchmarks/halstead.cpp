@@ -0,0 +1,112 @@
+// Микробенчмарк метрик Холстеда. Сравнивает время прежнего набора метрик функции с тем же набором
+// вместе с метриками Холстеда и индексом сопровождаемости, которые читают каждую лексему функции.
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <print>
+#include <string>
+#include <string_view>
+
+#include "function.hpp"
+#include "metric.hpp"
+#include "metric_impl/metrics.hpp"
+
+namespace {
+constexpr size_t kStatements = 2'000;
+constexpr size_t kRepetitions = 50;
+constexpr size_t kRounds = 10;
+
+using namespace analyzer::metric::metric_impl;
+
+std::string Span(size_t row, size_t start, size_t end) {
+    return "[" + std::to_string(row) + ", " + std::to_string(start) + "] - [" + std::to_string(row) + ", " +
+           std::to_string(end) + "]";
+}
+
+// Тело из kStatements присваиваний `xI = aJ + b * I` вместе с AST, координаты которого указывают в исходник.
+analyzer::function::Function MakeFunction() {
+    std::string source = "def f(b):";
+    std::string body;
+    for (size_t i = 0; i < kStatements; ++i) {
+        const size_t row = i + 1;
+        const std::string target = "x" + std::to_string(i);
+        const std::string operand = "a" + std::to_string(i % 7);
+        const std::string number = std::to_string(i);
+        const std::string line = "    " + target + " = " + operand + " + b * " + number;
+        source += "\n" + line;
+
+        const size_t sum = 4 + target.size() + 3;
+        const size_t product = sum + operand.size() + 3;
+        const size_t literal = product + 4;
+        body += "\n    (expression_statement " + Span(row, 4, line.size()) + " (assignment " +
+                Span(row, 4, line.size()) + " left: (identifier " + Span(row, 4, 4 + target.size()) +
+                ") right: (binary_operator " + Span(row, sum, line.size()) + " left: (identifier " +
+                Span(row, sum, sum + operand.size()) + ") right: (binary_operator " +
+                Span(row, product, line.size()) + " left: (identifier " + Span(row, product, product + 1) +
+                ") right: (integer " + Span(row, literal, line.size()) + ")))))";
+    }
+    const size_t last_column = source.size() - source.rfind('\n') - 1;
+    const std::string ast = "(function_definition [0, 0] - [" + std::to_string(kStatements) + ", " +
+                            std::to_string(last_column) + "]\n  name: (identifier [0, 4] - [0, 5])\n" +
+                            "  parameters: (parameters [0, 5] - [0, 8] (identifier [0, 6] - [0, 7]))\n" +
+                            "  body: (block [1, 4] - [" + std::to_string(kStatements) + ", " +
+                            std::to_string(last_column) + "]" + body + "))";
+    return {.filename = "bench.py",
+            .class_name = std::nullopt,
+            .name = "f",
+            .ast = std::pmr::string(ast),
+            .language = &analyzer::language::Python(),
+            .span = std::nullopt,
+            .source = std::pmr::string(source)};
+}
+
+// Время одного прогона набора метрик по функции в микросекундах.
+double Measure(const analyzer::metric::MetricExtractor &extractor, analyzer::function::Function &function) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kRepetitions; ++i) {
+        // Каждое повторение начинается без посчитанных сводок.
+        function.control_flow = {};
+        function.tokens = {};
+        if (extractor.Get(function).empty())
+            std::abort();
+    }
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / kRepetitions;
+}
+
+void RegisterBaseMetrics(analyzer::metric::MetricExtractor &extractor) {
+    extractor.RegisterMetric(std::make_unique<CyclomaticComplexityMetric>());
+    extractor.RegisterMetric(std::make_unique<CognitiveComplexityMetric>());
+    extractor.RegisterMetric(std::make_unique<MaxNestingDepthMetric>());
+    extractor.RegisterMetric(std::make_unique<CodeLinesCountMetric>());
+    extractor.RegisterMetric(std::make_unique<NamingStyleMetric>());
+    extractor.RegisterMetric(std::make_unique<CountParametersMetric>());
+}
+}  // namespace
+
+int main() {
+    auto function = MakeFunction();
+
+    analyzer::metric::MetricExtractor base;
+    RegisterBaseMetrics(base);
+    analyzer::metric::MetricExtractor with_halstead;
+    RegisterBaseMetrics(with_halstead);
+    with_halstead.RegisterMetric(std::make_unique<HalsteadVolumeMetric>());
+    with_halstead.RegisterMetric(std::make_unique<HalsteadDifficultyMetric>());
+    with_halstead.RegisterMetric(std::make_unique<HalsteadEffortMetric>());
+    with_halstead.RegisterMetric(std::make_unique<MaintainabilityIndexMetric>());
+
+    // Наборы чередуются, и берётся лучшее время каждого: так меньше сказываются помехи от других процессов.
+    double before = std::numeric_limits<double>::max();
+    double after = std::numeric_limits<double>::max();
+    for (size_t round = 0; round < kRounds; ++round) {
+        before = std::min(before, Measure(base, function));
+        after = std::min(after, Measure(with_halstead, function));
+    }
+    std::println("{:<16} {:10.2f} us/function", "base metrics", before);
+    std::println("{:<16} {:10.2f} us/function", "with Halstead", after);
+    std::println("overhead: {:+.1f}%", (after / before - 1) * 100);
+}
@@ -0,0 +1,76 @@
+// Бенчмарк хранилища истории: запись запуска и запрос тренда одной метрики по всем запускам
+// для репозитория из kFunctions функций. Каждый запуск занимает kFunctions * 4 байта на метрику.
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <print>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "function.hpp"
+#include "history.hpp"
+#include "metric.hpp"
+
+namespace {
+constexpr size_t kFunctions = 100'000;
+constexpr size_t kRuns = 1'000;
+
+using Analysis = std::vector<std::pair<analyzer::function::Function, analyzer::metric::MetricResults>>;
+
+Analysis MakeAnalysis() {
+    Analysis analysis;
+    analysis.reserve(kFunctions);
+    for (size_t i = 0; i < kFunctions; ++i) {
+        const std::string filename = "src/module" + std::to_string(i / 50) + ".py";
+        analyzer::function::Function function{.filename = std::pmr::string(filename),
+                                              .class_name = std::nullopt,
+                                              .name = std::pmr::string("function" + std::to_string(i))};
+        analyzer::metric::MetricResults results;
+        results.push_back({.metric_name = "Cyclomatic Complexity", .value = static_cast<int>(i % 17)});
+        results.push_back({.metric_name = "Halstead Volume", .value = static_cast<double>(i % 1000)});
+        analysis.emplace_back(std::move(function), std::move(results));
+    }
+    return analysis;
+}
+
+double Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+}  // namespace
+
+int main() {
+    const auto directory = std::filesystem::temp_directory_path() / "analyzer_history_benchmark";
+    std::filesystem::remove_all(directory);
+    auto analysis = MakeAnalysis();
+
+    double slowest_append = 0;
+    auto start = std::chrono::steady_clock::now();
+    {
+        analyzer::history::HistoryStore store(directory);
+        for (size_t run = 0; run < kRuns; ++run) {
+            // Метрика каждой сотой функции меняется от запуска к запуску.
+            for (size_t i = run % 100; i < kFunctions; i += 100)
+                analysis[i].second[0].value = static_cast<int>(run % 17);
+            const auto append_start = std::chrono::steady_clock::now();
+            store.Append(analysis, static_cast<std::int64_t>(run));
+            slowest_append = std::max(slowest_append, Seconds(append_start));
+        }
+    }
+    const double total_append = Seconds(start);
+
+    start = std::chrono::steady_clock::now();
+    const analyzer::history::HistoryStore store(directory);
+    const auto trends = store.Trends("Cyclomatic Complexity");
+    const double query = Seconds(start);
+    if (trends.size() != kFunctions)
+        std::abort();
+
+    std::println("{} functions, {} runs", kFunctions, kRuns);
+    std::println("append: {:.1f} ms/run on average, {:.1f} ms slowest", total_append / kRuns * 1000,
+                 slowest_append * 1000);
+    std::println("open + trend query over all runs: {:.1f} ms", query * 1000);
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,63 @@
+#include "budget.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <ranges>
+#include <string>
+
+namespace analyzer::file {
+
+namespace rs = std::ranges;
+
+std::string_view ToString(SkipReason reason) {
+    switch (reason) {
+    case SkipReason::Timeout:
+        return "timeout";
+    case SkipReason::AstSize:
+        return "ast_size";
+    case SkipReason::FunctionCount:
+        return "function_count";
+    }
+    return "unknown";
+}
+
+std::string FormatWarning(const SkippedFile &skipped) {
+    return "warning: file skipped file=\"" + skipped.filename + "\" reason=" + std::string(ToString(skipped.reason)) +
+           " limit=" + std::to_string(skipped.limit) + " actual=" + std::to_string(skipped.actual);
+}
+
+std::optional<SkippedFile> Budget::CheckAstSize(const std::string &filename, size_t ast_bytes) const {
+    if (max_ast_bytes == 0 || ast_bytes <= max_ast_bytes)
+        return std::nullopt;
+    return SkippedFile{
+        .filename = filename, .reason = SkipReason::AstSize, .limit = max_ast_bytes, .actual = ast_bytes};
+}
+
+std::optional<SkippedFile> Budget::CheckFile(const File &file) const {
+    if (auto skipped = CheckAstSize(file.name, file.ast.size()))
+        return skipped;
+    if (max_functions == 0)
+        return std::nullopt;
+
+    // Считаются все функции, включая вложенные: индекс уже построен, повторного прохода по AST нет.
+    const auto functions_count = static_cast<size_t>(rs::count_if(
+        file.structure, [](const auto &node) { return node.category == language::NodeCategory::Function; }));
+    if (functions_count <= max_functions)
+        return std::nullopt;
+    return SkippedFile{
+        .filename = file.name, .reason = SkipReason::FunctionCount, .limit = max_functions, .actual = functions_count};
+}
+
+std::optional<SkippedFile> Budget::CheckDeadline(const std::string &filename, Clock::time_point started) const {
+    if (timeout.count() == 0)
+        return std::nullopt;
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - started);
+    if (elapsed <= timeout)
+        return std::nullopt;
+    return SkippedFile{.filename = filename,
+                       .reason = SkipReason::Timeout,
+                       .limit = static_cast<size_t>(timeout.count()),
+                       .actual = static_cast<size_t>(elapsed.count())};
+}
+
+}  // namespace analyzer::file
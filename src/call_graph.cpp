@@ -0,0 +1,337 @@
+#include "call_graph.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <thread>
+#include <utility>
+
+#include "sexpr.hpp"
+
+namespace analyzer::call_graph {
+
+namespace {
+constexpr std::string_view kFunctionField = "function:";
+
+// Идентификаторы имён, но не типов: type_identifier в шаблонных аргументах `foo<T>()` именем не считается.
+bool IsNameKind(std::string_view kind) { return kind.ends_with("identifier") && !kind.starts_with("type"); }
+
+// Последний компонент текста перед именем: "b" из "a.b." или "ns" из "outer::ns::".
+std::string_view LastComponent(std::string_view prefix) {
+    constexpr std::string_view kSeparators = ".:->? \t\r\n";
+    const size_t end = prefix.find_last_not_of(kSeparators);
+    if (end == std::string_view::npos)
+        return {};
+    prefix = prefix.substr(0, end + 1);
+    const size_t begin = prefix.find_last_of(kSeparators);
+    return begin == std::string_view::npos ? prefix : prefix.substr(begin + 1);
+}
+
+/**
+ * Собирает места вызовов за один проход по AST. Имя ищет только самый внутренний открытый вызов,
+ * поэтому аргументы вложенных вызовов не подменяют имя внешнего.
+ */
+class CallSiteCollector {
+public:
+    CallSiteCollector(const function::Function &f, std::vector<CallSite> &callees)
+        : language{*f.language}, source{f.source}, callees{callees} {
+        line_starts.push_back(0);
+        for (size_t pos = source.find('\n'); pos != std::string_view::npos; pos = source.find('\n', pos + 1))
+            line_starts.push_back(pos + 1);
+    }
+
+    void OnOpen(const sexpr::Node &node) {
+        if (node.depth == 0)
+            origin = node.span.start;
+        if (!pending.empty()) {
+            Call &call = pending.back();
+            if (call.field_depth == kNone && !call.field_closed && node.depth == call.depth + 1 &&
+                node.field == kFunctionField) {
+                call.field_depth = node.depth;
+                call.field_start = node.span.start;
+            }
+            if (call.field_depth != kNone && IsNameKind(node.kind))
+                call.name = node.span;
+        }
+        if (language.Categorize(node.kind) == language::NodeCategory::Call)
+            pending.push_back({.depth = node.depth});
+    }
+
+    void OnClose(size_t, size_t depth) {
+        if (pending.empty())
+            return;
+        Call &call = pending.back();
+        if (call.field_depth == depth) {
+            call.field_depth = kNone;
+            call.field_closed = true;
+        } else if (call.depth == depth) {
+            if (call.name)
+                Emit(call.field_start, *call.name);
+            pending.pop_back();
+        }
+    }
+
+private:
+    static constexpr size_t kNone = static_cast<size_t>(-1);
+
+    struct Call {
+        size_t depth;
+        size_t field_depth = kNone;  // Глубина открытого поля "function:".
+        bool field_closed = false;
+        sexpr::Position field_start = {};
+        std::optional<sexpr::Span> name = std::nullopt;
+    };
+
+    // Смещение позиции AST в f.source, который начинается с позиции корня.
+    size_t Offset(const sexpr::Position &position) const {
+        if (position.line < origin.line || position.line - origin.line >= line_starts.size())
+            return std::string_view::npos;
+        if (position.line == origin.line)
+            return position.col >= origin.col ? position.col - origin.col : std::string_view::npos;
+        return line_starts[position.line - origin.line] + position.col;
+    }
+
+    void Emit(const sexpr::Position &field_start, const sexpr::Span &span) {
+        const size_t field = Offset(field_start);
+        const size_t begin = Offset(span.start);
+        const size_t end = Offset(span.end);
+        if (begin >= end || end > source.size())
+            return;
+        const std::string_view receiver =
+            field < begin ? LastComponent(source.substr(field, begin - field)) : std::string_view{};
+        callees.push_back({.name = source.substr(begin, end - begin), .receiver = receiver});
+    }
+
+    const language::Language &language;
+    std::string_view source;
+    std::vector<CallSite> &callees;
+    std::vector<size_t> line_starts;
+    sexpr::Position origin;
+    std::vector<Call> pending;
+};
+
+std::string ClassKey(std::string_view filename, std::string_view class_name) {
+    std::string key(filename);
+    key += '\n';
+    key += class_name;
+    return key;
+}
+
+bool Contains(const std::vector<std::uint32_t> &ids, std::uint32_t id) { return rs::find(ids, id) != ids.end(); }
+
+struct Edge {
+    FunctionId caller;
+    FunctionId callee;
+};
+
+// Заполняет CSR по рёбрам, разложенным по частичным графам: offsets — префиксные суммы степеней.
+template <typename From, typename To>
+void FillCsr(const std::vector<std::vector<Edge>> &partials, size_t count, From from, To to,
+             std::vector<std::uint32_t> &offsets, std::vector<FunctionId> &targets) {
+    offsets.assign(count + 1, 0);
+    for (const auto &edges : partials) {
+        for (const Edge &edge : edges)
+            offsets[from(edge) + 1]++;
+    }
+    for (size_t id = 0; id < count; ++id)
+        offsets[id + 1] += offsets[id];
+    targets.resize(offsets[count]);
+    std::vector<std::uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (const auto &edges : partials) {
+        for (const Edge &edge : edges)
+            targets[cursor[from(edge)]++] = to(edge);
+    }
+}
+}  // namespace
+
+std::vector<CallSite> ExtractCallSites(const function::Function &f) {
+    std::vector<CallSite> sites;
+    if (f.source.empty())
+        return sites;
+    CallSiteCollector collector(f, sites);
+    sexpr::Tokenizer tokenizer(collector);
+    tokenizer.Feed(f.ast);
+    tokenizer.Finish();
+    return sites;
+}
+
+std::vector<std::string_view> ExtractCallees(const function::Function &f) {
+    std::vector<std::string_view> callees;
+    for (const CallSite &site : ExtractCallSites(f))
+        callees.push_back(site.name);
+    return callees;
+}
+
+std::string CallGraph::Key(const function::Function &f) {
+    std::string key = ClassKey(f.filename, f.class_name ? std::string_view(*f.class_name) : "");
+    key += '\n';
+    key += f.name;
+    key += '\n';
+    key += std::to_string(f.span ? f.span->start.line : 0);
+    return key;
+}
+
+CallGraph CallGraph::Build(std::span<const function::Function *const> functions, size_t jobs) {
+    CallGraph graph;
+    const size_t count = functions.size();
+    graph.class_of.assign(count, kNoClass);
+
+    // Функции по файлам, по простому имени и по имени класса; ключи указывают в строки самих функций.
+    // Модуль — имя файла без каталога и расширения, как его импортируют: `utils` для src/utils.py.
+    std::unordered_map<std::string_view, std::uint32_t> file_ids;
+    std::vector<std::vector<FunctionId>> files;
+    std::vector<std::uint32_t> file_of(count);
+    std::unordered_map<std::string_view, std::vector<FunctionId>> by_name;
+    std::unordered_map<std::string_view, std::vector<std::uint32_t>> classes_by_name;
+    std::unordered_map<std::string, std::vector<std::uint32_t>> files_by_module;
+    for (FunctionId id = 0; id < count; ++id) {
+        const function::Function &f = *functions[id];
+        graph.ids.emplace(Key(f), id);
+        by_name[f.name].push_back(id);
+
+        const auto [file, added] = file_ids.emplace(f.filename, static_cast<std::uint32_t>(files.size()));
+        if (added) {
+            files.emplace_back();
+            files_by_module[std::filesystem::path(f.filename).stem().string()].push_back(file->second);
+        }
+        files[file->second].push_back(id);
+        file_of[id] = file->second;
+
+        if (f.class_name) {
+            const auto [it, inserted] = graph.class_keys.emplace(
+                ClassKey(f.filename, *f.class_name), static_cast<std::uint32_t>(graph.class_members.size()));
+            if (inserted) {
+                graph.class_members.emplace_back();
+                classes_by_name[*f.class_name].push_back(it->second);
+            }
+            graph.class_members[it->second].push_back(id);
+            graph.class_of[id] = it->second;
+        }
+    }
+
+    // Частичный граф файла: рёбра его функций, без повторов внутри каждой вызывающей функции.
+    std::vector<std::vector<Edge>> partials(files.size());
+    std::atomic<size_t> next_file = 0;
+    std::atomic<size_t> unresolved = 0;
+    auto resolve_files = [&] {
+        std::vector<FunctionId> targets;
+        size_t file_unresolved = 0;
+        for (size_t file; (file = next_file.fetch_add(1, std::memory_order_relaxed)) < files.size();) {
+            for (FunctionId caller : files[file]) {
+                targets.clear();
+                for (const CallSite &site : ExtractCallSites(*functions[caller])) {
+                    const auto it = by_name.find(site.name);
+                    if (it == by_name.end())
+                        continue;
+                    const auto &candidates = it->second;
+                    // Добавляет подходящие кандидаты; false, если не подошёл ни один (рекурсия тоже подходит).
+                    auto link = [&](auto matches) {
+                        bool found = false;
+                        for (FunctionId id : candidates) {
+                            if (!matches(id))
+                                continue;
+                            found = true;
+                            if (id != caller)
+                                targets.push_back(id);
+                        }
+                        return found;
+                    };
+
+                    const std::uint32_t caller_class = graph.class_of[caller];
+                    if (caller_class != kNoClass &&
+                        (site.receiver == "self" || site.receiver == "this" || site.receiver == "cls")) {
+                        // Метода нет в классе — он унаследован или добавлен динамически, чужой одноимённый
+                        // метод тут ни при чём.
+                        if (!link([&](FunctionId id) { return graph.class_of[id] == caller_class; }))
+                            ++file_unresolved;
+                        continue;
+                    }
+                    if (!site.receiver.empty()) {
+                        const auto classes = classes_by_name.find(site.receiver);
+                        if (classes != classes_by_name.end()) {
+                            const auto &ids = classes->second;
+                            // Одноимённые классы: сначала класс из файла вызывающей функции.
+                            const bool in_file = link([&](FunctionId id) {
+                                return file_of[id] == file && Contains(ids, graph.class_of[id]);
+                            });
+                            if (in_file || link([&](FunctionId id) { return Contains(ids, graph.class_of[id]); }))
+                                continue;
+                        }
+                        const auto modules = files_by_module.find(std::string(site.receiver));
+                        if (modules != files_by_module.end() &&
+                            link([&](FunctionId id) { return Contains(modules->second, file_of[id]); }))
+                            continue;
+                    }
+                    if (link([&](FunctionId id) { return file_of[id] == file; }))
+                        continue;
+                    if (candidates.size() == 1)
+                        link([](FunctionId) { return true; });
+                    else
+                        ++file_unresolved;
+                }
+                rs::sort(targets);
+                targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+                for (FunctionId callee : targets)
+                    partials[file].push_back({.caller = caller, .callee = callee});
+            }
+        }
+        unresolved.fetch_add(file_unresolved, std::memory_order_relaxed);
+    };
+    const size_t workers = std::clamp<size_t>(jobs, 1, std::max<size_t>(files.size(), 1));
+    if (workers == 1) {
+        resolve_files();
+    } else {
+        std::vector<std::jthread> threads;
+        threads.reserve(workers);
+        for (size_t i = 0; i < workers; ++i)
+            threads.emplace_back(resolve_files);
+    }
+
+    FillCsr(
+        partials, count, [](const Edge &edge) { return edge.caller; }, [](const Edge &edge) { return edge.callee; },
+        graph.callees_offsets, graph.callees);
+    FillCsr(
+        partials, count, [](const Edge &edge) { return edge.callee; }, [](const Edge &edge) { return edge.caller; },
+        graph.callers_offsets, graph.callers);
+    graph.unresolved_calls = unresolved.load();
+    return graph;
+}
+
+std::optional<FunctionId> CallGraph::Find(const function::Function &f) const {
+    const auto it = ids.find(Key(f));
+    if (it == ids.end())
+        return std::nullopt;
+    return it->second;
+}
+
+std::span<const FunctionId> CallGraph::Callees(FunctionId id) const {
+    return std::span(callees).subspan(callees_offsets[id], callees_offsets[id + 1] - callees_offsets[id]);
+}
+
+std::span<const FunctionId> CallGraph::Callers(FunctionId id) const {
+    return std::span(callers).subspan(callers_offsets[id], callers_offsets[id + 1] - callers_offsets[id]);
+}
+
+ClassCoupling CallGraph::ForClass(std::string_view filename, std::string_view class_name) const {
+    const auto it = class_keys.find(ClassKey(filename, class_name));
+    if (it == class_keys.end())
+        return {};
+    const std::uint32_t class_id = it->second;
+
+    // Различные функции вне класса по всем методам сразу: одна функция, вызывающая два метода, считается раз.
+    auto count_outside = [&](auto neighbours) {
+        std::vector<FunctionId> outside;
+        for (FunctionId member : class_members[class_id]) {
+            for (FunctionId id : neighbours(member)) {
+                if (class_of[id] != class_id)
+                    outside.push_back(id);
+            }
+        }
+        rs::sort(outside);
+        return static_cast<int>(std::unique(outside.begin(), outside.end()) - outside.begin());
+    };
+    return {.fan_in = count_outside([this](FunctionId id) { return Callers(id); }),
+            .fan_out = count_outside([this](FunctionId id) { return Callees(id); })};
+}
+
+}  // namespace analyzer::call_graph
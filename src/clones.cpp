@@ -0,0 +1,206 @@
+#include "clones.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+
+#include "metric_impl/tokens.hpp"
+
+namespace analyzer::clones {
+
+namespace {
+constexpr std::uint64_t kIdentifierHash = 0x9e3779b97f4a7c15;
+constexpr std::uint64_t kLiteralHash = 0xc2b2ae3d27d4eb4f;
+constexpr std::uint64_t kBase = 0x100000001b3;
+
+constexpr size_t kShardBits = 6;
+constexpr size_t kShards = size_t{1} << kShardBits;
+
+struct Posting {
+    std::uint64_t hash;
+    std::uint32_t function;
+    std::uint32_t position;
+};
+
+size_t ShardOf(std::uint64_t hash) { return static_cast<size_t>(hash >> (64 - kShardBits)); }
+
+std::uint64_t PairKey(std::uint32_t first, std::uint32_t second) {
+    return static_cast<std::uint64_t>(first) << 32 | second;
+}
+
+// Совпавшие позиции первой функции каждой пары; ключ — PairKey.
+using Matches = std::unordered_map<std::uint64_t, std::vector<std::uint32_t>>;
+
+// Выполняет work(task, worker) для задач 0..tasks - 1 в `jobs` потоках; worker — номер потока.
+template <typename Work>
+void RunParallel(size_t jobs, size_t tasks, Work work) {
+    std::atomic<size_t> next = 0;
+    auto run = [&](size_t worker) {
+        for (size_t task; (task = next.fetch_add(1, std::memory_order_relaxed)) < tasks;)
+            work(task, worker);
+    };
+    const size_t workers = std::clamp<size_t>(jobs, 1, std::max<size_t>(tasks, 1));
+    if (workers == 1) {
+        run(0);
+        return;
+    }
+    std::vector<std::jthread> threads;
+    threads.reserve(workers);
+    for (size_t worker = 0; worker < workers; ++worker)
+        threads.emplace_back(run, worker);
+}
+
+// Длина фрагментов по отсортированным позициям совпавших k-грамм: соседние не дальше окна — один фрагмент.
+size_t SharedTokens(const std::vector<std::uint32_t> &positions, const CloneOptions &options) {
+    size_t shared = 0;
+    size_t run_start = positions.front();
+    size_t previous = positions.front();
+    for (size_t position : positions) {
+        if (position - previous > options.window) {
+            shared += previous - run_start + options.gram_tokens;
+            run_start = position;
+        }
+        previous = position;
+    }
+    return shared + previous - run_start + options.gram_tokens;
+}
+}  // namespace
+
+std::vector<std::uint64_t> NormalizedTokenHashes(const function::Function &f) {
+    thread_local std::vector<metric::metric_impl::Token> tokens;
+    metric::metric_impl::Tokenize(f.source, *f.language, tokens);
+
+    std::vector<std::uint64_t> hashes;
+    hashes.reserve(tokens.size());
+    for (const auto &token : tokens) {
+        switch (token.kind) {
+        case metric::metric_impl::TokenKind::Identifier:
+            hashes.push_back(kIdentifierHash);
+            break;
+        case metric::metric_impl::TokenKind::Literal:
+            hashes.push_back(kLiteralHash);
+            break;
+        case metric::metric_impl::TokenKind::Operator:
+            hashes.push_back(std::hash<std::string_view>{}(token.text));
+            break;
+        }
+    }
+    return hashes;
+}
+
+std::vector<Fingerprint> Winnow(std::span<const std::uint64_t> tokens, size_t k, size_t window) {
+    std::vector<Fingerprint> fingerprints;
+    if (k == 0 || window == 0 || tokens.size() < k)
+        return fingerprints;
+
+    const size_t grams = tokens.size() - k + 1;
+    std::vector<std::uint64_t> hashes(grams);
+    std::uint64_t power = 1;  // kBase^(k - 1): вес лексемы, которая выходит из k-граммы.
+    std::uint64_t hash = 0;
+    for (size_t i = 0; i < k; ++i) {
+        hash = hash * kBase + tokens[i];
+        if (i > 0)
+            power *= kBase;
+    }
+    hashes[0] = hash;
+    for (size_t i = 1; i < grams; ++i) {
+        hash = (hash - tokens[i - 1] * power) * kBase + tokens[i + k - 1];
+        hashes[i] = hash;
+    }
+
+    // Кандидаты в минимум текущего окна по возрастанию хэша; первый — минимум окна.
+    std::deque<size_t> candidates;
+    size_t last = grams;
+    for (size_t i = 0; i < grams; ++i) {
+        while (!candidates.empty() && hashes[candidates.back()] >= hashes[i])
+            candidates.pop_back();
+        candidates.push_back(i);
+        if (candidates.front() + window <= i)
+            candidates.pop_front();
+        // Последовательность короче окна даёт один отпечаток — минимум всех её k-грамм.
+        if ((i + 1 >= window || i + 1 == grams) && candidates.front() != last) {
+            last = candidates.front();
+            fingerprints.push_back({.hash = hashes[last], .position = static_cast<std::uint32_t>(last)});
+        }
+    }
+    return fingerprints;
+}
+
+std::vector<ClonePair> FindClones(std::span<const function::Function *const> functions,
+                                  const CloneOptions &options, size_t jobs) {
+    const size_t workers = std::clamp<size_t>(jobs, 1, std::max<size_t>(functions.size(), 1));
+
+    // Отпечатки каждого потока, уже разложенные по сегментам индекса.
+    std::vector<std::vector<std::vector<Posting>>> buckets(workers, std::vector<std::vector<Posting>>(kShards));
+    std::vector<std::uint32_t> token_counts(functions.size());
+    RunParallel(workers, functions.size(), [&](size_t function, size_t worker) {
+        const auto tokens = NormalizedTokenHashes(*functions[function]);
+        token_counts[function] = static_cast<std::uint32_t>(tokens.size());
+        for (const auto &fingerprint : Winnow(tokens, options.gram_tokens, options.window)) {
+            buckets[worker][ShardOf(fingerprint.hash)].push_back({.hash = fingerprint.hash,
+                                                                   .function = static_cast<std::uint32_t>(function),
+                                                                   .position = fingerprint.position});
+        }
+    });
+
+    std::vector<Matches> shard_matches(kShards);
+    RunParallel(workers, kShards, [&](size_t shard, size_t) {
+        std::vector<Posting> postings;
+        for (auto &worker_buckets : buckets) {
+            postings.insert(postings.end(), worker_buckets[shard].begin(), worker_buckets[shard].end());
+            worker_buckets[shard] = {};
+        }
+        rs::sort(postings, {}, [](const Posting &p) { return std::tie(p.hash, p.function, p.position); });
+
+        Matches &matches = shard_matches[shard];
+        for (size_t begin = 0, end = 0; begin < postings.size(); begin = end) {
+            while (end < postings.size() && postings[end].hash == postings[begin].hash)
+                end++;
+            if (end - begin > kMaxPostings)
+                continue;
+            // Постинги отсортированы по функции, поэтому в паре (i, j) функция i всегда с меньшим номером.
+            for (size_t i = begin; i < end; ++i) {
+                for (size_t j = i + 1; j < end; ++j) {
+                    if (postings[i].function != postings[j].function)
+                        matches[PairKey(postings[i].function, postings[j].function)].push_back(postings[i].position);
+                }
+            }
+        }
+    });
+
+    Matches matches = std::move(shard_matches.front());
+    for (auto &shard : shard_matches | rv::drop(1)) {
+        for (auto &[key, positions] : shard) {
+            auto &target = matches[key];
+            target.insert(target.end(), positions.begin(), positions.end());
+        }
+        shard = {};
+    }
+
+    std::vector<ClonePair> pairs;
+    for (auto &[key, positions] : matches) {
+        rs::sort(positions);
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+        const size_t shared = SharedTokens(positions, options);
+        if (shared < options.min_tokens)
+            continue;
+        const auto first = static_cast<std::uint32_t>(key >> 32);
+        const auto second = static_cast<std::uint32_t>(key);
+        const size_t shorter = std::min(token_counts[first], token_counts[second]);
+        pairs.push_back({.first = first,
+                         .second = second,
+                         .shared_tokens = shared,
+                         .similarity = std::min(1.0, static_cast<double>(shared) / std::max<size_t>(shorter, 1))});
+    }
+    rs::sort(pairs, [](const ClonePair &a, const ClonePair &b) {
+        return std::tie(b.shared_tokens, a.first, a.second) < std::tie(a.shared_tokens, b.first, b.second);
+    });
+    return pairs;
+}
+
+}  // namespace analyzer::clones
@@ -4,43 +4,129 @@
 #include <iostream>
 #include <print>
 #include <string>
+#include <string_view>
+#include <thread>
 
 #include <boost/program_options.hpp>
 
+#include "batch_parser.hpp"
+
 namespace analyzer::cmd {
 
 namespace po = boost::program_options;
 
 ProgramOptions::ProgramOptions() : desc_("Allowed options") {
     desc_.add_options()("help,h", "Display help message")(
-        "file,f", po::value<std::vector<std::string>>(&files_)->required()->multitoken(),
-        "List of files to process (required)");
+        "file,f", po::value<std::vector<std::string>>(&files_)->multitoken(),
+        "List of files to process (required unless --serve, --diff or --history is given)")(
+        "top,t", po::value<size_t>(&top_)->default_value(0),
+        "Report K functions with the largest metric values (0 disables the report)")(
+        "parse-batch-size", po::value<size_t>(&parse_batch_size_)->default_value(file::BatchParser::kDefaultBatchSize),
+        "Number of files passed to one tree-sitter process")(
+        "parse-jobs", po::value<size_t>(&parse_jobs_)->default_value(std::max(1u, std::thread::hardware_concurrency())),
+        "Number of tree-sitter processes running concurrently")(
+        "prefetch-depth", po::value<size_t>(&prefetch_depth_)->default_value(64),
+        "Number of files read and parsed ahead of analysis (0 reads files on demand)")(
+        "file-timeout-ms", po::value<size_t>(&file_timeout_ms_)->default_value(0),
+        "Skip a file whose parsing and analysis take longer than this (0 disables the limit)")(
+        "max-ast-bytes", po::value<size_t>(&max_ast_bytes_)->default_value(0),
+        "Skip a file whose AST is larger than this many bytes (0 disables the limit)")(
+        "max-functions", po::value<size_t>(&max_functions_)->default_value(0),
+        "Skip a file with more functions than this (0 disables the limit)")(
+        "duplicates", po::bool_switch(&report_duplicates_),
+        "Report groups of identical functions and the metric result cache hit rate")(
+        "clones", po::value<size_t>(&clone_min_tokens_)->default_value(0),
+        "Report pairs of functions sharing at least this many tokens up to renaming (0 disables the report)")(
+        "serve", po::value<std::string>(&serve_),
+        "Run as a daemon answering analysis requests on this Unix socket")(
+        "connect", po::value<std::string>(&connect_),
+        "Send the remaining options to the daemon listening on this Unix socket and print its report")(
+        "diff", po::value<std::string>(&diff_),
+        "Analyse only functions touched by this unified diff ('-' reads it from stdin)")(
+        "diff-base", po::value<std::string>(&diff_base_),
+        "Directory with the pre-change versions of the diffed files; enables before/after deltas")(
+        "history-store", po::value<std::string>(&history_store_),
+        "Directory of the metrics history; each analysis run is appended to it")(
+        "history", po::value<std::string>(&history_),
+        "Print trends and last-run regressions of this metric from --history-store instead of analysing files")(
+        "policy", po::value<std::string>(&policy_),
+        "Only check functions against the metric limits in this policy file; exits with 1 on violations")(
+        "fail-fast", po::bool_switch(&fail_fast_), "With --policy, stop analysing files at the first violation")(
+        "nested-functions", po::bool_switch(&nested_functions_),
+        "Also analyse functions nested in other functions, reported by qualified name (Outer.f.<locals>.inner)")(
+        "lambdas", po::bool_switch(&lambdas_), "Also analyse lambdas as functions named <lambda>")(
+        "sample-rate", po::value<double>(&sample_rate_)->default_value(0),
+        "Analyse only this fraction (0, 1] of the files and estimate repository-wide totals (0 analyses all)")(
+        "sample-files", po::value<size_t>(&sample_files_)->default_value(0),
+        "Analyse only this many randomly chosen files and estimate repository-wide totals (0 analyses all)")(
+        "sample-seed", po::value<std::uint64_t>(&sample_seed_)->default_value(1),
+        "Seed of the file sample; the same seed and files always give the same sample");
 }
 
 ProgramOptions::~ProgramOptions() = default;
 
-bool ProgramOptions::Parse(int argc, char *argv[]) {
+bool ProgramOptions::Parse(int argc, char *argv[], std::ostream &out, std::ostream &err) {
     try {
         po::variables_map vm;
         po::store(po::command_line_parser(argc, argv).options(desc_).run(), vm);
 
         if (vm.count("help")) {
-            desc_.print(std::cout);
+            desc_.print(out);
             return false;
         }
 
         po::notify(vm);
 
-        if (files_.empty()) {
-            std::cerr << "Error: At least one file must be specified\n";
-            desc_.print(std::cout);
+        // Клиент передаёт демону все аргументы, кроме адреса самого демона.
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            if (arg == "--connect")
+                ++i;
+            else if (!arg.starts_with("--connect="))
+                forwarded_args_.emplace_back(arg);
+        }
+
+        if (!history_.empty() && history_store_.empty()) {
+            err << "Error: --history requires --history-store\n";
+            desc_.print(out);
+            return false;
+        }
+
+        if (fail_fast_ && policy_.empty()) {
+            err << "Error: --fail-fast requires --policy\n";
+            desc_.print(out);
+            return false;
+        }
+
+        if (sample_rate_ < 0 || sample_rate_ > 1) {
+            err << "Error: --sample-rate must be in (0, 1]\n";
+            desc_.print(out);
+            return false;
+        }
+
+        if (sample_rate_ > 0 && sample_files_ > 0) {
+            err << "Error: --sample-rate and --sample-files are mutually exclusive\n";
+            desc_.print(out);
+            return false;
+        }
+
+        // Политика проверяет все функции, а история сравнивает запуски по одним и тем же функциям.
+        if (IsSampling() && (!policy_.empty() || !history_store_.empty())) {
+            err << "Error: sampling can't be combined with --policy or --history-store\n";
+            desc_.print(out);
+            return false;
+        }
+
+        if (files_.empty() && serve_.empty() && diff_.empty() && history_.empty()) {
+            err << "Error: At least one file must be specified\n";
+            desc_.print(out);
             return false;
         }
 
         return true;
     } catch (const std::exception &e) {
-        std::cerr << "Error parsing command line: " << e.what() << "\n";
-        desc_.print(std::cout);
+        err << "Error parsing command line: " << e.what() << "\n";
+        desc_.print(out);
         return false;
     }
 }
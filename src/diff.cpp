@@ -0,0 +1,164 @@
+#include "diff.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <istream>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace analyzer::diff {
+
+namespace rs = std::ranges;
+
+namespace {
+std::string StripPathPrefix(std::string_view path) {
+    // После имени файла diff -u пишет дату через табуляцию.
+    path = path.substr(0, path.find('\t'));
+    if (path.starts_with("a/") || path.starts_with("b/"))
+        path.remove_prefix(2);
+    return std::string(path);
+}
+
+struct HunkHeader {
+    size_t old_start;  // Нумерация от нуля.
+    size_t old_count;
+    size_t new_start;
+    size_t new_count;
+};
+
+// Разбирает "@@ -start[,count] +start[,count] @@"; без count ханк содержит одну строку.
+// При count == 0 start указывает на строку перед вставкой или удалением, поэтому текущей строкой
+// становится следующая за ней.
+HunkHeader ReadHunkHeader(std::string_view header) {
+    auto read_range = [header](char sign, size_t &start, size_t &count) {
+        size_t pos = header.find(sign);
+        start = 0;
+        count = 1;
+        if (pos == std::string_view::npos)
+            return;
+        const char *last = header.data() + header.size();
+        auto [start_end, error] = std::from_chars(header.data() + pos + 1, last, start);
+        if (error == std::errc{} && start_end != last && *start_end == ',')
+            std::from_chars(start_end + 1, last, count);
+        if (count > 0 && start > 0)
+            start--;
+    };
+    HunkHeader hunk{};
+    read_range('-', hunk.old_start, hunk.old_count);
+    read_range('+', hunk.new_start, hunk.new_count);
+    return hunk;
+}
+
+void AddLine(std::vector<LineRange> &ranges, size_t line) {
+    if (!ranges.empty() && ranges.back().last + 1 >= line && ranges.back().first <= line) {
+        ranges.back().last = std::max(ranges.back().last, line);
+        return;
+    }
+    ranges.push_back({line, line});
+}
+
+// Подряд идущие удалённые и добавленные строки ханка.
+struct ChangeBlock {
+    bool removed = false;
+    bool added = false;
+};
+
+// Чистое удаление или чистая вставка отмечают строку перед местом изменения в другой версии файла.
+// Если строки заменены, обе стороны уже отмечены, и соседняя функция лишний раз не задевается.
+void FlushBlock(FileDiff &file, ChangeBlock &block, size_t old_line, size_t new_line) {
+    if (block.removed && !block.added)
+        AddLine(file.new_lines, new_line == 0 ? 0 : new_line - 1);
+    if (block.added && !block.removed)
+        AddLine(file.old_lines, old_line == 0 ? 0 : old_line - 1);
+    block = {};
+}
+
+void Normalize(std::vector<LineRange> &ranges) {
+    rs::sort(ranges);
+    std::vector<LineRange> merged;
+    for (const auto &range : ranges) {
+        if (!merged.empty() && merged.back().last + 1 >= range.first)
+            merged.back().last = std::max(merged.back().last, range.last);
+        else
+            merged.push_back(range);
+    }
+    ranges = std::move(merged);
+}
+}  // namespace
+
+std::vector<FileDiff> ParseUnifiedDiff(std::istream &in) {
+    std::vector<FileDiff> files;
+    std::string old_path;
+    size_t old_line = 0;
+    size_t new_line = 0;
+    // Строки, оставшиеся в текущем ханке: по ним строки "--- ..." и "+++ ..." внутри ханка
+    // не путаются с заголовками файлов.
+    size_t old_remaining = 0;
+    size_t new_remaining = 0;
+    ChangeBlock block;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        std::string_view text = line;
+        if (old_remaining == 0 && new_remaining == 0) {
+            if (text.starts_with("--- ")) {
+                old_path = StripPathPrefix(text.substr(4));
+            } else if (text.starts_with("+++ ")) {
+                files.push_back({.old_path = std::move(old_path),
+                                 .new_path = StripPathPrefix(text.substr(4)),
+                                 .old_lines = {},
+                                 .new_lines = {}});
+                old_path.clear();
+            } else if (text.starts_with("@@") && !files.empty()) {
+                const HunkHeader hunk = ReadHunkHeader(text);
+                old_line = hunk.old_start;
+                new_line = hunk.new_start;
+                old_remaining = hunk.old_count;
+                new_remaining = hunk.new_count;
+            }
+            continue;
+        }
+
+        FileDiff &file = files.back();
+        const char kind = text.empty() ? ' ' : text.front();
+        if (kind == ' ') {
+            FlushBlock(file, block, old_line, new_line);
+            old_line++;
+            new_line++;
+            old_remaining -= std::min<size_t>(old_remaining, 1);
+            new_remaining -= std::min<size_t>(new_remaining, 1);
+        } else if (kind == '-') {
+            AddLine(file.old_lines, old_line);
+            block.removed = true;
+            old_line++;
+            old_remaining -= std::min<size_t>(old_remaining, 1);
+        } else if (kind == '+') {
+            AddLine(file.new_lines, new_line);
+            block.added = true;
+            new_line++;
+            new_remaining -= std::min<size_t>(new_remaining, 1);
+        }
+        // Остальное (например, "\ No newline at end of file") на нумерацию не влияет.
+        if (old_remaining == 0 && new_remaining == 0)
+            FlushBlock(file, block, old_line, new_line);
+    }
+    // Обрезанный ханк: блок изменений в конце потока.
+    if (!files.empty())
+        FlushBlock(files.back(), block, old_line, new_line);
+
+    for (auto &file : files) {
+        Normalize(file.old_lines);
+        Normalize(file.new_lines);
+    }
+    return files;
+}
+
+bool Touches(const std::vector<LineRange> &changed, const sexpr::Span &span) {
+    // Первый диапазон, который заканчивается не раньше начала узла.
+    auto it = rs::lower_bound(changed, span.start.line, {}, &LineRange::last);
+    return it != changed.end() && it->first <= span.end.line;
+}
+
+}  // namespace analyzer::diff
@@ -1,19 +1,25 @@
 #include "file.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <memory_resource>
 #include <ranges>
 #include <string>
 #include <vector>
 
+#include "pipe.hpp"
+
 namespace analyzer::file {
 
 namespace rv = std::ranges::views;
 namespace rs = std::ranges;
 
-File::File(const std::string &filename) : name{filename} {
+File::File(const std::string &filename, std::pmr::memory_resource *resource)
+    : name{filename}, language{&language::LanguageForFile(filename)}, ast{resource}, structure{resource},
+      source_lines{resource} {
     std::ifstream file(name);
 
     if (!file.is_open()) {
@@ -23,49 +29,68 @@ File::File(const std::string &filename) : name{filename} {
     source_lines = ReadSourceFile(file);
 }
 
-std::vector<std::string> File::ReadSourceFile(std::ifstream &file) {
-    std::vector<std::string> lines;
-    std::string line;
+File::File(const std::string &filename, std::string_view parsed_ast, std::pmr::memory_resource *resource)
+    : name{filename}, language{&language::LanguageForFile(filename)}, ast{parsed_ast, resource},
+      structure{resource}, source_lines{resource} {
+    std::ifstream file(name);
+
+    if (!file.is_open()) {
+        throw std::invalid_argument("Can't open file " + filename);
+    }
+    IndexAst();
+    source_lines = ReadSourceFile(file);
+}
+
+File::File(const std::string &filename, std::string_view parsed_ast, std::string_view source,
+           std::pmr::memory_resource *resource)
+    : name{filename}, language{&language::LanguageForFile(filename)}, ast{parsed_ast, resource},
+      structure{resource}, source_lines{SplitSource(source)} {
+    IndexAst();
+}
+
+void File::IndexAst() {
+    sexpr::StructureIndexBuilder builder(*language, structure);
+    sexpr::Tokenizer tokenizer(builder, Resource());
+    tokenizer.Feed(ast);
+    tokenizer.Finish();
+}
+
+std::pmr::vector<std::pmr::string> File::ReadSourceFile(std::ifstream &file) {
+    std::pmr::vector<std::pmr::string> lines{Resource()};
+    std::pmr::string line{Resource()};
     while (std::getline(file, line)) {
         lines.push_back(line);
     }
     return lines;
 }
 
-std::string File::GetAst(const std::string &filename) try {
-    std::string full_cmd = File::command_prefix + filename + " 2>&1";
-    std::string result;
-    std::array<char, 256> buffer;
-
-    using PipePtr = std::unique_ptr<FILE, decltype([](FILE *pipe) {
-                                        if (!pipe)
-                                            return;
-
-                                        int status = pclose(pipe);
-                                        if (WIFEXITED(status)) {
-                                            int exit_status = WEXITSTATUS(status);
-                                            if (exit_status != 0) {
-                                                throw std::runtime_error("Command failed with exit code " +
-                                                                         std::to_string(exit_status));
-                                            }
-                                        } else {
-                                            throw std::runtime_error("Command terminated abnormally");
-                                        }
-                                    })>;
-
-    FILE *raw_pipe = popen(full_cmd.c_str(), "r");
-    if (!raw_pipe) {
-        throw std::runtime_error("Failed to execute command: " + std::string(std::strerror(errno)));
+// Делит текст на строки так же, как std::getline: завершающий перевод строки не даёт пустой строки.
+std::pmr::vector<std::pmr::string> File::SplitSource(std::string_view source) {
+    std::pmr::vector<std::pmr::string> lines{Resource()};
+    while (!source.empty()) {
+        const size_t line_end = std::min(source.find('\n'), source.size());
+        lines.emplace_back(source.substr(0, line_end));
+        source.remove_prefix(std::min(line_end + 1, source.size()));
     }
-    PipePtr pipe(raw_pipe);
+    return lines;
+}
+
+std::pmr::string File::GetAst(const std::string &filename) try {
+    std::string full_cmd = File::command_prefix + filename + " 2>&1";
+    std::pmr::string result{Resource()};
+    sexpr::StructureIndexBuilder builder(*language, structure);
+    sexpr::Tokenizer tokenizer(builder, Resource());
 
-    while (fgets(buffer.data(), buffer.size(), pipe.get())) {
-        result += buffer.data();
+    // Вывод читается прямо в строку из арены файла и индексируется по мере поступления блоков.
+    int status = RunCommand(full_cmd, result, [&](std::string_view chunk) { tokenizer.Feed(chunk); });
+    if (auto failure = DescribeCommandFailure(status); !failure.empty()) {
+        throw std::runtime_error(failure);
     }
+    tokenizer.Finish();
 
     return result;
 } catch (const std::exception &e) {
-    throw std::runtime_error("Error while getting ast from " + filename);
+    throw std::runtime_error("Error while getting ast from " + filename + ": " + e.what());
 }
 
 }  // namespace analyzer::file
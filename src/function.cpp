@@ -18,7 +18,6 @@
 #include <vector>
 
 #include "file.hpp"
-#include "utils.hpp"
 
 namespace fs = std::filesystem;
 namespace rv = std::ranges::views;
@@ -26,150 +25,108 @@ namespace rs = std::ranges;
 
 namespace analyzer::function {
 
-std::vector<Function> FunctionExtractor::Get(const analyzer::file::File &file) {
-    std::vector<Function> functions;
-    size_t start = 0;
-    const std::string marker = "(function_definition";
-    const std::string &ast = file.ast;
-
-    while ((start = ast.find(marker, start)) != std::string::npos) {
-        size_t open_braces = 1;
-        size_t end = start + marker.length();
-
-        while (end < ast.size() && open_braces > 0) {
-            if (ast[end] == '(')
-                open_braces++;
-            else if (ast[end] == ')')
-                open_braces--;
-            end++;
-        }
-
-        auto func_ast = ast.substr(start, end - start);
-        auto name_loc = GetNameLocation(func_ast);
-        std::string func_name = GetNameFromSource(func_ast, file.source_lines);
-
-        Function func{.filename = file.name, .class_name = std::nullopt, .name = func_name, .ast = func_ast};
+std::string QualifiedName(const Function &function) {
+    const std::string class_name = function.class_name ? std::string(*function.class_name) : std::string();
+    const std::string name(function.name);
+    const std::string short_qualified_name = (function.class_name ? class_name + "." : "") + name;
+    if (!function.qualified_name.empty() && std::string_view(function.qualified_name) != short_qualified_name)
+        return std::string(function.qualified_name);
+    return (function.class_name ? class_name + "::" : "") + name;
+}
 
-        auto class_info = FindEnclosingClass(ast, name_loc);
-        if (class_info) {
-            func.class_name = GetClassNameFromSource(*class_info, file.source_lines);
+std::pmr::vector<Function> FunctionExtractor::Get(const analyzer::file::File &file) const {
+    using language::NodeCategory;
+    std::pmr::memory_resource *resource = file.Resource();
+    std::pmr::vector<Function> functions{resource};
+    const std::string_view ast = file.ast;
+    const auto &structure = file.structure;
+
+    // Границы функций и классов уже найдены при чтении AST, поэтому повторно файл не сканируется.
+    // Родитель в индексе стоит раньше потомка, так что полное имя, ближайший класс и вложенность
+    // в функцию каждого узла получаются из уже посчитанных значений родителя за один проход.
+    // Лямбда делает потомков вложенными только при извлечении лямбд: иначе функции внутри
+    // JavaScript IIFE и колбэков вроде describe(() => ...) не попали бы в анализ вовсе.
+    constexpr size_t kNoClass = sexpr::StructureNode::kNoParent;
+    std::pmr::vector<std::pmr::string> qualified_names{resource};
+    std::pmr::vector<size_t> enclosing_class{resource};
+    std::pmr::vector<bool> inside_function(resource);
+    qualified_names.reserve(structure.size());
+    enclosing_class.reserve(structure.size());
+    inside_function.reserve(structure.size());
+
+    for (size_t i = 0; i < structure.size(); ++i) {
+        const auto &node = structure[i];
+        const std::string_view name =
+            node.category == NodeCategory::Lambda ? "<lambda>" : GetNameFromSource(node.name, file.source_lines);
+
+        std::pmr::string qualified_name{resource};
+        size_t class_id = kNoClass;
+        bool nested = false;
+        if (node.parent != sexpr::StructureNode::kNoParent) {
+            const NodeCategory parent_category = structure[node.parent].category;
+            const bool parent_is_class = parent_category == NodeCategory::Class;
+            const bool parent_encloses =
+                parent_category == NodeCategory::Function || (parent_category == NodeCategory::Lambda && lambdas);
+            qualified_name = qualified_names[node.parent];
+            qualified_name += parent_is_class ? "." : ".<locals>.";
+            class_id = parent_is_class ? node.parent : enclosing_class[node.parent];
+            nested = parent_encloses || inside_function[node.parent];
+        }
+        qualified_name += name;
+        qualified_names.push_back(qualified_name);
+        enclosing_class.push_back(class_id);
+        inside_function.push_back(nested);
+
+        const bool wanted = node.category == NodeCategory::Function ||
+                            (node.category == NodeCategory::Lambda && lambdas);
+        if (!wanted || node.end == 0 || (nested && !nested_functions))
+            continue;
+
+        Function func{.filename = std::pmr::string(file.name, resource),
+                      .class_name = std::nullopt,
+                      .name = std::pmr::string(name, resource),
+                      .ast = std::pmr::string(ast.substr(node.begin, node.end - node.begin), resource),
+                      .language = file.language,
+                      .span = node.span,
+                      .source = GetSource(node.span, file.source_lines, resource),
+                      .qualified_name = std::move(qualified_name)};
+
+        if (class_id != kNoClass) {
+            func.class_name.emplace(GetNameFromSource(structure[class_id].name, file.source_lines), resource);
         }
 
-        functions.push_back(func);
-        start = end;
+        functions.push_back(std::move(func));
     }
 
     return functions;
 }
 
-FunctionExtractor::FunctionNameLocation FunctionExtractor::GetNameLocation(const std::string &function_ast) {
-    size_t id_pos = function_ast.find("(identifier");
-    if (id_pos == std::string::npos)
-        return {};
-
-    size_t coord_start = function_ast.find('[', id_pos);
-    size_t coord_end = function_ast.find(']', coord_start);
-    std::string coords = function_ast.substr(coord_start + 1, coord_end - coord_start - 1);
-
-    size_t comma = coords.find(',');
-    Position start{static_cast<size_t>(ToInt(coords.substr(0, comma))),
-                   static_cast<size_t>(ToInt(coords.substr(comma + 2)))};
-
-    size_t dash = function_ast.find('[', coord_end);
-    size_t end_bracket = function_ast.find(']', dash);
-    std::string end_coords = function_ast.substr(dash + 1, end_bracket - dash - 1);
-
-    comma = end_coords.find(',');
-    Position end{static_cast<size_t>(ToInt(end_coords.substr(0, comma))),
-                 static_cast<size_t>(ToInt(end_coords.substr(comma + 2)))};
-
-    return {start, end, ""};
-}
-
-std::string FunctionExtractor::GetNameFromSource(const std::string &function_ast,
-                                                 const std::vector<std::string> &lines) {
-    auto loc = GetNameLocation(function_ast);
-    if (loc.start.line >= lines.size())
-        return "unknown";
-
-    const std::string &target_line = lines[loc.start.line];
-    if (loc.start.col >= target_line.size())
-        return "unknown";
-
-    return target_line.substr(loc.start.col, loc.end.col - loc.start.col);
-}
-
-std::optional<FunctionExtractor::ClassInfo>
-FunctionExtractor::FindEnclosingClass(const std::string &ast, const FunctionNameLocation &func_loc) {
-    size_t class_pos = 0;
-    const std::string class_marker = "(class_definition";
-    std::optional<ClassInfo> last_enclosing_class;
-
-    while ((class_pos = ast.find(class_marker, class_pos)) != std::string::npos) {
-        size_t coord_start = ast.find('[', class_pos);
-        size_t coord_end = ast.find(']', coord_start);
-        std::string coords = ast.substr(coord_start + 1, coord_end - coord_start - 1);
-
-        size_t comma = coords.find(',');
-        Position class_start{static_cast<size_t>(ToInt(coords.substr(0, comma))),
-                             static_cast<size_t>(ToInt(coords.substr(comma + 1)))};
-
-        size_t dash = ast.find('-', coord_end);
-        size_t second_coord_start = ast.find('[', dash);
-        size_t second_coord_end = ast.find(']', second_coord_start);
-        std::string end_coords = ast.substr(second_coord_start + 1, second_coord_end - second_coord_start - 1);
-
-        comma = end_coords.find(',');
-        Position class_end{static_cast<size_t>(ToInt(end_coords.substr(0, comma))),
-                           static_cast<size_t>(ToInt(end_coords.substr(comma + 1)))};
-
-        if (func_loc.start.line > class_start.line ||
-            (func_loc.start.line == class_start.line && func_loc.start.col >= class_start.col)) {
-            if (func_loc.start.line < class_end.line ||
-                (func_loc.start.line == class_end.line && func_loc.start.col <= class_end.col)) {
-                size_t name_start = ast.find("name:", coord_end);
-                if (name_start != std::string::npos) {
-                    size_t id_start = ast.find("(identifier", name_start);
-                    if (id_start != std::string::npos) {
-                        size_t id_coord_start = ast.find('[', id_start);
-                        size_t id_coord_end = ast.find(']', id_coord_start);
-                        std::string id_coords = ast.substr(id_coord_start + 1, id_coord_end - id_coord_start - 1);
-
-                        ClassInfo class_info;
-                        class_info.start = class_start;
-                        class_info.end = class_end;
-                        last_enclosing_class = class_info;
-                    }
-                }
-            }
-        }
-
-        class_pos = second_coord_end;
+std::pmr::string FunctionExtractor::GetSource(const sexpr::Span &span, const std::pmr::vector<std::pmr::string> &lines,
+                                              std::pmr::memory_resource *resource) {
+    std::pmr::string source{resource};
+    for (size_t line = span.start.line; line <= span.end.line && line < lines.size(); ++line) {
+        std::string_view text = lines[line];
+        if (line == span.end.line)
+            text = text.substr(0, span.end.col);
+        if (line == span.start.line)
+            text = text.substr(std::min(span.start.col, text.size()));
+        else
+            source.push_back('\n');
+        source += text;
     }
-
-    return last_enclosing_class;
+    return source;
 }
 
-std::string FunctionExtractor::GetClassNameFromSource(const ClassInfo &class_info,
-                                                      const std::vector<std::string> &lines) {
-    if (class_info.start.line >= lines.size())
-        return "unknown";
-
-    const std::string &class_line = lines[class_info.start.line];
-
-    size_t class_pos = class_line.find("class");
-    if (class_pos == std::string::npos)
+std::string_view FunctionExtractor::GetNameFromSource(const std::optional<sexpr::Span> &loc,
+                                                      const std::pmr::vector<std::pmr::string> &lines) {
+    if (!loc || loc->start.line >= lines.size())
         return "unknown";
 
-    size_t name_start = class_line.find_first_not_of(" \t", class_pos + 5);
-    if (name_start == std::string::npos)
+    const std::string_view target_line = lines[loc->start.line];
+    if (loc->start.col >= target_line.size() || loc->end.line != loc->start.line)
         return "unknown";
 
-    size_t name_end = class_line.find_first_of(" :{(", name_start);
-    if (name_end == std::string::npos)
-        name_end = class_line.length();
-
-    return class_line.substr(name_start, name_end - name_start);
+    return target_line.substr(loc->start.col, loc->end.col - loc->start.col);
 }
 
 }  // namespace analyzer::function
@@ -0,0 +1,378 @@
+#include "history.hpp"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
+namespace analyzer::history {
+
+namespace {
+constexpr std::array<char, 8> kMagic = {'A', 'N', 'H', 'I', 'S', 'T', '0', '1'};
+constexpr std::string_view kFunctionsDictionary = "functions.dict";
+constexpr std::string_view kMetricsDictionary = "metrics.dict";
+constexpr std::string_view kLockFile = "lock";
+
+struct SegmentHeader {
+    std::array<char, 8> magic;
+    std::uint32_t run;
+    std::uint32_t rows;     // Длина каждого столбца: число функций в словаре на момент запуска.
+    std::uint32_t columns;  // Число записей в каталоге столбцов, который идёт сразу за заголовком.
+    std::uint32_t reserved;
+    std::int64_t timestamp;
+};
+
+struct ColumnEntry {
+    std::uint32_t metric;
+    std::uint32_t reserved;
+    std::uint64_t offset;  // Смещение массива float[rows] от начала сегмента, кратно 8.
+};
+
+std::runtime_error SystemError(const std::string &what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+// Блокировка flock на файле блокировки хранилища; снимается при закрытии дескриптора.
+class StoreLock {
+public:
+    StoreLock(const std::filesystem::path &path, int operation) {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd == -1)
+            throw SystemError("Failed to open " + path.string());
+        while (::flock(fd, operation) == -1) {
+            if (errno == EINTR)
+                continue;
+            auto error = SystemError("Failed to lock " + path.string());
+            ::close(fd);
+            throw error;
+        }
+    }
+
+    ~StoreLock() { ::close(fd); }
+
+    StoreLock(const StoreLock &) = delete;
+    StoreLock &operator=(const StoreLock &) = delete;
+
+private:
+    int fd;
+};
+
+// Временный файл, который удаляется, если его не удалось опубликовать.
+struct TemporaryFile {
+    ~TemporaryFile() {
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+    }
+    std::filesystem::path path;
+};
+
+// Файл, целиком отображённый в память только для чтения.
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path &path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+            throw SystemError("Failed to open " + path.string());
+        struct stat status {};
+        if (::fstat(fd, &status) == -1) {
+            ::close(fd);
+            throw SystemError("Failed to stat " + path.string());
+        }
+        size = static_cast<size_t>(status.st_size);
+        if (size > 0) {
+            data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                data = nullptr;
+                ::close(fd);
+                throw SystemError("Failed to map " + path.string());
+            }
+        }
+        // Отображение остаётся действительным и после закрытия дескриптора.
+        ::close(fd);
+    }
+
+    ~MappedFile() {
+        if (data)
+            ::munmap(data, size);
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const std::byte *Data() const { return static_cast<const std::byte *>(data); }
+    size_t Size() const { return size; }
+
+private:
+    void *data = nullptr;
+    size_t size = 0;
+};
+
+// Сегмент запуска: проверяет заголовок и каталог и отдаёт столбцы без копирования.
+class Segment {
+public:
+    explicit Segment(const std::filesystem::path &path) : file{path} {
+        if (file.Size() < sizeof(SegmentHeader))
+            throw std::runtime_error("Corrupted history segment " + path.string());
+        std::memcpy(&header, file.Data(), sizeof(header));
+        const size_t directory_end = sizeof(SegmentHeader) + size_t{header.columns} * sizeof(ColumnEntry);
+        if (header.magic != kMagic || directory_end > file.Size())
+            throw std::runtime_error("Corrupted history segment " + path.string());
+        for (std::uint32_t i = 0; i < header.columns; ++i) {
+            const ColumnEntry entry = Entry(i);
+            if (entry.offset % alignof(double) != 0 || entry.offset < directory_end ||
+                entry.offset + size_t{header.rows} * sizeof(float) > file.Size())
+                throw std::runtime_error("Corrupted history segment " + path.string());
+        }
+    }
+
+    const SegmentHeader &Header() const { return header; }
+
+    std::optional<std::span<const float>> Column(std::uint32_t metric) const {
+        for (std::uint32_t i = 0; i < header.columns; ++i) {
+            const ColumnEntry entry = Entry(i);
+            if (entry.metric == metric)
+                return std::span(reinterpret_cast<const float *>(file.Data() + entry.offset), header.rows);
+        }
+        return std::nullopt;
+    }
+
+private:
+    ColumnEntry Entry(std::uint32_t i) const {
+        ColumnEntry entry;
+        std::memcpy(&entry, file.Data() + sizeof(SegmentHeader) + i * sizeof(ColumnEntry), sizeof(entry));
+        return entry;
+    }
+
+    MappedFile file;
+    SegmentHeader header{};
+};
+
+// Ключ "файл\tкласс\tимя" сохраняется для функций, полное имя которых из класса и имени и состоит, чтобы
+// их история продолжалась; остальные (вложенные, из колбэков) опознаются по полному имени "файл\t\tполное_имя".
+std::string FunctionKey(const function::Function &f) {
+    std::string plain_name;
+    if (f.class_name)
+        plain_name = std::string(*f.class_name) + '.';
+    plain_name += f.name;
+
+    std::string key(f.filename);
+    key += '\t';
+    if (!f.qualified_name.empty() && std::string_view(f.qualified_name) != plain_name) {
+        key += '\t';
+        key += f.qualified_name;
+        return key;
+    }
+    if (f.class_name)
+        key += *f.class_name;
+    key += '\t';
+    key += f.name;
+    return key;
+}
+
+std::optional<float> NumericValue(const metric::MetricValue &value) {
+    switch (value.GetKind()) {
+    case metric::MetricValue::Kind::Integer:
+        return static_cast<float>(value.AsInteger());
+    case metric::MetricValue::Kind::Real:
+        return static_cast<float>(value.AsReal());
+    default:
+        return std::nullopt;
+    }
+}
+}  // namespace
+
+std::uint32_t HistoryStore::Dictionary::Intern(std::string name) {
+    const auto [it, inserted] = ids.emplace(name, static_cast<std::uint32_t>(names.size()));
+    if (inserted) {
+        pending += name;
+        pending += '\n';
+        names.push_back(std::move(name));
+    }
+    return it->second;
+}
+
+HistoryStore::HistoryStore(std::filesystem::path directory) : directory{std::move(directory)} {
+    std::filesystem::create_directories(this->directory);
+    // Разделяемая блокировка: словари не читаются, пока другой процесс их дописывает.
+    const StoreLock lock(this->directory / kLockFile, LOCK_SH);
+    Reload();
+}
+
+void HistoryStore::Reload() {
+    Load(functions, kFunctionsDictionary);
+    Load(metrics, kMetricsDictionary);
+    runs = 0;
+    while (std::filesystem::exists(SegmentPath(runs + 1)))
+        runs++;
+}
+
+void HistoryStore::Load(Dictionary &dictionary, std::string_view filename) const {
+    dictionary = {};
+    std::ifstream in(directory / filename);
+    for (std::string line; std::getline(in, line);) {
+        dictionary.ids.emplace(line, static_cast<std::uint32_t>(dictionary.names.size()));
+        dictionary.names.push_back(std::move(line));
+    }
+}
+
+void HistoryStore::Flush(Dictionary &dictionary, std::string_view filename) const {
+    if (dictionary.pending.empty())
+        return;
+    std::ofstream out(directory / filename, std::ios::binary | std::ios::app);
+    out.write(dictionary.pending.data(), static_cast<std::streamsize>(dictionary.pending.size()));
+    if (!out.flush())
+        throw std::runtime_error("Failed to write " + (directory / filename).string());
+    dictionary.pending.clear();
+}
+
+std::filesystem::path HistoryStore::SegmentPath(std::uint32_t run) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "run-%08u.seg", run);
+    return directory / name;
+}
+
+std::uint32_t HistoryStore::Append(std::span<const std::pair<function::Function, metric::MetricResults>> analysis,
+                                   std::int64_t timestamp) {
+    // Другой процесс мог дописать словари и запуски после открытия хранилища, поэтому под исключительной
+    // блокировкой они перечитываются: иначе два процесса выдали бы одни номера разным функциям.
+    const StoreLock lock(directory / kLockFile, LOCK_EX);
+    Reload();
+
+    std::vector<std::uint32_t> rows;
+    rows.reserve(analysis.size());
+    for (const auto &[function, results] : analysis)
+        rows.push_back(functions.Intern(FunctionKey(function)));
+
+    // Столбцы по номерам метрик; пустой столбец — метрики в этом запуске не было.
+    const size_t row_count = functions.names.size();
+    std::vector<std::vector<float>> columns;
+    std::vector<bool> recorded(row_count);
+    for (size_t i = 0; i < analysis.size(); ++i) {
+        if (recorded[rows[i]])
+            continue;
+        recorded[rows[i]] = true;
+        for (const auto &result : analysis[i].second) {
+            const auto value = NumericValue(result.value);
+            if (!value)
+                continue;
+            const std::uint32_t metric = metrics.Intern(std::string(result.metric_name));
+            if (metric >= columns.size())
+                columns.resize(metric + 1);
+            if (columns[metric].empty())
+                columns[metric].assign(row_count, std::numeric_limits<float>::quiet_NaN());
+            columns[metric][rows[i]] = *value;
+        }
+    }
+    // Словари пишутся раньше сегмента: строки без сегмента безвредны, а сегмент без строк был бы нечитаем.
+    Flush(functions, kFunctionsDictionary);
+    Flush(metrics, kMetricsDictionary);
+
+    const std::uint32_t run = runs + 1;
+    SegmentHeader header{.magic = kMagic,
+                         .run = run,
+                         .rows = static_cast<std::uint32_t>(row_count),
+                         .columns = 0,
+                         .reserved = 0,
+                         .timestamp = timestamp};
+    std::vector<ColumnEntry> entries;
+    for (std::uint32_t metric = 0; metric < columns.size(); ++metric) {
+        if (!columns[metric].empty())
+            entries.push_back({.metric = metric, .reserved = 0, .offset = 0});
+    }
+    header.columns = static_cast<std::uint32_t>(entries.size());
+    const size_t column_bytes = (row_count * sizeof(float) + alignof(double) - 1) / alignof(double) * alignof(double);
+    size_t offset = sizeof(SegmentHeader) + entries.size() * sizeof(ColumnEntry);
+    for (auto &entry : entries) {
+        entry.offset = offset;
+        offset += column_bytes;
+    }
+
+    const auto path = SegmentPath(run);
+    TemporaryFile temporary{.path = path};
+    temporary.path += "." + std::to_string(::getpid()) + ".tmp";
+    {
+        std::ofstream out(temporary.path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(entries.data()),
+                  static_cast<std::streamsize>(entries.size() * sizeof(ColumnEntry)));
+        const std::vector<char> padding(column_bytes - row_count * sizeof(float));
+        for (const auto &entry : entries) {
+            out.write(reinterpret_cast<const char *>(columns[entry.metric].data()),
+                      static_cast<std::streamsize>(row_count * sizeof(float)));
+            out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        }
+        if (!out.flush())
+            throw std::runtime_error("Failed to write " + temporary.path.string());
+    }
+    // link, в отличие от rename, не заменяет существующий сегмент: запуск с этим номером не перезаписывается,
+    // даже если хранилище открыто без блокировки (например, старой версией анализатора).
+    if (::link(temporary.path.c_str(), path.c_str()) == -1)
+        throw SystemError("Failed to create " + path.string());
+    runs = run;
+    return run;
+}
+
+std::vector<FunctionTrend> HistoryStore::Trends(std::string_view metric_name) const {
+    const auto metric = metrics.ids.find(std::string(metric_name));
+    if (metric == metrics.ids.end())
+        return {};
+
+    std::vector<FunctionTrend> by_function(functions.names.size());
+    for (std::uint32_t run = 1; run <= runs; ++run) {
+        const Segment segment(SegmentPath(run));
+        const auto column = segment.Column(metric->second);
+        if (!column)
+            continue;
+        const size_t rows = std::min(column->size(), by_function.size());
+        for (size_t function = 0; function < rows; ++function) {
+            const float value = (*column)[function];
+            if (std::isnan(value))
+                continue;
+            FunctionTrend &trend = by_function[function];
+            if (trend.runs == 0) {
+                trend.first = trend.previous = value;
+            } else {
+                trend.previous = trend.last;
+            }
+            trend.last = value;
+            trend.runs++;
+            trend.last_run = run;
+        }
+    }
+
+    std::vector<FunctionTrend> trends;
+    for (std::uint32_t function = 0; function < by_function.size(); ++function) {
+        if (by_function[function].runs > 0) {
+            trends.push_back(by_function[function]);
+            trends.back().function = function;
+        }
+    }
+    return trends;
+}
+
+std::string HistoryStore::FunctionName(std::uint32_t function) const {
+    std::string name = functions.names.at(function);
+    // "файл\tкласс\tимя" без класса даёт два табулятора подряд.
+    if (const size_t empty_class = name.find("\t\t"); empty_class != std::string::npos)
+        return name.replace(empty_class, 2, "::");
+    for (size_t tab = name.find('\t'); tab != std::string::npos; tab = name.find('\t', tab))
+        name.replace(tab, 1, "::");
+    return name;
+}
+
+std::int64_t HistoryStore::RunTimestamp(std::uint32_t run) const {
+    return Segment(SegmentPath(run)).Header().timestamp;
+}
+
+}  // namespace analyzer::history
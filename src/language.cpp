@@ -0,0 +1,162 @@
+#include "language.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace analyzer::language {
+
+Language::Language(std::string name, std::vector<std::string> extensions, std::string function_name_field,
+                   const std::vector<std::pair<std::string_view, NodeCategory>> &node_kinds, Lexicon lexicon)
+    : name{std::move(name)},
+      extensions{std::move(extensions)},
+      function_name_field{std::move(function_name_field)},
+      lexicon{std::move(lexicon)} {
+    for (const auto &[node_kind, category] : node_kinds) {
+        categories.emplace(node_kind, category);
+        kinds[category].emplace_back(node_kind);
+    }
+    std::ranges::sort(this->lexicon.keywords);
+}
+
+bool Lexicon::IsKeyword(std::string_view word) const {
+    return std::ranges::binary_search(keywords, word, std::less<>{});
+}
+
+NodeCategory Language::Categorize(std::string_view node_kind) const {
+    auto it = categories.find(node_kind);
+    return it == categories.end() ? NodeCategory::Other : it->second;
+}
+
+const std::vector<std::string> &Language::KindsOf(NodeCategory category) const {
+    static const std::vector<std::string> empty;
+    auto it = kinds.find(category);
+    return it == kinds.end() ? empty : it->second;
+}
+
+const std::vector<Language> &SupportedLanguages() {
+    using enum NodeCategory;
+    static const std::vector<Language> languages{
+        Language("python", {".py", ".pyi"}, "name:",
+                 {
+                     {"function_definition", Function},
+                     {"class_definition", Class},
+                     {"lambda", Lambda},
+                     {"if_statement", Branch},
+                     {"elif_clause", Branch},
+                     {"try_statement", Branch},
+                     {"finally_clause", Branch},
+                     {"case_clause", Branch},
+                     {"assert_statement", Branch},
+                     {"conditional_expression", Branch},
+                     {"for_statement", Loop},
+                     {"while_statement", Loop},
+                     {"parameters", Parameters},
+                     {"lambda_parameters", Parameters},
+                     {"comment", Comment},
+                     {"call", Call},
+                 },
+                 {.line_comment = "#",
+                  .block_comments = false,
+                  .triple_quoted_strings = true,
+                  .keywords = {"and", "as", "assert", "async", "await", "break", "case", "class", "continue", "def",
+                               "del", "elif", "else", "except", "finally", "for", "from", "global", "if", "import",
+                               "in", "is", "lambda", "match", "nonlocal", "not", "or", "pass", "raise", "return",
+                               "try", "while", "with", "yield"}}),
+        Language("cpp", {".cpp", ".cc", ".cxx", ".hpp", ".hh", ".hxx", ".h"}, "declarator:",
+                 {
+                     {"function_definition", Function},
+                     {"class_specifier", Class},
+                     {"struct_specifier", Class},
+                     {"lambda_expression", Lambda},
+                     {"if_statement", Branch},
+                     {"case_statement", Branch},
+                     {"catch_clause", Branch},
+                     {"conditional_expression", Branch},
+                     {"for_statement", Loop},
+                     {"for_range_loop", Loop},
+                     {"while_statement", Loop},
+                     {"do_statement", Loop},
+                     {"parameter_list", Parameters},
+                     {"comment", Comment},
+                     {"call_expression", Call},
+                 },
+                 {.line_comment = "//",
+                  .block_comments = true,
+                  .triple_quoted_strings = false,
+                  .keywords = {"alignas", "alignof", "and", "auto", "bool", "break", "case", "catch", "char",
+                               "class", "co_await", "co_return", "co_yield", "concept", "const", "const_cast",
+                               "constexpr", "continue", "decltype", "default", "delete", "do", "double",
+                               "dynamic_cast", "else", "enum", "explicit", "extern", "float", "for", "friend",
+                               "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept",
+                               "not", "operator", "or", "private", "protected", "public", "reinterpret_cast",
+                               "requires", "return", "short", "signed", "sizeof", "static", "static_assert",
+                               "static_cast", "struct", "switch", "template", "throw", "try", "typedef", "typename",
+                               "union", "unsigned", "using", "virtual", "void", "volatile", "while"}}),
+        Language("go", {".go"}, "name:",
+                 {
+                     {"function_declaration", Function},
+                     {"method_declaration", Function},
+                     {"func_literal", Lambda},
+                     {"if_statement", Branch},
+                     {"expression_case", Branch},
+                     {"type_case", Branch},
+                     {"communication_case", Branch},
+                     {"for_statement", Loop},
+                     {"parameter_list", Parameters},
+                     {"comment", Comment},
+                     {"call_expression", Call},
+                 },
+                 {.line_comment = "//",
+                  .block_comments = true,
+                  .triple_quoted_strings = false,
+                  .keywords = {"break", "case", "chan", "const", "continue", "default", "defer", "else",
+                               "fallthrough", "for", "func", "go", "goto", "if", "import", "interface", "map",
+                               "package", "range", "return", "select", "struct", "switch", "type", "var"}}),
+        Language("javascript", {".js", ".mjs", ".cjs", ".jsx"}, "name:",
+                 {
+                     {"function_declaration", Function},
+                     {"generator_function_declaration", Function},
+                     {"method_definition", Function},
+                     {"class_declaration", Class},
+                     {"arrow_function", Lambda},
+                     {"function_expression", Lambda},
+                     {"if_statement", Branch},
+                     {"switch_case", Branch},
+                     {"catch_clause", Branch},
+                     {"ternary_expression", Branch},
+                     {"for_statement", Loop},
+                     {"for_in_statement", Loop},
+                     {"while_statement", Loop},
+                     {"do_statement", Loop},
+                     {"formal_parameters", Parameters},
+                     {"comment", Comment},
+                     {"call_expression", Call},
+                 },
+                 {.line_comment = "//",
+                  .block_comments = true,
+                  .triple_quoted_strings = false,
+                  .keywords = {"async", "await", "break", "case", "catch", "class", "const", "continue", "debugger",
+                               "default", "delete", "do", "else", "export", "extends", "finally", "for", "function",
+                               "if", "import", "in", "instanceof", "let", "new", "of", "return", "static", "switch",
+                               "throw", "try", "typeof", "var", "void", "while", "with", "yield"}}),
+    };
+    return languages;
+}
+
+const Language &Python() { return SupportedLanguages().front(); }
+
+const Language &LanguageForFile(std::string_view filename) {
+    const std::string extension = std::filesystem::path(filename).extension().string();
+    for (const auto &language : SupportedLanguages()) {
+        if (std::ranges::find(language.extensions, extension) != language.extensions.end())
+            return language;
+    }
+    throw std::invalid_argument("Unsupported file extension '" + extension + "' for " + std::string(filename));
+}
+
+}  // namespace analyzer::language
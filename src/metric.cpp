@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "function.hpp"
+#include "result_cache.hpp"
 
 namespace analyzer::metric {
 void MetricExtractor::RegisterMetric(std::unique_ptr<IMetric> metric) { metrics.push_back(std::move(metric)); }
@@ -28,10 +29,36 @@ void MetricExtractor::RegisterMetric(std::unique_ptr<IMetric> metric) { metrics.
  *
  * Эта функция применяет каждый метрический объект из контейнера `metrics`
  * к переданной функции `func` и собирает результаты в вектор.
+ * Названия метрик не копируются, а вектор выходит за встроенный буфер только при большом числе метрик
+ * и тогда берёт память из ресурса, в котором лежит AST функции.
+ * С подключённым `result_cache` для уже встречавшегося отпечатка метрики не пересчитываются.
  */
 MetricResults MetricExtractor::Get(const function::Function &func) const {
-    // здесь ваш код
-    return {};
+    Fingerprint fingerprint = 0;
+    auto results = GetUncommitted(func, fingerprint);
+    Commit(fingerprint, func, results);
+    return results;
+}
+
+MetricResults MetricExtractor::GetUncommitted(const function::Function &func, Fingerprint &fingerprint) const {
+    std::pmr::memory_resource *resource = func.ast.get_allocator().resource();
+    if (result_cache) {
+        fingerprint = FingerprintFunction(func);
+        if (auto cached = result_cache->Find(fingerprint, resource))
+            return std::move(*cached);
+    }
+
+    MetricResults results{resource};
+    results.reserve(metrics.size());
+    rs::transform(metrics, std::back_inserter(results),
+                  [&func](const auto &metric) { return metric->Calculate(func); });
+    return results;
+}
+
+void MetricExtractor::Commit(Fingerprint fingerprint, const function::Function &func,
+                             const MetricResults &results) const {
+    if (result_cache)
+        result_cache->Record(fingerprint, func, results);
 }
 
 }  // namespace analyzer::metric
@@ -12,6 +12,7 @@
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <mutex>
 #include <ranges>
 #include <sstream>
 #include <string>
@@ -27,12 +28,62 @@ namespace analyzer::metric_accumulator {
  *
  * Как это работает:
  * - Для каждого `metric_result` из `metric_results` извлекается имя метрики (`metric_name`).
- * - По этому имени в контейнере `accumulators` находится нужный аккумулятор.
- * - Вызывается метод `Accumulate(metric_result)`, который обновляет внутреннее состояние аккумулятора.
+ * - По этому имени в контейнере `accumulators` находятся все аккумуляторы, зарегистрированные для метрики.
+ * - У каждого вызывается метод `Accumulate(metric_result)`, который обновляет его внутреннее состояние.
  */
-void MetricsAccumulator::AccumulateNextFunctionResults(const std::vector<metric::MetricResult> &metric_results) const {
-    // здесь ваш код
+void MetricsAccumulator::AccumulateNextFunctionResults(const metric::MetricResults &metric_results) const {
+    Dispatch(metric_results, [](IAccumulator &accumulator, const metric::MetricResult &metric_result) {
+        accumulator.Accumulate(metric_result);
+    });
 }
+
+/**
+ * @brief Накапливает результаты метрик для одной функции, передавая аккумуляторам и саму функцию.
+ *
+ * Нужна аккумуляторам, которые запоминают, какой функции принадлежит значение (например, Top-K).
+ */
+void MetricsAccumulator::AccumulateNextFunctionResults(const function::Function &function,
+                                                       const metric::MetricResults &metric_results) const {
+    Dispatch(metric_results, [&function](IAccumulator &accumulator, const metric::MetricResult &metric_result) {
+        accumulator.Accumulate(function, metric_result);
+    });
+}
+
+/**
+ * @brief Создаёт `shards_count` слотов с пустыми копиями всех зарегистрированных аккумуляторов.
+ *
+ * Уже накопленное в прежних слотах сначала сливается в основные аккумуляторы, поэтому число слотов
+ * можно менять между проходами.
+ */
+void MetricsAccumulator::EnableSharding(size_t shards_count) {
+    MergeShards();
+    shards.clear();
+    for (size_t i = 0; i < shards_count; ++i) {
+        auto shard = std::make_unique<Shard>();
+        for (const auto &[metric_name, accumulator] : accumulators) {
+            shard->slots.emplace(metric_name,
+                                 ShardSlot{.accumulator = accumulator->CloneEmpty(), .target = accumulator.get()});
+        }
+        shards.push_back(std::move(shard));
+    }
+}
+
+/**
+ * @brief Сливает слоты потоков в основные аккумуляторы и очищает слоты.
+ *
+ * Состояние основных аккумуляторов хранится по указателю, поэтому слияние возможно и через const-объект,
+ * как и само накопление.
+ */
+void MetricsAccumulator::MergeShards() const {
+    for (const auto &shard : shards) {
+        std::lock_guard lock(shard->mutex);
+        for (auto &[metric_name, slot] : shard->slots) {
+            slot.target->MergeFrom(*slot.accumulator);
+            slot.accumulator->Reset();
+        }
+    }
+}
+
 /**
  * @brief Сбрасывает состояние всех аккумуляторов.
  *
@@ -41,7 +92,15 @@ void MetricsAccumulator::AccumulateNextFunctionResults(const std::vector<metric:
  * который обнуляет накопленные значения (сумму, счётчик и т.д.).
  */
 void MetricsAccumulator::ResetAccumulators() {
-    // здесь ваш код
+    for (auto &[metric_name, accumulator] : accumulators) {
+        accumulator->Reset();
+    }
+    for (auto &shard : shards) {
+        std::lock_guard lock(shard->mutex);
+        for (auto &[metric_name, slot] : shard->slots) {
+            slot.accumulator->Reset();
+        }
+    }
 }
 
 }  // namespace analyzer::metric_accumulator
@@ -20,14 +20,23 @@
 namespace analyzer::metric_accumulator::metric_accumulator_impl {
 
 void AverageAccumulator::Accumulate(const metric::MetricResult &metric_result) {
-    sum += std::get<int>(metric_result.value);
+    // Усредняются и целые метрики, и вещественные (объём Холстеда, индекс сопровождаемости).
+    const auto &value = metric_result.value;
+    sum += value.GetKind() == metric::MetricValue::Kind::Real ? value.AsReal()
+                                                              : static_cast<double>(value.AsInteger());
     count++;
 }
 void AverageAccumulator::Finalize() {
-    average = static_cast<double>(sum) / count;
+    average = sum / count;
     is_finalized = true;
 }
 
+void AverageAccumulator::Merge(const AverageAccumulator &other) {
+    sum += other.sum;
+    count += other.count;
+    is_finalized = false;
+}
+
 void AverageAccumulator::Reset() {
     is_finalized = false;
     sum = 0;
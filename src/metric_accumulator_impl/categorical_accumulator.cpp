@@ -20,13 +20,25 @@
 namespace analyzer::metric_accumulator::metric_accumulator_impl {
 
 void CategoricalAccumulator::Accumulate(const metric::MetricResult &metric_result) {
-    categories_freq[std::get<std::string>(metric_result.value)]++;
+    ids_freq[metric_result.value.AsCategory()]++;
 }
 
-void CategoricalAccumulator::Finalize() { is_finalized = true; }
+void CategoricalAccumulator::Merge(const CategoricalAccumulator &other) {
+    for (const auto &[id, freq] : other.ids_freq)
+        ids_freq[id] += freq;
+    is_finalized = false;
+}
+
+void CategoricalAccumulator::Finalize() {
+    categories_freq.clear();
+    for (const auto &[id, freq] : ids_freq)
+        categories_freq.emplace(metric::CategoryRegistry::Name(id), freq);
+    is_finalized = true;
+}
 
 void CategoricalAccumulator::Reset() {
     is_finalized = false;
+    ids_freq.clear();
     categories_freq.clear();
 }
 
@@ -0,0 +1,65 @@
+#include "metric_accumulator_impl/histogram_accumulator.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <limits>
+#include <stdexcept>
+
+namespace analyzer::metric_accumulator::metric_accumulator_impl {
+
+HistogramAccumulator::HistogramAccumulator(std::vector<int> upper_bounds) {
+    rs::sort(upper_bounds);
+    const auto [first, last] = rs::unique(upper_bounds);
+    upper_bounds.erase(first, last);
+
+    buckets.reserve(upper_bounds.size() + 1);
+    for (int bound : upper_bounds)
+        buckets.push_back({.upper_bound = bound, .count = 0});
+    if (buckets.empty() || buckets.back().upper_bound != std::numeric_limits<int>::max())
+        buckets.push_back({.upper_bound = std::numeric_limits<int>::max(), .count = 0});
+}
+
+void HistogramAccumulator::Accumulate(const metric::MetricResult &metric_result) {
+    const int value = static_cast<int>(metric_result.value.AsInteger());
+    // Корзин немного и их число фиксировано, поэтому поиск корзины — O(1) на значение.
+    auto bucket = rs::lower_bound(buckets, value, {}, &Bucket::upper_bound);
+    bucket->count++;
+}
+
+void HistogramAccumulator::Merge(const HistogramAccumulator &other) {
+    if (!rs::equal(buckets, other.buckets, {}, &Bucket::upper_bound, &Bucket::upper_bound))
+        throw std::invalid_argument("HistogramAccumulator::Merge() called for histograms with different buckets");
+    for (size_t i = 0; i < buckets.size(); ++i)
+        buckets[i].count += other.buckets[i].count;
+    is_finalized = false;
+}
+
+void HistogramAccumulator::Finalize() { is_finalized = true; }
+
+void HistogramAccumulator::Reset() {
+    is_finalized = false;
+    for (auto &bucket : buckets)
+        bucket.count = 0;
+}
+
+const std::vector<HistogramAccumulator::Bucket> &HistogramAccumulator::Get() const {
+    if (!is_finalized)
+        throw std::runtime_error("HistogramAccumulator::Get() called before Finalize()");
+    return buckets;
+}
+}  // namespace analyzer::metric_accumulator::metric_accumulator_impl
@@ -0,0 +1,142 @@
+#include "metric_accumulator_impl/quantile_accumulator.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <cmath>
+#include <limits>
+
+namespace analyzer::metric_accumulator::metric_accumulator_impl {
+
+QuantileAccumulator::QuantileAccumulator(size_t capacity) : capacity{std::max<size_t>(capacity, 2)} {
+    levels.emplace_back();
+    total_capacity = TotalCapacity();
+}
+
+void QuantileAccumulator::Accumulate(const metric::MetricResult &metric_result) {
+    Insert(static_cast<int>(metric_result.value.AsInteger()));
+}
+
+void QuantileAccumulator::Insert(int value) {
+    max = count == 0 ? value : std::max(max, value);
+    count++;
+    levels.front().push_back(value);
+    retained++;
+    if (retained >= total_capacity)
+        Compress();
+}
+
+size_t QuantileAccumulator::LevelCapacity(size_t level) const {
+    // Верхний уровень имеет полную ёмкость, каждый следующий вниз — в 2/3 от предыдущего.
+    const auto depth = static_cast<double>(levels.size() - level - 1);
+    return std::max<size_t>(2, static_cast<size_t>(std::ceil(capacity * std::pow(2.0 / 3.0, depth))));
+}
+
+size_t QuantileAccumulator::TotalCapacity() const {
+    size_t total = 0;
+    for (size_t level = 0; level < levels.size(); ++level)
+        total += LevelCapacity(level);
+    return total;
+}
+
+void QuantileAccumulator::Compress() {
+    for (size_t level = 0; level < levels.size(); ++level) {
+        if (levels[level].size() < LevelCapacity(level))
+            continue;
+        if (level + 1 == levels.size()) {
+            levels.emplace_back();
+            total_capacity = TotalCapacity();
+        }
+
+        auto &items = levels[level];
+        rs::sort(items);
+        // При нечётном размере первый элемент остаётся на уровне, остальные делятся пополам.
+        const size_t keep = items.size() % 2;
+        for (size_t i = keep + (compaction_offset ? 1 : 0); i < items.size(); i += 2)
+            levels[level + 1].push_back(items[i]);
+        retained -= (items.size() - keep) / 2;
+        items.resize(keep);
+        compaction_offset = !compaction_offset;
+        return;
+    }
+}
+
+void QuantileAccumulator::Merge(const QuantileAccumulator &other) {
+    if (other.count == 0)
+        return;
+    max = count == 0 ? other.max : std::max(max, other.max);
+    count += other.count;
+    if (levels.size() < other.levels.size()) {
+        levels.resize(other.levels.size());
+        total_capacity = TotalCapacity();
+    }
+    for (size_t level = 0; level < other.levels.size(); ++level) {
+        levels[level].insert(levels[level].end(), other.levels[level].begin(), other.levels[level].end());
+        retained += other.levels[level].size();
+    }
+    while (retained >= total_capacity)
+        Compress();
+    is_finalized = false;
+}
+
+int QuantileAccumulator::Quantile(double q) const {
+    if (count == 0)
+        return 0;
+
+    std::vector<std::pair<int, size_t>> weighted;
+    weighted.reserve(retained);
+    size_t total_weight = 0;
+    for (size_t level = 0; level < levels.size(); ++level) {
+        for (int value : levels[level])
+            weighted.emplace_back(value, size_t{1} << level);
+        total_weight += levels[level].size() << level;
+    }
+    rs::sort(weighted);
+
+    const double clamped = std::clamp(q, 0.0, 1.0);
+    const auto rank = std::max<size_t>(1, static_cast<size_t>(std::ceil(clamped * total_weight - 1e-9)));
+    size_t cumulative = 0;
+    for (const auto &[value, weight] : weighted) {
+        cumulative += weight;
+        if (cumulative >= rank)
+            return value;
+    }
+    return weighted.back().first;
+}
+
+void QuantileAccumulator::Finalize() {
+    quantiles = Quantiles{.p50 = Quantile(0.5), .p90 = Quantile(0.9), .p99 = Quantile(0.99), .max = max};
+    is_finalized = true;
+}
+
+void QuantileAccumulator::Reset() {
+    is_finalized = false;
+    levels.assign(1, {});
+    total_capacity = TotalCapacity();
+    retained = 0;
+    count = 0;
+    max = 0;
+    compaction_offset = false;
+    quantiles = {};
+}
+
+QuantileAccumulator::Quantiles QuantileAccumulator::Get() const {
+    if (!is_finalized)
+        throw std::runtime_error("QuantileAccumulator::Get() called before Finalize()");
+    return quantiles;
+}
+}  // namespace analyzer::metric_accumulator::metric_accumulator_impl
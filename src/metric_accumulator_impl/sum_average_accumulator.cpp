@@ -20,7 +20,7 @@
 namespace analyzer::metric_accumulator::metric_accumulator_impl {
 
 void SumAverageAccumulator::Accumulate(const metric::MetricResult &metric_result) {
-    sum += std::get<int>(metric_result.value);
+    sum += static_cast<int>(metric_result.value.AsInteger());
     count++;
 }
 void SumAverageAccumulator::Finalize() {
@@ -28,6 +28,12 @@ void SumAverageAccumulator::Finalize() {
     is_finalized = true;
 }
 
+void SumAverageAccumulator::Merge(const SumAverageAccumulator &other) {
+    sum += other.sum;
+    count += other.count;
+    is_finalized = false;
+}
+
 void SumAverageAccumulator::Reset() {
     is_finalized = false;
     sum = 0;
@@ -0,0 +1,63 @@
+#include "metric_accumulator_impl/histogram_accumulator.hpp"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <stdexcept>
+
+namespace analyzer::metric_accumulator::metric_accumulator_impl::test {
+
+namespace {
+metric::MetricResult MakeResult(int value) { return {.metric_name = "Code lines count", .value = value}; }
+constexpr int kInf = std::numeric_limits<int>::max();
+}  // namespace
+
+TEST(HistogramAccumulatorTest, GetBeforeFinalizeThrows) {
+    HistogramAccumulator acc({1, 5});
+    EXPECT_THROW(acc.Get(), std::runtime_error);
+}
+
+TEST(HistogramAccumulatorTest, CountsValuesIntoBuckets) {
+    HistogramAccumulator acc({5, 1, 10});
+    for (int value : {0, 1, 2, 5, 6, 10, 11, 100})
+        acc.Accumulate(MakeResult(value));
+    acc.Finalize();
+    std::vector<HistogramAccumulator::Bucket> expected{
+        {.upper_bound = 1, .count = 2},
+        {.upper_bound = 5, .count = 2},
+        {.upper_bound = 10, .count = 2},
+        {.upper_bound = kInf, .count = 2},
+    };
+    EXPECT_EQ(acc.Get(), expected);
+}
+
+TEST(HistogramAccumulatorTest, Merge) {
+    HistogramAccumulator left({1, 5});
+    HistogramAccumulator right({1, 5});
+    left.Accumulate(MakeResult(1));
+    right.Accumulate(MakeResult(3));
+    right.Accumulate(MakeResult(30));
+    left.Merge(right);
+    left.Finalize();
+    std::vector<HistogramAccumulator::Bucket> expected{
+        {.upper_bound = 1, .count = 1},
+        {.upper_bound = 5, .count = 1},
+        {.upper_bound = kInf, .count = 1},
+    };
+    EXPECT_EQ(left.Get(), expected);
+
+    HistogramAccumulator other({2});
+    EXPECT_THROW(left.Merge(other), std::invalid_argument);
+}
+
+TEST(HistogramAccumulatorTest, Reset) {
+    HistogramAccumulator acc({1});
+    acc.Accumulate(MakeResult(1));
+    acc.Finalize();
+    acc.Reset();
+    EXPECT_THROW(acc.Get(), std::runtime_error);
+    acc.Finalize();
+    EXPECT_EQ(acc.Get().front().count, 0);
+}
+
+}  // namespace analyzer::metric_accumulator::metric_accumulator_impl::test
@@ -0,0 +1,82 @@
+#include "metric_accumulator.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metric_accumulator_impl/histogram_accumulator.hpp"
+#include "metric_accumulator_impl/quantile_accumulator.hpp"
+#include "metric_accumulator_impl/sum_average_accumulator.hpp"
+
+namespace analyzer::metric_accumulator::test {
+
+using namespace metric_accumulator_impl;
+
+namespace {
+const std::string kMetric = "Cyclomatic complexity";
+
+metric::MetricResults MakeResults(int value) {
+    metric::MetricResults results;
+    results.push_back({.metric_name = kMetric, .value = value});
+    return results;
+}
+
+void RegisterAll(MetricsAccumulator &accumulator) {
+    accumulator.RegisterAccumulator(kMetric, std::make_unique<SumAverageAccumulator>());
+    accumulator.RegisterAccumulator(kMetric, std::make_unique<HistogramAccumulator>(std::vector{1, 5, 10}));
+    accumulator.RegisterAccumulator(kMetric, std::make_unique<QuantileAccumulator>(1000));
+}
+}  // namespace
+
+TEST(MetricsAccumulatorTest, ShardedAccumulationMatchesSequential) {
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 100;
+
+    MetricsAccumulator sequential;
+    RegisterAll(sequential);
+    for (int value = 0; value < kThreads * kPerThread; ++value)
+        sequential.AccumulateNextFunctionResults(MakeResults(value % 17));
+
+    MetricsAccumulator sharded;
+    RegisterAll(sharded);
+    sharded.EnableSharding(kThreads);
+    {
+        std::vector<std::jthread> workers;
+        for (int thread = 0; thread < kThreads; ++thread) {
+            workers.emplace_back([&sharded, thread] {
+                for (int i = 0; i < kPerThread; ++i)
+                    sharded.AccumulateNextFunctionResults(MakeResults((thread * kPerThread + i) % 17));
+            });
+        }
+    }
+
+    EXPECT_EQ(sharded.GetFinalizedAccumulator<SumAverageAccumulator>(kMetric).Get(),
+              sequential.GetFinalizedAccumulator<SumAverageAccumulator>(kMetric).Get());
+    EXPECT_EQ(sharded.GetFinalizedAccumulator<HistogramAccumulator>(kMetric).Get(),
+              sequential.GetFinalizedAccumulator<HistogramAccumulator>(kMetric).Get());
+    // Пока значений меньше ёмкости скетча, квантили точные и от порядка слияния не зависят.
+    EXPECT_EQ(sharded.GetFinalizedAccumulator<QuantileAccumulator>(kMetric).Get(),
+              sequential.GetFinalizedAccumulator<QuantileAccumulator>(kMetric).Get());
+}
+
+TEST(MetricsAccumulatorTest, ResetClearsShardsAndLateRegistrationGetsSlots) {
+    MetricsAccumulator accumulator;
+    accumulator.RegisterAccumulator(kMetric, std::make_unique<SumAverageAccumulator>());
+    accumulator.EnableSharding(4);
+    accumulator.AccumulateNextFunctionResults(MakeResults(10));
+    accumulator.ResetAccumulators();
+
+    accumulator.RegisterAccumulator(kMetric, std::make_unique<HistogramAccumulator>(std::vector{5}));
+    accumulator.AccumulateNextFunctionResults(MakeResults(3));
+    EXPECT_EQ(accumulator.GetFinalizedAccumulator<SumAverageAccumulator>(kMetric).Get(),
+              (SumAverageAccumulator::SumAverage{.sum = 3, .average = 3.0}));
+    EXPECT_EQ(accumulator.GetFinalizedAccumulator<HistogramAccumulator>(kMetric).Get().front().count, 1);
+
+    // Повторное получение результата не сливает слоты второй раз.
+    EXPECT_EQ(accumulator.GetFinalizedAccumulator<SumAverageAccumulator>(kMetric).Get().sum, 3);
+}
+
+}  // namespace analyzer::metric_accumulator::test
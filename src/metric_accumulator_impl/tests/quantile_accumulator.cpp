@@ -0,0 +1,63 @@
+#include "metric_accumulator_impl/quantile_accumulator.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+namespace analyzer::metric_accumulator::metric_accumulator_impl::test {
+
+namespace {
+metric::MetricResult MakeResult(int value) { return {.metric_name = "Cyclomatic Complexity", .value = value}; }
+}  // namespace
+
+TEST(QuantileAccumulatorTest, GetBeforeFinalizeThrows) {
+    QuantileAccumulator acc;
+    acc.Accumulate(MakeResult(1));
+    EXPECT_THROW(acc.Get(), std::runtime_error);
+}
+
+TEST(QuantileAccumulatorTest, ExactForSmallInput) {
+    QuantileAccumulator acc;
+    for (int value = 100; value >= 1; --value)
+        acc.Accumulate(MakeResult(value));
+    acc.Finalize();
+    EXPECT_EQ(acc.Get(), (QuantileAccumulator::Quantiles{.p50 = 50, .p90 = 90, .p99 = 99, .max = 100}));
+}
+
+TEST(QuantileAccumulatorTest, ApproximatesLargeInputWithBoundedMemory) {
+    QuantileAccumulator acc(64);
+    constexpr int kCount = 100000;
+    for (int value = 0; value < kCount; ++value)
+        acc.Accumulate(MakeResult((value * 7919) % kCount));
+    acc.Finalize();
+    auto quantiles = acc.Get();
+    EXPECT_EQ(quantiles.max, kCount - 1);
+    EXPECT_NEAR(quantiles.p50, kCount * 0.5, kCount * 0.05);
+    EXPECT_NEAR(quantiles.p90, kCount * 0.9, kCount * 0.05);
+    EXPECT_NEAR(quantiles.p99, kCount * 0.99, kCount * 0.05);
+}
+
+TEST(QuantileAccumulatorTest, MergeCombinesSketches) {
+    QuantileAccumulator left;
+    QuantileAccumulator right;
+    for (int value = 1; value <= 50; ++value)
+        left.Accumulate(MakeResult(value));
+    for (int value = 51; value <= 100; ++value)
+        right.Accumulate(MakeResult(value));
+    left.Merge(right);
+    left.Finalize();
+    EXPECT_EQ(left.Get(), (QuantileAccumulator::Quantiles{.p50 = 50, .p90 = 90, .p99 = 99, .max = 100}));
+}
+
+TEST(QuantileAccumulatorTest, Reset) {
+    QuantileAccumulator acc;
+    acc.Accumulate(MakeResult(10));
+    acc.Finalize();
+    acc.Reset();
+    EXPECT_THROW(acc.Get(), std::runtime_error);
+    acc.Accumulate(MakeResult(3));
+    acc.Finalize();
+    EXPECT_EQ(acc.Get(), (QuantileAccumulator::Quantiles{.p50 = 3, .p90 = 3, .p99 = 3, .max = 3}));
+}
+
+}  // namespace analyzer::metric_accumulator::metric_accumulator_impl::test
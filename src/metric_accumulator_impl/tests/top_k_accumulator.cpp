@@ -0,0 +1,71 @@
+#include "metric_accumulator_impl/top_k_accumulator.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+namespace analyzer::metric_accumulator::metric_accumulator_impl::test {
+
+namespace {
+metric::MetricResult MakeResult(int value) { return {.metric_name = "Cyclomatic Complexity", .value = value}; }
+
+function::Function MakeFunction(std::string_view name, std::optional<std::string_view> class_name = std::nullopt) {
+    function::Function function{
+        .filename = "file.py", .class_name = std::nullopt, .name = std::pmr::string(name), .ast = ""};
+    if (class_name)
+        function.class_name.emplace(*class_name);
+    return function;
+}
+
+std::vector<int> Values(const std::vector<TopKAccumulator::Entry> &entries) {
+    std::vector<int> values;
+    for (const auto &entry : entries)
+        values.push_back(entry.value);
+    return values;
+}
+}  // namespace
+
+TEST(TopKAccumulatorTest, GetBeforeFinalizeThrows) {
+    TopKAccumulator acc(3);
+    EXPECT_THROW(acc.Get(), std::runtime_error);
+}
+
+TEST(TopKAccumulatorTest, KeepsLargestValuesWithFunctionIdentity) {
+    TopKAccumulator acc(2);
+    acc.Accumulate(MakeFunction("small"), MakeResult(1));
+    acc.Accumulate(MakeFunction("largest", "Class"), MakeResult(10));
+    acc.Accumulate(MakeFunction("middle"), MakeResult(5));
+    acc.Accumulate(MakeFunction("tiny"), MakeResult(0));
+    acc.Finalize();
+
+    const auto &top = acc.Get();
+    ASSERT_EQ(top.size(), 2);
+    EXPECT_EQ(top[0], (TopKAccumulator::Entry{
+                          .filename = "file.py", .class_name = "Class", .function_name = "largest", .value = 10}));
+    EXPECT_EQ(top[1].function_name, "middle");
+    EXPECT_EQ(top[1].class_name, std::nullopt);
+}
+
+TEST(TopKAccumulatorTest, MergeKeepsGlobalTop) {
+    TopKAccumulator left(3);
+    TopKAccumulator right(3);
+    for (int value : {1, 7, 3, 9})
+        left.Accumulate(MakeFunction("left"), MakeResult(value));
+    for (int value : {8, 2, 10})
+        right.Accumulate(MakeFunction("right"), MakeResult(value));
+    left.Merge(right);
+    left.Finalize();
+    EXPECT_EQ(Values(left.Get()), (std::vector{10, 9, 8}));
+}
+
+TEST(TopKAccumulatorTest, Reset) {
+    TopKAccumulator acc(1);
+    acc.Accumulate(MakeFunction("f"), MakeResult(4));
+    acc.Finalize();
+    acc.Reset();
+    acc.Accumulate(MakeFunction("g"), MakeResult(2));
+    acc.Finalize();
+    EXPECT_EQ(Values(acc.Get()), (std::vector{2}));
+}
+
+}  // namespace analyzer::metric_accumulator::metric_accumulator_impl::test
@@ -0,0 +1,90 @@
+#include "metric_accumulator_impl/top_k_accumulator.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace analyzer::metric_accumulator::metric_accumulator_impl {
+
+namespace {
+// Сравнение для min-кучи: на вершине элемент с наименьшим значением.
+bool GreaterValue(const TopKAccumulator::Entry &lhs, const TopKAccumulator::Entry &rhs) {
+    return lhs.value > rhs.value;
+}
+}  // namespace
+
+TopKAccumulator::TopKAccumulator(size_t k) : k{k} { heap.reserve(k); }
+
+void TopKAccumulator::Accumulate(const metric::MetricResult &metric_result) {
+    const int value = static_cast<int>(metric_result.value.AsInteger());
+    if (Admits(value))
+        Push({.filename = {}, .class_name = std::nullopt, .function_name = {}, .value = value});
+}
+
+void TopKAccumulator::Accumulate(const function::Function &function, const metric::MetricResult &metric_result) {
+    const int value = static_cast<int>(metric_result.value.AsInteger());
+    if (Admits(value))
+        Push({.filename = std::string(function.filename),
+              .class_name = std::optional<std::string>(function.class_name),
+              .function_name = std::string(function.name),
+              .value = value});
+}
+
+bool TopKAccumulator::Admits(int value) const {
+    return heap.size() < k || (k > 0 && value > heap.front().value);
+}
+
+void TopKAccumulator::Push(Entry entry) {
+    if (heap.size() == k) {
+        rs::pop_heap(heap, GreaterValue);
+        heap.back() = std::move(entry);
+    } else {
+        heap.push_back(std::move(entry));
+    }
+    rs::push_heap(heap, GreaterValue);
+    is_finalized = false;
+}
+
+void TopKAccumulator::Merge(const TopKAccumulator &other) {
+    for (const auto &entry : other.heap) {
+        if (Admits(entry.value))
+            Push(entry);
+    }
+}
+
+void TopKAccumulator::Finalize() {
+    top = heap;
+    rs::sort(top, [](const Entry &lhs, const Entry &rhs) {
+        if (lhs.value != rhs.value)
+            return lhs.value > rhs.value;
+        return std::tie(lhs.filename, lhs.class_name, lhs.function_name) <
+               std::tie(rhs.filename, rhs.class_name, rhs.function_name);
+    });
+    is_finalized = true;
+}
+
+void TopKAccumulator::Reset() {
+    is_finalized = false;
+    heap.clear();
+    top.clear();
+}
+
+const std::vector<TopKAccumulator::Entry> &TopKAccumulator::Get() const {
+    if (!is_finalized)
+        throw std::runtime_error("TopKAccumulator::Get() called before Finalize()");
+    return top;
+}
+}  // namespace analyzer::metric_accumulator::metric_accumulator_impl
@@ -17,52 +17,42 @@
 #include <variant>
 #include <vector>
 
+#include "sexpr.hpp"
+
 namespace analyzer::metric::metric_impl {
-std::string CodeLinesCountMetric::Name() const { return kName; }
+std::string_view CodeLinesCountMetric::Name() const { return kName; }
 
 MetricResult::ValueType CodeLinesCountMetric::CalculateImpl(const function::Function &f) const {
-    auto &function_ast = f.ast;
-
-    // Вспомогательная лямбда для извлечения номера строки из диапазона узла AST.
-    // Формат узла в S-выражении: (node_type [start_line,start_column] [end_line,end_column] ...)
-    // Эта функция ищет открывающую скобку "[" после заданной позиции и парсит первую координату — номер строки.
-    auto line_number = [&](int start_pos) {
-        size_t line_pos = function_ast.find("[", start_pos);
-        size_t comma_pos = function_ast.find(",", line_pos);
-        return ToInt(function_ast.substr(line_pos + 1, comma_pos - line_pos - 1));
-    };
-    // Определяем начальную и конечную строки тела функции:
-    // - начальная строка берётся из корневого узла функции (первое вхождение "[")
-    // - конечная строка ищется по шаблону "] -"
-    const int start_line = line_number(0);
-    const int end_line = line_number(function_ast.find("] -"));
-    
-    // Лямбда, проверяющая, является ли конкретная строка "кодовой", то есть не комментарием.
-    auto is_code_line = [&](int line) {
-        std::string line_marker = "[" + std::to_string(line) + ",";
-        size_t line_pos = function_ast.find(line_marker);
-
-        if (line_pos == std::string::npos)
-            return false;
-
-        size_t node_start = function_ast.rfind('(', line_pos);
-        if (node_start == std::string::npos)
-            return false;
-
-        std::string_view node_type =
-            std::string_view(function_ast)
-                .substr(node_start + 1, function_ast.find_first_of(" \n[", node_start + 1) - node_start - 1);
-
-        return node_type != "comment";
-    };
-    // === ВАШ КОД ДОЛЖЕН БЫТЬ ЗДЕСЬ ===
-    //
-    // Цель: подсчитать количество строк в диапазоне [start_line + 1, end_line],
-    // которые действительно содержат код (а не только комментарии или пустые строки).
-    //
-    // Почему start_line + 1?
-    // Потому что первая строка — это строка с объявлением функции (def ...),
-    // а тело функции начинается со следующей строки (обычно с отступа).                                             std::views::filter([&](int line) { return is_code_line(line); })));
+    const std::string_view function_ast = f.ast;
+
+    // Диапазон функции обычно уже разобран при индексации файла; заново он читается из корневого узла,
+    // только если функция собрана вручную.
+    size_t root_pos = 0;
+    const auto span = f.span ? f.span : sexpr::DecodeSpan(function_ast, root_pos);
+    if (!span || span->end.line <= span->start.line)
+        return 0;
+    const size_t start_line = span->start.line;
+
+    // Строка считается кодовой, если первый узел, диапазон которого начинается или заканчивается на ней,
+    // не комментарий. Для этого AST проходится один раз, а координаты каждого узла разбираются однократно.
+    // Буфер строк переиспользуется между функциями потока, чтобы не выделять его заново для каждой.
+    enum LineKind : char { kUnseen, kCode, kComment };
+    thread_local std::vector<LineKind> lines;
+    lines.assign(span->end.line - start_line + 1, kUnseen);
+
+    language::ForEachNodeKind(function_ast, [&](std::string_view kind, size_t node_pos) {
+        const auto node_span = sexpr::DecodeSpan(function_ast, node_pos);
+        if (!node_span)
+            return;
+        const LineKind node_kind = f.language->Categorize(kind) == language::NodeCategory::Comment ? kComment : kCode;
+        for (size_t line : {node_span->start.line, node_span->end.line}) {
+            if (line >= start_line && line - start_line < lines.size() && lines[line - start_line] == kUnseen)
+                lines[line - start_line] = node_kind;
+        }
+    });
+
+    // Первая строка — это объявление функции, а тело начинается со следующей строки.
+    return static_cast<int>(rs::count(lines | rv::drop(1), kCode));
 }
 
 }  // namespace analyzer::metric::metric_impl
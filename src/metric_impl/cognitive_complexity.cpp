@@ -0,0 +1,11 @@
+#include "metric_impl/cognitive_complexity.hpp"
+
+#include "metric_impl/control_flow.hpp"
+
+namespace analyzer::metric::metric_impl {
+std::string_view CognitiveComplexityMetric::Name() const { return kName; }
+
+MetricResult::ValueType CognitiveComplexityMetric::CalculateImpl(const function::Function &f) const {
+    return GetControlFlow(f).cognitive_complexity;
+}
+}  // namespace analyzer::metric::metric_impl
@@ -0,0 +1,86 @@
+#include "metric_impl/control_flow.hpp"
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+#include "sexpr.hpp"
+
+namespace analyzer::metric::metric_impl {
+
+namespace {
+constexpr std::string_view kAlternativeField = "alternative:";
+
+class ControlFlowWalker {
+public:
+    ControlFlowWalker(const language::Language &language, std::vector<size_t> &nesting)
+        : language{language}, nesting{nesting} {
+        nesting.clear();
+    }
+
+    void OnOpen(const sexpr::Node &node) {
+        // `else if` в C++ и JavaScript — это if, первый потомок else_clause: вместе с else это одно продолжение.
+        const bool continues_else = else_depth != kNoElse && node.depth == else_depth + 1;
+        else_depth = kNoElse;
+
+        const auto category = language.Categorize(node.kind);
+        if (category == language::NodeCategory::Function || category == language::NodeCategory::Lambda) {
+            // Корень — сама анализируемая функция; вложенные функции и лямбды только углубляют своё тело.
+            if (node.depth > 0)
+                nesting.push_back(node.depth);
+            return;
+        }
+        const bool is_alternative = node.field == kAlternativeField;
+        if (category != language::NodeCategory::Branch && category != language::NodeCategory::Loop) {
+            // else-ветка без собственного условия (else_clause, block в Go).
+            if (is_alternative) {
+                summary.cognitive_complexity++;
+                else_depth = node.depth;
+            }
+            return;
+        }
+
+        summary.decision_points++;
+        if (is_alternative || continues_else) {
+            if (is_alternative)
+                summary.cognitive_complexity++;
+            return;
+        }
+        summary.cognitive_complexity += 1 + static_cast<int>(nesting.size());
+        nesting.push_back(node.depth);
+        summary.max_nesting = std::max(summary.max_nesting, static_cast<int>(nesting.size()));
+    }
+
+    void OnClose(size_t, size_t depth) {
+        if (!nesting.empty() && nesting.back() == depth)
+            nesting.pop_back();
+    }
+
+    const function::ControlFlowSummary &Get() const { return summary; }
+
+private:
+    static constexpr size_t kNoElse = static_cast<size_t>(-1);
+
+    const language::Language &language;
+    std::vector<size_t> &nesting;  // Глубины открытых узлов, увеличивающих вложенность.
+    size_t else_depth = kNoElse;   // Глубина только что открытой else-ветки без условия.
+    function::ControlFlowSummary summary;
+};
+}  // namespace
+
+function::ControlFlowSummary SummarizeControlFlow(std::string_view ast, const language::Language &language) {
+    // Стек вложенности переиспользуется между функциями потока.
+    thread_local std::vector<size_t> nesting;
+    ControlFlowWalker walker(language, nesting);
+    sexpr::WalkNodes(ast, walker);
+    return walker.Get();
+}
+
+const function::ControlFlowSummary &GetControlFlow(const function::Function &f) {
+    auto &summary = f.control_flow.summary;
+    if (!summary)
+        summary = SummarizeControlFlow(f.ast, *f.language);
+    return *summary;
+}
+
+}  // namespace analyzer::metric::metric_impl
@@ -0,0 +1,18 @@
+#include "metric_impl/fan_in_out.hpp"
+
+namespace analyzer::metric::metric_impl {
+
+std::string_view FanInMetric::Name() const { return kName; }
+
+MetricResult::ValueType FanInMetric::CalculateImpl(const function::Function &f) const {
+    const auto id = graph.Find(f);
+    return id ? graph.FanIn(*id) : 0;
+}
+
+std::string_view FanOutMetric::Name() const { return kName; }
+
+MetricResult::ValueType FanOutMetric::CalculateImpl(const function::Function &f) const {
+    const auto id = graph.Find(f);
+    return id ? graph.FanOut(*id) : 0;
+}
+}  // namespace analyzer::metric::metric_impl
@@ -0,0 +1,44 @@
+#include "metric_impl/halstead.hpp"
+
+#include <cmath>
+
+#include "metric_impl/tokens.hpp"
+
+namespace analyzer::metric::metric_impl {
+
+namespace {
+double RoundToHundredths(double value) { return std::round(value * 100) / 100; }
+}  // namespace
+
+double HalsteadVolume(const function::TokenSummary &tokens) {
+    const int vocabulary = tokens.distinct_operators + tokens.distinct_operands;
+    if (vocabulary < 2)
+        return 0;
+    return (tokens.total_operators + tokens.total_operands) * std::log2(vocabulary);
+}
+
+double HalsteadDifficulty(const function::TokenSummary &tokens) {
+    if (tokens.distinct_operands == 0)
+        return 0;
+    return tokens.distinct_operators / 2.0 * tokens.total_operands / tokens.distinct_operands;
+}
+
+std::string_view HalsteadVolumeMetric::Name() const { return kName; }
+
+MetricResult::ValueType HalsteadVolumeMetric::CalculateImpl(const function::Function &f) const {
+    return RoundToHundredths(HalsteadVolume(GetTokens(f)));
+}
+
+std::string_view HalsteadDifficultyMetric::Name() const { return kName; }
+
+MetricResult::ValueType HalsteadDifficultyMetric::CalculateImpl(const function::Function &f) const {
+    return RoundToHundredths(HalsteadDifficulty(GetTokens(f)));
+}
+
+std::string_view HalsteadEffortMetric::Name() const { return kName; }
+
+MetricResult::ValueType HalsteadEffortMetric::CalculateImpl(const function::Function &f) const {
+    const auto &tokens = GetTokens(f);
+    return RoundToHundredths(HalsteadDifficulty(tokens) * HalsteadVolume(tokens));
+}
+}  // namespace analyzer::metric::metric_impl
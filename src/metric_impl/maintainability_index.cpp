@@ -0,0 +1,24 @@
+#include "metric_impl/maintainability_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "metric_impl/control_flow.hpp"
+#include "metric_impl/halstead.hpp"
+#include "metric_impl/tokens.hpp"
+#include "sexpr.hpp"
+
+namespace analyzer::metric::metric_impl {
+std::string_view MaintainabilityIndexMetric::Name() const { return kName; }
+
+MetricResult::ValueType MaintainabilityIndexMetric::CalculateImpl(const function::Function &f) const {
+    size_t root_pos = 0;
+    const auto span = f.span ? f.span : sexpr::DecodeSpan(f.ast, root_pos);
+    const double lines = span ? static_cast<double>(span->end.line - span->start.line + 1) : 1.0;
+    const double volume = std::max(HalsteadVolume(GetTokens(f)), 1.0);
+    const double cyclomatic = 1 + GetControlFlow(f).decision_points;
+
+    const double index = 171 - 5.2 * std::log(volume) - 0.23 * cyclomatic - 16.2 * std::log(lines);
+    return std::round(std::max(0.0, index * 100 / 171) * 100) / 100;
+}
+}  // namespace analyzer::metric::metric_impl
@@ -18,43 +18,21 @@
 #include <vector>
 
 namespace analyzer::metric::metric_impl {
-std::string NamingStyleMetric::Name() const { return kName; }
+std::string_view NamingStyleMetric::Name() const { return kName; }
 
 MetricResult::ValueType NamingStyleMetric::CalculateImpl(const function::Function &f) const {
-    auto &functionName = f.name;
-    bool hasUnderscore = functionName.find('_') != std::string::npos;
-    bool hasHyphen = functionName.find('-') != std::string::npos;
-    bool hasUpper = std::any_of(functionName.begin(), functionName.end(), [](char c) { return isupper(c); });
-
-    if (hasHyphen) {
-        return "Unknown";
-    }
-
-    // Проверяем snake_case
-    if (hasUnderscore) {
-        // Должны быть только строчные буквы и подчеркивания
-        bool allLower = std::all_of(functionName.begin(), functionName.end(),
-                                    [](char c) { return islower(c) || c == '_' || isdigit(c); });
-        if (allLower) {
-            return "Snake Case";
-        }
-        return "Unknown";
-    }
-
-    // Проверяем PascalCase/CamelCase
-    if (hasUpper) {
-        // Первая буква заглавная - PascalCase
-        if (isupper(functionName[0])) {
-            return "Pascal Case";
-        }
-        // Первая буква строчная - camelCase
-        else {
-            return "Camel Case";
+    // Набор стилей конечен, поэтому их номера в словаре категорий получаются один раз.
+    static const auto kCategoryIds = [] {
+        std::array<std::array<CategoryId, naming::kStyleNames.size()>, 2> ids{};
+        for (size_t style = 0; style < naming::kStyleNames.size(); ++style) {
+            ids[0][style] = CategoryRegistry::Intern(naming::kStyleNames[style]);
+            ids[1][style] = CategoryRegistry::Intern(naming::kPrivateStyleNames[style]);
         }
-    }
-
-    // Все символы строчные без разделителей
-    return "Lower Case";
+        return ids;
+    }();
+    const auto classification = naming::Classify(f.name);
+    return MetricValue::FromCategory(
+        kCategoryIds[classification.is_private ? 1 : 0][static_cast<size_t>(classification.style)]);
 }
 
 }  // namespace analyzer::metric::metric_impl
@@ -0,0 +1,11 @@
+#include "metric_impl/nesting_depth.hpp"
+
+#include "metric_impl/control_flow.hpp"
+
+namespace analyzer::metric::metric_impl {
+std::string_view MaxNestingDepthMetric::Name() const { return kName; }
+
+MetricResult::ValueType MaxNestingDepthMetric::CalculateImpl(const function::Function &f) const {
+    return GetControlFlow(f).max_nesting;
+}
+}  // namespace analyzer::metric::metric_impl
@@ -15,39 +15,39 @@
 #include <vector>
 
 namespace analyzer::metric::metric_impl {
-std::string CountParametersMetric::Name() const { return kName; }
+std::string_view CountParametersMetric::Name() const { return kName; }
 
 MetricResult::ValueType CountParametersMetric::CalculateImpl(const function::Function &f) const {
-    auto &function_ast = f.ast;
-    // 1. Находим начало блока параметров
-    const std::string parameters_marker = "(parameters";
-    size_t params_start = function_ast.find(parameters_marker);
-    if (params_start == std::string::npos) {
+    std::string_view function_ast = f.ast;
+    // 1. Находим начало блока параметров — первый узел категории Parameters в грамматике языка функции
+    size_t params_start = std::string_view::npos;
+    language::ForEachNodeKind(function_ast, [&](std::string_view node_kind, size_t pos) {
+        if (params_start == std::string_view::npos &&
+            f.language->Categorize(node_kind) == language::NodeCategory::Parameters)
+            params_start = pos;
+    });
+    if (params_start == std::string_view::npos) {
         return 0;
     }
 
-    // 2. Находим конец блока параметров
+    // 2. Считаем непосредственные дочерние узлы блока параметров: каждый из них — отдельный параметр
+    //    (идентификатор, параметр со значением по умолчанию, *args, ...). Комментарии не считаются.
+    int count = 0;
     size_t balance = 1;
-    size_t params_end = params_start + parameters_marker.length();
-    while (params_end < function_ast.size() && balance > 0) {
-        if (function_ast[params_end] == '(')
+    size_t pos = params_start + 1;
+    while (pos < function_ast.size() && balance > 0) {
+        if (function_ast[pos] == '(') {
+            if (balance == 1) {
+                size_t kind_end = function_ast.find_first_of(" \n[()", pos + 1);
+                if (f.language->Categorize(function_ast.substr(pos + 1, kind_end - pos - 1)) !=
+                    language::NodeCategory::Comment)
+                    count++;
+            }
             balance++;
-        else if (function_ast[params_end] == ')')
+        } else if (function_ast[pos] == ')') {
             balance--;
-        params_end++;
-    }
-
-    // 3. Извлекаем подстроку с параметрами
-    std::string_view params_block(function_ast.data() + params_start, params_end - params_start);
-
-    // 4. Считаем параметры (идентификаторы или pattern-ы)
-    int count = 0;
-    size_t pos = 0;
-    const std::string id_marker = "(identifier";
-
-    while ((pos = params_block.find(id_marker, pos)) != std::string_view::npos) {
-        count++;
-        pos += id_marker.length();
+        }
+        pos++;
     }
 
     return count;
@@ -2,9 +2,53 @@
 
 #include <gtest/gtest.h>
 
+#include "file.hpp"
+#include "function.hpp"
+
 namespace analyzer::metric::metric_impl {
 
-// здесь ваш код
-TEST(BasicCheck, Sum) { EXPECT_EQ(1 + 1, 2); }
+namespace {
+int CodeLines(const function::Function &function) {
+    return static_cast<int>(CodeLinesCountMetric{}.Calculate(function).value.AsInteger());
+}
+
+function::Function ExtractSingle(const std::string &filename) {
+    file::File file(filename);
+    function::FunctionExtractor extractor;
+    auto functions = extractor.Get(file);
+    EXPECT_EQ(functions.size(), 1);
+    return functions.front();
+}
+}  // namespace
+
+TEST(CodeLinesCountTest, SkipsCommentLines) {
+    auto function = ExtractSingle("comments.py");
+    ASSERT_TRUE(function.span.has_value());
+    EXPECT_EQ(CodeLines(function), 3);
+}
+
+TEST(CodeLinesCountTest, CountsStatementsSpanningSeveralLines) {
+    EXPECT_EQ(CodeLines(ExtractSingle("many_lines.py")), 11);
+}
+
+TEST(CodeLinesCountTest, DecodesSpanFromAstWhenNotCached) {
+    function::Function function{.filename = "a.py",
+                                .class_name = std::nullopt,
+                                .name = "f",
+                                .ast = "(function_definition [10, 0] - [13, 12]\n"
+                                       "  name: (identifier [10, 4] - [10, 5])\n"
+                                       "  parameters: (parameters [10, 5] - [10, 7])\n"
+                                       "  (comment [11, 4] - [11, 13])\n"
+                                       "  body: (block [12, 4] - [13, 12]\n"
+                                       "    (expression_statement [12, 4] - [12, 9])\n"
+                                       "    (return_statement [13, 4] - [13, 12])))"};
+    EXPECT_EQ(CodeLines(function), 2);
+
+    // Закэшированный при индексации диапазон используется вместо корневого узла.
+    function.span = sexpr::Span{.start = {11, 0}, .end = {13, 12}};
+    EXPECT_EQ(CodeLines(function), 2);
+    function.span = sexpr::Span{.start = {10, 0}, .end = {12, 9}};
+    EXPECT_EQ(CodeLines(function), 1);
+}
 
 }  // namespace analyzer::metric::metric_impl
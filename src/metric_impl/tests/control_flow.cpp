@@ -0,0 +1,142 @@
+#include "metric_impl/control_flow.hpp"
+
+#include <gtest/gtest.h>
+
+#include "metric_impl/cognitive_complexity.hpp"
+#include "metric_impl/cyclomatic_complexity.hpp"
+#include "metric_impl/nesting_depth.hpp"
+
+namespace analyzer::metric::metric_impl {
+
+namespace {
+// def f(x):
+//     if x:
+//         for i in x:
+//             if i:
+//                 pass
+//     elif y:
+//         pass
+//     else:
+//         pass
+//     return a if b else c
+constexpr std::string_view kPythonAst =
+    "(function_definition [0, 0] - [9, 25]\n"
+    "  name: (identifier [0, 4] - [0, 5])\n"
+    "  parameters: (parameters [0, 5] - [0, 8] (identifier [0, 6] - [0, 7]))\n"
+    "  body: (block [1, 4] - [9, 25]\n"
+    "    (if_statement [1, 4] - [8, 12]\n"
+    "      condition: (identifier [1, 7] - [1, 8])\n"
+    "      consequence: (block [2, 8] - [4, 20]\n"
+    "        (for_statement [2, 8] - [4, 20]\n"
+    "          left: (identifier [2, 12] - [2, 13])\n"
+    "          right: (identifier [2, 17] - [2, 18])\n"
+    "          body: (block [3, 12] - [4, 20]\n"
+    "            (if_statement [3, 12] - [4, 20]\n"
+    "              condition: (identifier [3, 15] - [3, 16])\n"
+    "              consequence: (block [4, 16] - [4, 20] (pass_statement [4, 16] - [4, 20]))))))\n"
+    "      alternative: (elif_clause [5, 4] - [6, 12]\n"
+    "        condition: (identifier [5, 9] - [5, 10])\n"
+    "        consequence: (block [6, 8] - [6, 12] (pass_statement [6, 8] - [6, 12])))\n"
+    "      alternative: (else_clause [7, 4] - [8, 12]\n"
+    "        body: (block [8, 8] - [8, 12] (pass_statement [8, 8] - [8, 12]))))\n"
+    "    (return_statement [9, 4] - [9, 25]\n"
+    "      (conditional_expression [9, 11] - [9, 25]\n"
+    "        (identifier [9, 11] - [9, 12])\n"
+    "        (identifier [9, 16] - [9, 17])\n"
+    "        (identifier [9, 23] - [9, 24])))))";
+
+function::Function MakeFunction(std::string_view ast) {
+    return function::Function{.filename = "a.py",
+                              .class_name = std::nullopt,
+                              .name = "f",
+                              .ast = std::pmr::string(ast),
+                              .language = &language::LanguageForFile("a.py")};
+}
+}  // namespace
+
+TEST(ControlFlowTest, WeighsBranchesByNesting) {
+    const auto summary = SummarizeControlFlow(kPythonAst, language::Python());
+    // if, for, вложенный if, elif и тернарный оператор.
+    EXPECT_EQ(summary.decision_points, 5);
+    // if: 1, for: 1 + 1, вложенный if: 1 + 2, elif: 1, else: 1, тернарный оператор: 1.
+    EXPECT_EQ(summary.cognitive_complexity, 9);
+    EXPECT_EQ(summary.max_nesting, 3);
+}
+
+TEST(ControlFlowTest, NestedFunctionDeepensItsBody) {
+    constexpr std::string_view ast =
+        "(function_definition [0, 0] - [3, 20]\n"
+        "  body: (block [1, 4] - [3, 20]\n"
+        "    (function_definition [1, 4] - [3, 20]\n"
+        "      body: (block [2, 8] - [3, 20]\n"
+        "        (while_statement [2, 8] - [3, 20]\n"
+        "          condition: (identifier [2, 14] - [2, 15])\n"
+        "          body: (block [3, 12] - [3, 20] (pass_statement [3, 12] - [3, 20])))))))";
+    const auto summary = SummarizeControlFlow(ast, language::Python());
+    EXPECT_EQ(summary.decision_points, 1);
+    EXPECT_EQ(summary.cognitive_complexity, 2);
+    EXPECT_EQ(summary.max_nesting, 2);
+}
+
+TEST(ControlFlowTest, ArrowFunctionDeepensItsBody) {
+    // function f(x) { items.forEach((i) => { if (i) {} }); }
+    constexpr std::string_view ast =
+        "(function_declaration [0, 0] - [0, 55]\n"
+        "  name: (identifier [0, 9] - [0, 10])\n"
+        "  parameters: (formal_parameters [0, 10] - [0, 13] (identifier [0, 11] - [0, 12]))\n"
+        "  body: (statement_block [0, 14] - [0, 55]\n"
+        "    (expression_statement [0, 16] - [0, 53]\n"
+        "      (call_expression [0, 16] - [0, 52]\n"
+        "        function: (member_expression [0, 16] - [0, 29]\n"
+        "          object: (identifier [0, 16] - [0, 21])\n"
+        "          property: (property_identifier [0, 22] - [0, 29]))\n"
+        "        arguments: (arguments [0, 29] - [0, 52]\n"
+        "          (arrow_function [0, 30] - [0, 51]\n"
+        "            parameters: (formal_parameters [0, 30] - [0, 33] (identifier [0, 31] - [0, 32]))\n"
+        "            body: (statement_block [0, 37] - [0, 51]\n"
+        "              (if_statement [0, 39] - [0, 49]\n"
+        "                condition: (parenthesized_expression [0, 42] - [0, 45] (identifier [0, 43] - [0, 44]))\n"
+        "                consequence: (statement_block [0, 46] - [0, 48])))))))))";
+    const auto summary = SummarizeControlFlow(ast, language::LanguageForFile("a.js"));
+    EXPECT_EQ(summary.decision_points, 1);
+    // if внутри колбэка: 1 + 1 за вложенность в стрелочную функцию.
+    EXPECT_EQ(summary.cognitive_complexity, 2);
+    EXPECT_EQ(summary.max_nesting, 2);
+}
+
+TEST(ControlFlowTest, MetricsShareOneWalk) {
+    const auto function = MakeFunction(kPythonAst);
+    EXPECT_FALSE(function.control_flow.summary.has_value());
+
+    EXPECT_EQ(CyclomaticComplexityMetric{}.Calculate(function).value.AsInteger(), 6);
+    ASSERT_TRUE(function.control_flow.summary.has_value());
+
+    // Остальные метрики берут уже посчитанную сводку: подменённое значение доказывает, что AST не читается.
+    function.control_flow.summary->cognitive_complexity = 42;
+    EXPECT_EQ(CognitiveComplexityMetric{}.Calculate(function).value.AsInteger(), 42);
+    EXPECT_EQ(MaxNestingDepthMetric{}.Calculate(function).value.AsInteger(), 3);
+
+    // Копия функции сводку не наследует.
+    const auto copy = function;
+    EXPECT_FALSE(copy.control_flow.summary.has_value());
+}
+
+TEST(ControlFlowTest, CppElseIfIsAFlatIncrement) {
+    constexpr std::string_view ast =
+        "(function_definition [0, 0] - [4, 1]\n"
+        "  body: (compound_statement [0, 9] - [4, 1]\n"
+        "    (if_statement [1, 2] - [3, 10]\n"
+        "      condition: (condition_clause [1, 5] - [1, 8] value: (identifier [1, 6] - [1, 7]))\n"
+        "      consequence: (return_statement [1, 9] - [1, 18] (number_literal [1, 16] - [1, 17]))\n"
+        "      alternative: (else_clause [2, 2] - [3, 10]\n"
+        "        (if_statement [2, 7] - [3, 10]\n"
+        "          condition: (condition_clause [2, 10] - [2, 13] value: (identifier [2, 11] - [2, 12]))\n"
+        "          consequence: (return_statement [3, 4] - [3, 10]))))))";
+    const auto summary = SummarizeControlFlow(ast, language::LanguageForFile("a.cpp"));
+    EXPECT_EQ(summary.decision_points, 2);
+    // if: 1, else if: 1 — вложенный в else_clause if не штрафуется за вложенность.
+    EXPECT_EQ(summary.cognitive_complexity, 2);
+    EXPECT_EQ(summary.max_nesting, 1);
+}
+
+}  // namespace analyzer::metric::metric_impl
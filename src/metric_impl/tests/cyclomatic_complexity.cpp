@@ -4,6 +4,24 @@
 
 namespace analyzer::metric::metric_impl {
 
-// здесь ваш код
+TEST(CyclomaticComplexityTest, UsesLanguageNodeCategories) {
+    CyclomaticComplexityMetric metric;
+    function::Function cpp_function{.filename = "a.cpp",
+                                    .class_name = std::nullopt,
+                                    .name = "f",
+                                    .ast = "(function_definition [0, 0] - [5, 1]\n"
+                                           "  body: (compound_statement [0, 9] - [5, 1]\n"
+                                           "    (for_range_loop [1, 2] - [4, 3]\n"
+                                           "      body: (if_statement [2, 4] - [3, 5]))\n"
+                                           "    (return_statement [4, 2] - [4, 30]\n"
+                                           "      (conditional_expression [4, 9] - [4, 29]))))",
+                                    .language = &language::LanguageForFile("a.cpp")};
+    EXPECT_EQ(metric.Calculate(cpp_function).value.AsInteger(), 4);
+
+    // for_range_loop не является узлом грамматики Python
+    function::Function python_function = cpp_function;
+    python_function.language = &language::LanguageForFile("a.py");
+    EXPECT_EQ(metric.Calculate(python_function).value.AsInteger(), 3);
+}
 
 }  // namespace analyzer::metric::metric_impl
@@ -0,0 +1,136 @@
+#include "metric_impl/halstead.hpp"
+
+#include <gtest/gtest.h>
+
+#include "file.hpp"
+#include "function.hpp"
+#include "metric_impl/maintainability_index.hpp"
+#include "metric_impl/tokens.hpp"
+
+namespace analyzer::metric::metric_impl {
+
+namespace {
+// def f(a, b):
+//     return a + b * 2
+constexpr std::string_view kSource = "def f(a, b):\n    return a + b * 2";
+constexpr std::string_view kAst =
+    "(function_definition [0, 0] - [1, 20]\n"
+    "  name: (identifier [0, 4] - [0, 5])\n"
+    "  parameters: (parameters [0, 5] - [0, 11] (identifier [0, 6] - [0, 7]) (identifier [0, 9] - [0, 10]))\n"
+    "  body: (block [1, 4] - [1, 20]\n"
+    "    (return_statement [1, 4] - [1, 20]\n"
+    "      (binary_operator [1, 11] - [1, 20]\n"
+    "        left: (identifier [1, 11] - [1, 12])\n"
+    "        right: (binary_operator [1, 15] - [1, 20]\n"
+    "          left: (identifier [1, 15] - [1, 16])\n"
+    "          right: (integer [1, 19] - [1, 20]))))))";
+
+function::Function MakeFunction(std::string_view ast, std::string_view source) {
+    return {.filename = "a.py",
+            .class_name = std::nullopt,
+            .name = "f",
+            .ast = std::pmr::string(ast),
+            .language = &language::Python(),
+            .span = std::nullopt,
+            .source = std::pmr::string(source)};
+}
+
+double Value(const IMetric &metric, const function::Function &function) {
+    return metric.Calculate(function).value.AsReal();
+}
+}  // namespace
+
+TEST(TokensTest, CountsKeywordsAndSymbolsAsOperators) {
+    // Операторы: def ( , ) : return + *; операнды: f a b a b 2.
+    const auto tokens = SummarizeTokens(kSource, language::Python());
+    EXPECT_EQ(tokens.distinct_operators, 8);
+    EXPECT_EQ(tokens.total_operators, 8);
+    EXPECT_EQ(tokens.distinct_operands, 4);
+    EXPECT_EQ(tokens.total_operands, 6);
+}
+
+TEST(TokensTest, StringsAreSingleOperandsAndCommentsAreSkipped) {
+    constexpr std::string_view source =
+        "def g():\n"
+        "    \"\"\"Doc (with 'quotes')\n"
+        "    \"\"\"\n"
+        "    # note\n"
+        "    print(f\"{x}\" == 'y\\'', 1.5e-3 + 0x1F)\n"
+        "    pass";
+    // Операторы: def ( ) : ( == , + ) pass; операнды: g """...""" print f"{x}" 'y\'' 1.5e-3 0x1F.
+    const auto tokens = SummarizeTokens(source, language::Python());
+    EXPECT_EQ(tokens.total_operators, 10);
+    EXPECT_EQ(tokens.distinct_operators, 8);
+    EXPECT_EQ(tokens.total_operands, 7);
+    EXPECT_EQ(tokens.distinct_operands, 7);
+
+    // Таблицы различных лексем переиспользуются потоком, но от предыдущей функции ничего не остаётся.
+    const auto again = SummarizeTokens(kSource, language::Python());
+    EXPECT_EQ(again.distinct_operators, 8);
+    EXPECT_EQ(again.distinct_operands, 4);
+}
+
+TEST(TokensTest, UsesLexiconOfFunctionLanguage) {
+    constexpr std::string_view source = "int f(int x) {\n  /* (c) */ return x << 1;  // done\n}";
+    // Операторы: int ( int ) { return << ; }; операнды: f x x 1.
+    const auto tokens = SummarizeTokens(source, language::LanguageForFile("a.cpp"));
+    EXPECT_EQ(tokens.total_operators, 9);
+    EXPECT_EQ(tokens.distinct_operators, 8);
+    EXPECT_EQ(tokens.total_operands, 4);
+    EXPECT_EQ(tokens.distinct_operands, 3);
+}
+
+TEST(TokensTest, ManyDistinctOperandsGrowTheTable) {
+    constexpr int kItems = 500;
+    std::string source = "def f():\n    return [";
+    for (int i = 0; i < kItems; ++i)
+        source += "v" + std::to_string(i) + ",";
+    source += "]";
+
+    const auto tokens = SummarizeTokens(source, language::Python());
+    EXPECT_EQ(tokens.distinct_operands, kItems + 1);
+    EXPECT_EQ(tokens.total_operands, kItems + 1);
+    // def ( ) : return [ , ]
+    EXPECT_EQ(tokens.distinct_operators, 8);
+}
+
+TEST(TokensTest, FunctionWithoutSourceHasNoTokens) {
+    const auto tokens = SummarizeTokens("", language::Python());
+    EXPECT_EQ(tokens.total_operators + tokens.total_operands, 0);
+    EXPECT_EQ(Value(HalsteadVolumeMetric{}, MakeFunction(kAst, "")), 0.0);
+}
+
+TEST(HalsteadTest, ComputesVolumeDifficultyAndEffort) {
+    const auto function = MakeFunction(kAst, kSource);
+    // V = 14 * log2(12), D = 8 / 2 * 6 / 4, E = D * V.
+    EXPECT_DOUBLE_EQ(Value(HalsteadVolumeMetric{}, function), 50.19);
+    EXPECT_DOUBLE_EQ(Value(HalsteadDifficultyMetric{}, function), 6.0);
+    EXPECT_DOUBLE_EQ(Value(HalsteadEffortMetric{}, function), 301.14);
+    ASSERT_TRUE(function.tokens.summary.has_value());
+    EXPECT_EQ(function.tokens.summary->total_operands, 6);
+}
+
+TEST(HalsteadTest, ExtractedFunctionCarriesItsSource) {
+    file::File file("simple.py");
+    function::FunctionExtractor extractor;
+    const auto functions = extractor.Get(file);
+    ASSERT_EQ(functions.size(), 1);
+    EXPECT_TRUE(std::string_view(functions[0].source).starts_with("def test_simple():\n    x = 1"));
+
+    // Операторы: def ( ) : = = = + ( ) assert ==; операнды: test_simple x 1 y 2 z x y print z z 3.
+    EXPECT_DOUBLE_EQ(Value(HalsteadVolumeMetric{}, functions[0]), 96.0);
+    EXPECT_DOUBLE_EQ(Value(HalsteadDifficultyMetric{}, functions[0]), 6.0);
+    EXPECT_DOUBLE_EQ(Value(HalsteadEffortMetric{}, functions[0]), 576.0);
+    // (171 - 5.2 ln 96 - 0.23 * 2 - 16.2 ln 7) * 100 / 171: assert — ветвление, поэтому CC = 2.
+    EXPECT_DOUBLE_EQ(Value(MaintainabilityIndexMetric{}, functions[0]), 67.42);
+}
+
+TEST(MaintainabilityIndexTest, IsClampedToZero) {
+    EXPECT_DOUBLE_EQ(Value(MaintainabilityIndexMetric{}, MakeFunction(kAst, kSource)), 81.39);
+
+    auto huge = MakeFunction(kAst, kSource);
+    huge.span = sexpr::Span{.start = {0, 0}, .end = {1'000'000, 0}};
+    EXPECT_DOUBLE_EQ(Value(MaintainabilityIndexMetric{}, huge), 0.0);
+}
+
+}  // namespace analyzer::metric::metric_impl
@@ -2,8 +2,64 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <string_view>
+
 namespace analyzer::metric::metric_impl {
 
-// здесь ваш код
+namespace {
+constexpr std::string_view StyleOf(std::string_view name) { return naming::ToString(naming::Classify(name)); }
+
+// Классификатор constexpr, поэтому основные случаи проверяются ещё при компиляции.
+static_assert(StyleOf("snake_case_name") == "Snake Case");
+static_assert(StyleOf("camelCase") == "Camel Case");
+static_assert(StyleOf("PascalCase") == "Pascal Case");
+static_assert(StyleOf("MAX_RETRIES") == "Screaming Snake Case");
+static_assert(StyleOf("__init__") == "Dunder");
+static_assert(StyleOf("_helper") == "Private Lower Case");
+static_assert(StyleOf("kebab-case") == "Kebab Case");
+}  // namespace
+
+TEST(NamingStyleTest, ClassifiesCommonStyles) {
+    EXPECT_EQ(StyleOf("lowercase"), "Lower Case");
+    EXPECT_EQ(StyleOf("parse_v2_header"), "Snake Case");
+    EXPECT_EQ(StyleOf("getHTTPResponse"), "Camel Case");
+    EXPECT_EQ(StyleOf("HttpServer"), "Pascal Case");
+    EXPECT_EQ(StyleOf("HTTP2"), "Screaming Snake Case");
+    EXPECT_EQ(StyleOf("with-many-parts"), "Kebab Case");
+}
+
+TEST(NamingStyleTest, HandlesUnderscorePrefixesAndSuffixes) {
+    EXPECT_EQ(StyleOf("__eq__"), "Dunder");
+    EXPECT_EQ(StyleOf("__mangled_name"), "Private Snake Case");
+    EXPECT_EQ(StyleOf("_PrivateClass"), "Private Pascal Case");
+    EXPECT_EQ(StyleOf("_CONSTANT"), "Private Screaming Snake Case");
+    // Хвостовое подчёркивание обходит ключевые слова и на стиль не влияет.
+    EXPECT_EQ(StyleOf("class_"), "Lower Case");
+}
+
+TEST(NamingStyleTest, RejectsMixedAndInvalidNames) {
+    EXPECT_EQ(StyleOf(""), "Unknown");
+    EXPECT_EQ(StyleOf("___"), "Unknown");
+    EXPECT_EQ(StyleOf("mixed_Style"), "Unknown");
+    EXPECT_EQ(StyleOf("kebab-With-Upper"), "Unknown");
+    EXPECT_EQ(StyleOf("snake_and-kebab"), "Unknown");
+    EXPECT_EQ(StyleOf("trailing-"), "Unknown");
+    EXPECT_EQ(StyleOf("1st_place"), "Unknown");
+    EXPECT_EQ(StyleOf("имя"), "Unknown");
+}
+
+TEST(NamingStyleTest, MetricReturnsCategoricalValue) {
+    NamingStyleMetric metric;
+    function::Function function{.filename = "a.py",
+                                .class_name = std::nullopt,
+                                .name = "_load_config",
+                                .ast = "(function_definition [0, 0] - [1, 8])",
+                                .language = &language::LanguageForFile("a.py")};
+    auto result = metric.Calculate(function);
+    EXPECT_EQ(std::string_view(result.metric_name), NamingStyleMetric::kName);
+    ASSERT_EQ(result.value.GetKind(), MetricValue::Kind::Category);
+    EXPECT_EQ(result.value.CategoryName(), "Private Snake Case");
+}
 
 }  // namespace analyzer::metric::metric_impl
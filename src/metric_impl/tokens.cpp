@@ -0,0 +1,242 @@
+#include "metric_impl/tokens.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace analyzer::metric::metric_impl {
+
+namespace {
+// Многосимвольные знаки операций; остальные знаки считаются по одному символу.
+constexpr std::array<std::string_view, 10> kThreeCharSymbols = {"**=", "//=", ">>=", "<<=", "...",
+                                                                 "<=>", "->*", "===", "!==", ">>>"};
+constexpr std::array<std::string_view, 27> kTwoCharSymbols = {"->", "==", "!=", "<=", ">=", "**", "//",
+                                                               "<<", ">>", "+=", "-=", "*=", "/=", "%=",
+                                                               "&=", "|=", "^=", "@=", ":=", "&&", "||",
+                                                               "::", "++", "--", "=>", "?.", "??"};
+
+constexpr bool IsWordChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' ||
+           static_cast<unsigned char>(c) >= 0x80;
+}
+
+constexpr bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+constexpr bool IsQuote(char c) { return c == '"' || c == '\'' || c == '`'; }
+
+// Второй символ всех многосимвольных знаков; по нему отсекаются одиночные знаки без поиска в таблицах.
+constexpr std::string_view kContinuationChars = "=<>*/&|:+-.?";
+
+size_t SymbolLength(std::string_view text) {
+    if (text.size() < 2 || kContinuationChars.find(text[1]) == std::string_view::npos)
+        return 1;
+    if (text.size() >= 3 && rs::find(kThreeCharSymbols, text.substr(0, 3)) != kThreeCharSymbols.end())
+        return 3;
+    if (text.size() >= 2 && rs::find(kTwoCharSymbols, text.substr(0, 2)) != kTwoCharSymbols.end())
+        return 2;
+    return 1;
+}
+
+/**
+ * Множество различных лексем: открытая адресация по степени двойки. Очистка лишь увеличивает номер
+ * поколения, а слоты прошлых функций считаются пустыми, поэтому память таблицы переиспользуется.
+ */
+class TokenSet {
+public:
+    void Clear() {
+        size = 0;
+        if (++generation == 0) {
+            rs::fill(slots, Slot{});
+            generation = 1;
+        }
+    }
+
+    void Insert(std::string_view token) {
+        if ((size + 1) * 2 > slots.size())
+            Grow();
+        const size_t mask = slots.size() - 1;
+        for (size_t i = std::hash<std::string_view>{}(token) & mask;; i = (i + 1) & mask) {
+            Slot &slot = slots[i];
+            if (slot.generation != generation) {
+                slot = {.token = token, .generation = generation};
+                size++;
+                return;
+            }
+            if (slot.token == token)
+                return;
+        }
+    }
+
+    int Size() const { return static_cast<int>(size); }
+
+private:
+    struct Slot {
+        std::string_view token;
+        std::uint32_t generation = 0;
+    };
+
+    void Grow() {
+        std::vector<Slot> old(std::max<size_t>(slots.size() * 2, 64));
+        old.swap(slots);
+        size = 0;
+        for (const Slot &slot : old) {
+            if (slot.generation == generation)
+                Insert(slot.token);
+        }
+    }
+
+    std::vector<Slot> slots;
+    std::uint32_t generation = 1;
+    size_t size = 0;
+};
+
+// Таблицы, которые поток переиспользует от функции к функции. Они живут дольше арены любого файла,
+// поэтому используют обычный распределитель, а не ресурс функции.
+struct Scratch {
+    TokenSet operators;
+    TokenSet operands;
+};
+
+// Передаёт каждую лексему в sink(text, kind); шаблон, чтобы обработчик встраивался в цикл разбора.
+template <typename Sink>
+class Lexer {
+public:
+    Lexer(std::string_view source, const language::Lexicon &lexicon, Sink &sink)
+        : source{source},
+          lexicon{lexicon},
+          sink{sink},
+          comment_start{lexicon.line_comment.empty() ? '\0' : lexicon.line_comment.front()} {}
+
+    void Run() {
+        while (pos < source.size()) {
+            const char c = source[pos];
+            const size_t start = pos;
+            if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\\') {
+                pos++;
+            } else if ((c == comment_start || c == '/') && SkipComment()) {
+                continue;
+            } else if (IsQuote(c)) {
+                SkipString();
+                Add(start, TokenKind::Literal);
+            } else if (IsDigit(c)) {
+                SkipNumber();
+                Add(start, TokenKind::Literal);
+            } else if (IsWordChar(c)) {
+                while (pos < source.size() && IsWordChar(source[pos]))
+                    pos++;
+                const std::string_view word = source.substr(start, pos - start);
+                // Короткое слово вплотную к кавычке — префикс строки: f"...", rb'...', u8"...".
+                if (pos < source.size() && IsQuote(source[pos]) && word.size() <= 2) {
+                    SkipString();
+                    Add(start, TokenKind::Literal);
+                } else if (c >= 'a' && c <= 'z' && lexicon.IsKeyword(word)) {
+                    Add(start, TokenKind::Operator);
+                } else {
+                    Add(start, TokenKind::Identifier);
+                }
+            } else {
+                pos += SymbolLength(source.substr(pos));
+                Add(start, TokenKind::Operator);
+            }
+        }
+    }
+
+private:
+    bool SkipComment() {
+        const std::string_view rest = source.substr(pos);
+        if (!lexicon.line_comment.empty() && rest.starts_with(lexicon.line_comment)) {
+            pos = std::min(source.find('\n', pos), source.size());
+            return true;
+        }
+        if (lexicon.block_comments && rest.starts_with("/*")) {
+            const size_t end = source.find("*/", pos + 2);
+            pos = end == std::string_view::npos ? source.size() : end + 2;
+            return true;
+        }
+        return false;
+    }
+
+    // Строка заканчивается парной кавычкой; обратная косая черта экранирует следующий символ.
+    void SkipString() {
+        const char quote = source[pos];
+        if (lexicon.triple_quoted_strings && pos + 2 < source.size() && source[pos + 1] == quote &&
+            source[pos + 2] == quote) {
+            const char triple[] = {quote, quote, quote};
+            const size_t end = source.find(std::string_view(triple, 3), pos + 3);
+            pos = end == std::string_view::npos ? source.size() : end + 3;
+            return;
+        }
+        for (pos++; pos < source.size(); pos++) {
+            if (source[pos] == '\\') {
+                pos++;
+            } else if (source[pos] == quote) {
+                pos++;
+                return;
+            } else if (source[pos] == '\n' && quote != '`') {
+                return;
+            }
+        }
+        pos = std::min(pos, source.size());
+    }
+
+    // Число вместе с точкой, суффиксами и знаком порядка: 1.5e-3, 0x1F, 10_000u.
+    void SkipNumber() {
+        const bool hex = source.substr(pos, 2) == "0x" || source.substr(pos, 2) == "0X";
+        for (pos++; pos < source.size(); pos++) {
+            const char c = source[pos];
+            const bool exponent_sign = !hex && (c == '+' || c == '-') && (source[pos - 1] | 0x20) == 'e';
+            if (!IsWordChar(c) && c != '.' && !exponent_sign)
+                return;
+        }
+    }
+
+    void Add(size_t start, TokenKind kind) { sink(source.substr(start, pos - start), kind); }
+
+    std::string_view source;
+    const language::Lexicon &lexicon;
+    Sink &sink;
+    char comment_start;  // Первый символ строчного комментария.
+    size_t pos = 0;
+};
+}  // namespace
+
+function::TokenSummary SummarizeTokens(std::string_view source, const language::Language &language) {
+    thread_local Scratch scratch;
+    scratch.operators.Clear();
+    scratch.operands.Clear();
+
+    function::TokenSummary summary;
+    auto count = [&summary](std::string_view token, TokenKind kind) {
+        if (kind == TokenKind::Operator) {
+            summary.total_operators++;
+            scratch.operators.Insert(token);
+        } else {
+            summary.total_operands++;
+            scratch.operands.Insert(token);
+        }
+    };
+    Lexer lexer(source, language.lexicon, count);
+    lexer.Run();
+    summary.distinct_operators = scratch.operators.Size();
+    summary.distinct_operands = scratch.operands.Size();
+    return summary;
+}
+
+void Tokenize(std::string_view source, const language::Language &language, std::vector<Token> &tokens) {
+    tokens.clear();
+    auto append = [&tokens](std::string_view text, TokenKind kind) { tokens.push_back({.text = text, .kind = kind}); };
+    Lexer lexer(source, language.lexicon, append);
+    lexer.Run();
+}
+
+const function::TokenSummary &GetTokens(const function::Function &f) {
+    auto &summary = f.tokens.summary;
+    if (!summary)
+        summary = SummarizeTokens(f.source, *f.language);
+    return *summary;
+}
+
+}  // namespace analyzer::metric::metric_impl
@@ -0,0 +1,48 @@
+#include "metric_value.hpp"
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace analyzer::metric {
+
+namespace {
+struct Registry {
+    std::shared_mutex mutex;
+    std::deque<std::string> names;  // deque не перемещает строки при росте, поэтому ключи-string_view живы.
+    std::unordered_map<std::string_view, CategoryId> ids;
+};
+
+Registry &GetRegistry() {
+    static Registry registry;
+    return registry;
+}
+}  // namespace
+
+CategoryId CategoryRegistry::Intern(std::string_view name) {
+    Registry &registry = GetRegistry();
+    {
+        std::shared_lock lock(registry.mutex);
+        if (auto it = registry.ids.find(name); it != registry.ids.end())
+            return it->second;
+    }
+    std::unique_lock lock(registry.mutex);
+    if (auto it = registry.ids.find(name); it != registry.ids.end())
+        return it->second;
+    const auto id = static_cast<CategoryId>(registry.names.size());
+    registry.ids.emplace(registry.names.emplace_back(name), id);
+    return id;
+}
+
+std::string_view CategoryRegistry::Name(CategoryId id) {
+    Registry &registry = GetRegistry();
+    std::shared_lock lock(registry.mutex);
+    if (id >= registry.names.size())
+        throw std::out_of_range("Unknown metric category id " + std::to_string(id));
+    return registry.names[id];
+}
+
+}  // namespace analyzer::metric
@@ -0,0 +1,102 @@
+#include "policy.hpp"
+
+#include <fnmatch.h>
+
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace analyzer::policy {
+
+namespace {
+std::string_view Trim(std::string_view text) {
+    const size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string_view::npos)
+        return {};
+    return text.substr(begin, text.find_last_not_of(" \t\r") - begin + 1);
+}
+
+std::invalid_argument ParseError(size_t line, const std::string &what) {
+    return std::invalid_argument("Policy line " + std::to_string(line) + ": " + what);
+}
+}  // namespace
+
+Policy Policy::Parse(std::istream &in) {
+    Policy policy;
+    std::string glob = "*";
+    size_t line_number = 0;
+    for (std::string raw_line; std::getline(in, raw_line);) {
+        line_number++;
+        const std::string_view line = Trim(raw_line);
+        if (line.empty() || line.starts_with('#'))
+            continue;
+        if (line.starts_with('[')) {
+            if (!line.ends_with(']') || Trim(line.substr(1, line.size() - 2)).empty())
+                throw ParseError(line_number, "expected '[glob]'");
+            glob = Trim(line.substr(1, line.size() - 2));
+            continue;
+        }
+
+        const size_t equals = line.rfind('=');
+        if (equals == std::string_view::npos)
+            throw ParseError(line_number, "expected 'Metric name = threshold'");
+        const std::string_view metric = Trim(line.substr(0, equals));
+        const std::string_view threshold_text = Trim(line.substr(equals + 1));
+        double threshold = 0;
+        const auto [end, error] =
+            std::from_chars(threshold_text.data(), threshold_text.data() + threshold_text.size(), threshold);
+        if (metric.empty() || error != std::errc{} || end != threshold_text.data() + threshold_text.size())
+            throw ParseError(line_number, "expected 'Metric name = threshold'");
+
+        policy.rules_by_metric[std::string(metric)].push_back(policy.rules.size());
+        policy.rules.push_back(
+            {.glob = glob, .metric = std::string(metric), .threshold = threshold, .line = line_number});
+    }
+    return policy;
+}
+
+void Policy::RequireKnownMetrics(const std::function<bool(std::string_view)> &is_known) const {
+    for (const auto &rule : rules) {
+        if (!is_known(rule.metric))
+            throw ParseError(rule.line, "unknown metric '" + rule.metric + "'");
+    }
+}
+
+Policy Policy::Load(const std::string &path) {
+    std::ifstream in(path);
+    if (!in)
+        throw std::invalid_argument("Can't open policy file " + path);
+    return Parse(in);
+}
+
+std::vector<Violation> Policy::Check(std::string_view filename, const metric::MetricResults &results) const {
+    std::vector<Violation> violations;
+    const std::string path(filename);
+    for (const auto &result : results) {
+        const auto it = rules_by_metric.find(std::string_view(result.metric_name));
+        if (it == rules_by_metric.end())
+            continue;
+        double value = 0;
+        if (result.value.GetKind() == metric::MetricValue::Kind::Integer)
+            value = static_cast<double>(result.value.AsInteger());
+        else if (result.value.GetKind() == metric::MetricValue::Kind::Real)
+            value = result.value.AsReal();
+        else
+            continue;
+
+        // Действует последнее подходящее правило метрики.
+        for (auto rule_id = it->second.rbegin(); rule_id != it->second.rend(); ++rule_id) {
+            const Rule &rule = rules[*rule_id];
+            if (::fnmatch(rule.glob.c_str(), path.c_str(), 0) != 0)
+                continue;
+            if (value > rule.threshold)
+                violations.push_back({.rule = &rule, .value = value});
+            break;
+        }
+    }
+    return violations;
+}
+
+}  // namespace analyzer::policy
@@ -0,0 +1,90 @@
+#include "prefetcher.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace analyzer::file {
+
+namespace {
+std::optional<std::string> ReadWholeFile(const std::string &filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        return std::nullopt;
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+}  // namespace
+
+Prefetcher::Prefetcher(std::vector<std::string> filenames, const BatchParser &parser, size_t depth)
+    : filenames{std::move(filenames)}, parser{parser}, queue{depth}, reader{[this] { Run(); }} {}
+
+Prefetcher::~Prefetcher() {
+    // Если потребитель остановился раньше (например, из-за исключения), освобождаем поток, ждущий места.
+    queue.Close();
+    reader.join();
+}
+
+std::optional<PrefetchedFile> Prefetcher::Next() {
+    auto file = queue.Pop();
+    if (!file && error)
+        std::rethrow_exception(error);
+    return file;
+}
+
+void Prefetcher::Run() {
+    try {
+        // Небольшой запуск делится хотя бы на два пакета на процесс, чтобы первые файлы пошли в анализ
+        // после доли разбора, а не после разбора всех файлов одним пакетом.
+        const size_t jobs = std::max<size_t>(1, parser.jobs);
+        const size_t batch_size = std::clamp<size_t>((filenames.size() + 2 * jobs - 1) / (2 * jobs), 1,
+                                                     std::max<size_t>(1, parser.batch_size));
+        const BatchParser batch_parser(batch_size, 1);
+
+        // Разбираемые пакеты в порядке файлов: первый из них забирается, как только разобран.
+        std::deque<std::pair<size_t, std::future<BatchParser::ParsedAsts>>> running;
+        size_t next = 0;
+        while (next < filenames.size() || !running.empty()) {
+            while (running.size() < jobs && next < filenames.size()) {
+                std::vector<std::string> batch(filenames.begin() + next,
+                                               filenames.begin() + std::min(filenames.size(), next + batch_size));
+                running.emplace_back(next, std::async(std::launch::async, [&batch_parser, batch = std::move(batch)] {
+                                         return batch_parser.Parse(batch);
+                                     }));
+                next = std::min(filenames.size(), next + batch_size);
+            }
+            auto [first, batch] = std::move(running.front());
+            running.pop_front();
+
+            // Исходники пакета читаются, пока он и следующие пакеты ещё разбираются.
+            const size_t count = std::min(batch_size, filenames.size() - first);
+            std::vector<std::optional<std::string>> sources;
+            sources.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+                sources.push_back(ReadWholeFile(filenames[first + i]));
+
+            auto parsed = std::make_shared<const BatchParser::ParsedAsts>(batch.get());
+            for (size_t i = 0; i < count; ++i) {
+                PrefetchedFile file{.filename = filenames[first + i],
+                                    .source = std::move(sources[i]),
+                                    .ast = parsed->asts[i],
+                                    .parsed = parsed,
+                                    .parse_time = parsed->parse_times[i]};
+                // Деструкторы оставшихся std::future дожидаются уже запущенных пакетов.
+                if (!queue.Push(std::move(file)))
+                    return;
+            }
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+    queue.Close();
+}
+
+}  // namespace analyzer::file
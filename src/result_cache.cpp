@@ -0,0 +1,158 @@
+#include "result_cache.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace analyzer::metric {
+
+namespace rs = std::ranges;
+
+namespace {
+constexpr std::uint64_t kFnvOffset = 14695981039346656037ull;
+constexpr std::uint64_t kFnvPrime = 1099511628211ull;
+
+ResultCache::Location MakeLocation(const function::Function &f) {
+    return {.filename = std::string(f.filename),
+            .qualified_name = function::QualifiedName(f),
+            .line = f.span ? f.span->start.line + 1 : 0};
+}
+}  // namespace
+
+Fingerprint FingerprintFunction(const function::Function &f) {
+    Fingerprint hash = kFnvOffset;
+    auto mix = [&hash](unsigned char byte) { hash = (hash ^ byte) * kFnvPrime; };
+    auto mix_text = [&mix](std::string_view text) {
+        rs::for_each(text, mix);
+        mix('\0');
+    };
+    mix_text(f.language->name);
+    mix_text(f.name);
+
+    const std::string_view ast = f.ast;
+    std::optional<size_t> first_line;
+    bool pending_space = false;
+    for (size_t pos = 0; pos < ast.size(); ++pos) {
+        const char c = ast[pos];
+        if (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+            pending_space = true;
+            continue;
+        }
+        if (pending_space) {
+            mix(' ');
+            pending_space = false;
+        }
+        if (c != '[') {
+            mix(c);
+            continue;
+        }
+
+        // Из координаты "[row, col]" в отпечаток идёт только строка относительно начала функции.
+        size_t line = 0;
+        auto [line_end, error] = std::from_chars(ast.data() + pos + 1, ast.data() + ast.size(), line);
+        size_t close = ast.find(']', pos);
+        if (close == std::string_view::npos)
+            break;
+        if (error == std::errc{}) {
+            if (!first_line)
+                first_line = line;
+            for (size_t delta = line - *first_line; delta > 0; delta >>= 8)
+                mix(static_cast<unsigned char>(delta & 0xff));
+        }
+        mix(']');
+        pos = close;
+    }
+
+    // Метрики Холстеда читают текст лексем (`a + b` и `a * b` дают одинаковый AST), поэтому исходник
+    // тоже входит в отпечаток; пробелы схлопываются, чтобы отступ функции на отпечаток не влиял.
+    mix('\0');
+    const std::string_view source = f.source;
+    const size_t first = source.find_first_not_of(" \n\r\t");
+    pending_space = false;
+    for (const char c : source.substr(std::min(first, source.size()))) {
+        if (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+            pending_space = true;
+            continue;
+        }
+        if (pending_space) {
+            mix(' ');
+            pending_space = false;
+        }
+        mix(c);
+    }
+    return hash;
+}
+
+double ResultCache::Stats::HitRate() const {
+    return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+}
+
+std::optional<MetricResults> ResultCache::Find(Fingerprint fingerprint, std::pmr::memory_resource *resource) const {
+    const Shard &shard = ShardFor(fingerprint);
+    std::lock_guard lock(shard.mutex);
+    auto it = shard.entries.find(fingerprint);
+    if (it == shard.entries.end())
+        return std::nullopt;
+    MetricResults results{resource};
+    results.reserve(it->second.results.size());
+    rs::copy(it->second.results, std::back_inserter(results));
+    return results;
+}
+
+void ResultCache::Record(Fingerprint fingerprint, const function::Function &f, const MetricResults &results) {
+    Shard &shard = ShardFor(fingerprint);
+    std::lock_guard lock(shard.mutex);
+    auto [it, inserted] = shard.entries.try_emplace(fingerprint);
+    if (inserted) {
+        // Результаты копируются в обычную кучу, а не в арену файла, из которой они пришли.
+        it->second.results.assign(results.begin(), results.end());
+        misses.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        hits.fetch_add(1, std::memory_order_relaxed);
+    }
+    it->second.locations.insert(MakeLocation(f));
+}
+
+ResultCache::Stats ResultCache::GetStats() const {
+    return {.hits = hits.load(std::memory_order_relaxed), .misses = misses.load(std::memory_order_relaxed)};
+}
+
+void ResultCache::BeginAnalysis() {
+    for (auto &shard : shards) {
+        std::lock_guard lock(shard.mutex);
+        // Каждая записанная функция оставляет место, поэтому запись без мест в прошлом анализе не встречалась.
+        std::erase_if(shard.entries, [](const auto &item) { return item.second.locations.empty(); });
+        for (auto &[fingerprint, entry] : shard.entries) {
+            entry.locations.clear();
+        }
+    }
+    hits.store(0, std::memory_order_relaxed);
+    misses.store(0, std::memory_order_relaxed);
+}
+
+std::vector<ResultCache::Cluster> ResultCache::DuplicateClusters() const {
+    std::vector<Cluster> clusters;
+    for (const auto &shard : shards) {
+        std::lock_guard lock(shard.mutex);
+        for (const auto &[fingerprint, entry] : shard.entries) {
+            // Места уже упорядочены, поэтому отчёт не зависит от расписания потоков.
+            if (entry.locations.size() > 1)
+                clusters.push_back({.fingerprint = fingerprint,
+                                    .locations = std::vector(entry.locations.begin(), entry.locations.end())});
+        }
+    }
+    rs::sort(clusters, [](const Cluster &lhs, const Cluster &rhs) {
+        if (lhs.locations.size() != rhs.locations.size())
+            return lhs.locations.size() > rhs.locations.size();
+        return lhs.locations.front() < rhs.locations.front();
+    });
+    return clusters;
+}
+
+}  // namespace analyzer::metric
@@ -0,0 +1,141 @@
+#include "sampling.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+
+namespace analyzer::sampling {
+
+namespace {
+constexpr std::uint64_t kFnvOffset = 14695981039346656037ull;
+constexpr std::uint64_t kFnvPrime = 1099511628211ull;
+// Квантиль нормального распределения для двустороннего 95% интервала.
+constexpr double kZ95 = 1.959963984540054;
+
+// Финализатор splitmix64: близкие хэши путей дают независимые на вид ключи.
+std::uint64_t Mix(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+std::uint64_t SampleKey(std::string_view path, std::uint64_t seed) {
+    std::uint64_t hash = kFnvOffset;
+    for (const unsigned char byte : path)
+        hash = (hash ^ byte) * kFnvPrime;
+    return Mix(hash ^ Mix(seed));
+}
+}  // namespace
+
+size_t SampleSize(size_t population, double rate) {
+    if (!(rate > 0 && rate <= 1))
+        throw std::invalid_argument("Sample rate must be in (0, 1]");
+    if (population == 0)
+        return 0;
+    return std::clamp<size_t>(static_cast<size_t>(std::ceil(rate * static_cast<double>(population))), 1, population);
+}
+
+std::vector<std::string> SampleFiles(const std::vector<std::string> &files, size_t count, std::uint64_t seed) {
+    if (count >= files.size())
+        return files;
+
+    std::vector<std::pair<std::uint64_t, size_t>> keys;
+    keys.reserve(files.size());
+    for (size_t i = 0; i < files.size(); ++i)
+        keys.emplace_back(SampleKey(files[i], seed), i);
+    // Номер файла разрешает совпадения ключей, так что выбор однозначен.
+    std::ranges::nth_element(keys, keys.begin() + static_cast<std::ptrdiff_t>(count));
+    keys.resize(count);
+    std::ranges::sort(keys, {}, &std::pair<std::uint64_t, size_t>::second);
+
+    std::vector<std::string> sample;
+    sample.reserve(count);
+    for (const auto &[key, index] : keys)
+        sample.push_back(files[index]);
+    return sample;
+}
+
+TotalEstimator::TotalEstimator(size_t population, size_t sample_size)
+    : population{population}, sample_size{sample_size} {
+    if (sample_size > population)
+        throw std::invalid_argument("Sample is larger than the population");
+}
+
+void TotalEstimator::Add(const function::Function &function, const metric::MetricResults &results) {
+    if (std::string_view(function.filename) != current_file) {
+        FlushFile();
+        current_file = function.filename;
+    }
+    for (const auto &result : results) {
+        switch (result.value.GetKind()) {
+        case metric::MetricValue::Kind::Integer:
+            file_values[std::string(result.metric_name)] += static_cast<double>(result.value.AsInteger());
+            break;
+        case metric::MetricValue::Kind::Real:
+            file_values[std::string(result.metric_name)] += result.value.AsReal();
+            break;
+        case metric::MetricValue::Kind::Category: {
+            std::string key(result.metric_name);
+            key += '\0';
+            key += result.value.CategoryName();
+            file_values[key] += 1;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+void TotalEstimator::Finalize() {
+    FlushFile();
+    current_file.clear();
+}
+
+void TotalEstimator::FlushFile() {
+    for (const auto &[key, value] : file_values) {
+        Totals &entry = totals[key];
+        entry.sum += value;
+        entry.sum_squares += value * value;
+    }
+    file_values.clear();
+}
+
+Estimate TotalEstimator::Extrapolate(const Totals &entry) const {
+    if (sample_size == 0)
+        return {.total = 0, .margin = population == 0 ? 0 : std::numeric_limits<double>::infinity()};
+    const double n = static_cast<double>(sample_size);
+    const double big_n = static_cast<double>(population);
+    const double mean = entry.sum / n;
+    if (sample_size == population)
+        return {.total = entry.sum, .margin = 0};
+    if (sample_size < 2)
+        return {.total = big_n * mean, .margin = std::numeric_limits<double>::infinity()};
+
+    const double variance = std::max(0.0, (entry.sum_squares - n * mean * mean) / (n - 1));
+    const double standard_error = big_n * std::sqrt((1 - n / big_n) * variance / n);
+    return {.total = big_n * mean, .margin = kZ95 * standard_error};
+}
+
+Estimate TotalEstimator::Sum(std::string_view metric) const {
+    const auto it = totals.find(std::string(metric));
+    return Extrapolate(it == totals.end() ? Totals{} : it->second);
+}
+
+std::vector<std::pair<std::string, Estimate>> TotalEstimator::Categories(std::string_view metric) const {
+    std::vector<std::pair<std::string, Estimate>> categories;
+    for (const auto &[key, entry] : totals) {
+        const std::string_view name = key;
+        if (name.size() > metric.size() && name.starts_with(metric) && name[metric.size()] == '\0')
+            categories.emplace_back(name.substr(metric.size() + 1), Extrapolate(entry));
+    }
+    std::ranges::sort(categories, [](const auto &lhs, const auto &rhs) {
+        return std::tie(rhs.second.total, lhs.first) < std::tie(lhs.second.total, rhs.first);
+    });
+    return categories;
+}
+
+}  // namespace analyzer::sampling
@@ -0,0 +1,212 @@
+#include "server.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace analyzer::server {
+
+namespace {
+std::runtime_error SystemError(const std::string &what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+sockaddr_un MakeAddress(const std::string &socket_path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Socket path is too long: " + socket_path);
+    }
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+    return address;
+}
+
+// Закрывает дескриптор при выходе из области видимости.
+struct Descriptor {
+    explicit Descriptor(int fd) : fd{fd} {}
+    ~Descriptor() {
+        if (fd != -1)
+            close(fd);
+    }
+    Descriptor(const Descriptor &) = delete;
+    Descriptor &operator=(const Descriptor &) = delete;
+    int fd;
+};
+
+// MSG_NOSIGNAL: если собеседник уже закрыл сокет, send возвращает EPIPE, а не убивает процесс сигналом SIGPIPE.
+void WriteAll(int fd, std::string_view data) {
+    while (!data.empty()) {
+        ssize_t written = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (written == -1 && errno == EINTR)
+            continue;
+        if (written == -1)
+            throw SystemError("Failed to write to socket");
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+}
+
+std::string ReadAll(int fd) {
+    std::string data;
+    char buffer[64 * 1024];
+    while (true) {
+        ssize_t read_bytes = read(fd, buffer, sizeof(buffer));
+        if (read_bytes == -1 && errno == EINTR)
+            continue;
+        if (read_bytes == -1)
+            throw SystemError("Failed to read from socket");
+        if (read_bytes == 0)
+            return data;
+        data.append(buffer, static_cast<size_t>(read_bytes));
+    }
+}
+
+// Читает из сокета значения, завершённые '\0'.
+class FieldReader {
+public:
+    explicit FieldReader(int fd) : fd{fd} {}
+
+    std::string Next() {
+        size_t end;
+        while ((end = buffer.find('\0', pos)) == std::string::npos) {
+            char chunk[4096];
+            ssize_t read_bytes = read(fd, chunk, sizeof(chunk));
+            if (read_bytes == -1 && errno == EINTR)
+                continue;
+            if (read_bytes <= 0)
+                throw std::runtime_error("Incomplete request");
+            buffer.append(chunk, static_cast<size_t>(read_bytes));
+        }
+        std::string field = buffer.substr(pos, end - pos);
+        pos = end + 1;
+        return field;
+    }
+
+private:
+    int fd;
+    std::string buffer;
+    size_t pos = 0;
+};
+}  // namespace
+
+Server::Server(std::string socket_path, RequestHandler handler)
+    : socket_path{std::move(socket_path)}, handler{std::move(handler)} {
+    const sockaddr_un address = MakeAddress(this->socket_path);
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd == -1)
+        throw SystemError("Failed to create socket");
+
+    std::filesystem::remove(this->socket_path);
+    if (bind(listen_fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == -1 ||
+        listen(listen_fd, SOMAXCONN) == -1) {
+        auto error = SystemError("Failed to listen on " + this->socket_path);
+        close(listen_fd);
+        throw error;
+    }
+}
+
+Server::~Server() {
+    close(listen_fd);
+    std::filesystem::remove(socket_path);
+}
+
+void Server::ServeOne() {
+    Descriptor connection(accept(listen_fd, nullptr, nullptr));
+    if (connection.fd == -1) {
+        if (errno == EINTR)
+            return;
+        throw SystemError("Failed to accept connection");
+    }
+
+    std::string report;
+    int exit_code = 1;
+    try {
+        FieldReader reader(connection.fd);
+        const std::string working_directory = reader.Next();
+        const std::string count_field = reader.Next();
+        size_t count = 0;
+        std::from_chars(count_field.data(), count_field.data() + count_field.size(), count);
+        std::vector<std::string> args;
+        args.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            args.push_back(reader.Next());
+        }
+
+        std::filesystem::current_path(working_directory);
+
+        // Отчёт собирается в памяти: обработчик пишет в FILE*, как и при обычном запуске в stdout.
+        char *buffer = nullptr;
+        size_t size = 0;
+        std::FILE *out = open_memstream(&buffer, &size);
+        if (!out)
+            throw SystemError("Failed to open report stream");
+        try {
+            exit_code = handler(args, out);
+        } catch (const std::exception &e) {
+            std::fprintf(out, "Error: %s\n", e.what());
+            exit_code = 1;
+        }
+        std::fclose(out);
+        report.assign(buffer, size);
+        std::free(buffer);
+    } catch (const std::exception &e) {
+        report = std::string("Error: ") + e.what() + "\n";
+        exit_code = 1;
+    }
+
+    report.push_back('\0');
+    report += std::to_string(exit_code);
+    try {
+        WriteAll(connection.fd, report);
+    } catch (const std::exception &) {
+        // Клиент отключился, не дождавшись ответа: демон продолжает работу.
+    }
+}
+
+void Server::ServeForever() {
+    while (true) {
+        ServeOne();
+    }
+}
+
+int RunClient(const std::string &socket_path, const std::vector<std::string> &args, std::FILE *out) {
+    const sockaddr_un address = MakeAddress(socket_path);
+    Descriptor connection(socket(AF_UNIX, SOCK_STREAM, 0));
+    if (connection.fd == -1)
+        throw SystemError("Failed to create socket");
+    if (connect(connection.fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == -1)
+        throw SystemError("Failed to connect to " + socket_path);
+
+    std::string request = std::filesystem::current_path().string();
+    request.push_back('\0');
+    request += std::to_string(args.size());
+    request.push_back('\0');
+    for (const auto &arg : args) {
+        request += arg;
+        request.push_back('\0');
+    }
+    WriteAll(connection.fd, request);
+    shutdown(connection.fd, SHUT_WR);
+
+    const std::string response = ReadAll(connection.fd);
+    const size_t separator = response.rfind('\0');
+    if (separator == std::string::npos)
+        throw std::runtime_error("Malformed response from " + socket_path);
+
+    std::fwrite(response.data(), 1, separator, out);
+    int exit_code = 1;
+    std::from_chars(response.data() + separator + 1, response.data() + response.size(), exit_code);
+    return exit_code;
+}
+
+}  // namespace analyzer::server
@@ -0,0 +1,120 @@
+#include "sexpr.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <string_view>
+
+namespace analyzer::sexpr {
+
+namespace rs = std::ranges;
+
+namespace {
+// Типы узлов, которыми грамматики обозначают имя функции, метода или класса.
+constexpr std::array<std::string_view, 6> kNameNodeKinds = {"identifier", "field_identifier", "property_identifier",
+                                                            "type_identifier", "operator_name", "destructor_name"};
+
+bool IsNameNode(const Node &node) { return rs::find(kNameNodeKinds, node.kind) != kNameNodeKinds.end(); }
+
+// Шаг пути от поля имени к самому имени: function_declarator и декларатор указателя ведут к нему полем
+// "declarator:", qualified_identifier и template_type — полем "name:", а у reference_declarator
+// и parenthesized_declarator вложенный декларатор идёт без поля.
+bool IsNamePathStep(const Node &node) {
+    if (node.field == "declarator:" || node.field == "name:")
+        return true;
+    return node.field.empty() && (node.kind.ends_with("declarator") || IsNameNode(node));
+}
+
+// Читает "[row, col]" с первой '[' не раньше `pos` и сдвигает `pos` за ']'.
+bool DecodePosition(std::string_view text, size_t &pos, Position &position) {
+    pos = text.find('[', pos);
+    if (pos == std::string_view::npos)
+        return false;
+
+    const char *last = text.data() + text.size();
+    auto [row_end, row_error] = std::from_chars(text.data() + pos + 1, last, position.line);
+    if (row_error != std::errc{} || row_end == last || *row_end != ',')
+        return false;
+
+    const char *col_start = row_end + 1;
+    while (col_start != last && *col_start == ' ')
+        ++col_start;
+    auto [col_end, col_error] = std::from_chars(col_start, last, position.col);
+    if (col_error != std::errc{} || col_end == last || *col_end != ']')
+        return false;
+
+    pos = static_cast<size_t>(col_end - text.data()) + 1;
+    return true;
+}
+}  // namespace
+
+std::optional<Span> DecodeSpan(std::string_view text, size_t &pos) {
+    Span span;
+    size_t cursor = pos;
+    if (!DecodePosition(text, cursor, span.start) || !DecodePosition(text, cursor, span.end))
+        return std::nullopt;
+    pos = cursor;
+    return span;
+}
+
+const StructureNode *FindAncestor(const StructureIndex &index, const StructureNode &node,
+                                  language::NodeCategory category) {
+    for (size_t parent = node.parent; parent != StructureNode::kNoParent; parent = index[parent].parent) {
+        if (index[parent].category == category)
+            return &index[parent];
+    }
+    return nullptr;
+}
+
+StructureIndexBuilder::StructureIndexBuilder(const language::Language &language, StructureIndex &index)
+    : language{language}, index{index}, open{index.get_allocator()} {}
+
+void StructureIndexBuilder::OnOpen(const Node &node) {
+    // У лямбд имени нет, его не ищем.
+    if (!open.empty() && !index[open.back()].name && index[open.back()].category != language::NodeCategory::Lambda) {
+        const StructureNode &owner = index[open.back()];
+        const std::string_view name_field =
+            owner.category == language::NodeCategory::Function ? std::string_view(language.function_name_field)
+                                                               : std::string_view("name:");
+        // Имя ищется только по пути деклараторов, а не как первый идентификатор поля: иначе у
+        // `operator==(const A &)` именем стал бы тип параметра, а у `Foo<T>::bar` — область видимости.
+        const bool on_name_path = name_field_depth == kNoField
+                                      ? node.depth == owner.depth + 1 && node.field == name_field
+                                      : node.depth == name_field_depth + 1 && IsNamePathStep(node);
+        if (on_name_path) {
+            if (IsNameNode(node)) {
+                index[open.back()].name = node.span;
+                name_field_depth = kNoField;
+            } else {
+                name_field_depth = node.depth;
+            }
+        }
+    }
+
+    const auto category = language.Categorize(node.kind);
+    if (category != language::NodeCategory::Function && category != language::NodeCategory::Class &&
+        category != language::NodeCategory::Lambda)
+        return;
+
+    index.push_back({.category = category,
+                     .begin = node.offset,
+                     .end = 0,
+                     .depth = node.depth,
+                     .span = node.span,
+                     .name = std::nullopt,
+                     .parent = open.empty() ? StructureNode::kNoParent : open.back()});
+    open.push_back(index.size() - 1);
+    name_field_depth = kNoField;
+}
+
+void StructureIndexBuilder::OnClose(size_t end, size_t depth) {
+    if (name_field_depth == depth)
+        name_field_depth = kNoField;
+    if (!open.empty() && index[open.back()].depth == depth) {
+        index[open.back()].end = end;
+        open.pop_back();
+        name_field_depth = kNoField;
+    }
+}
+
+}  // namespace analyzer::sexpr
@@ -0,0 +1,52 @@
+#include "analyse.hpp"
+
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "function.hpp"
+#include "metric.hpp"
+
+namespace analyzer::test {
+
+namespace {
+using Analysis = std::vector<std::pair<function::Function, metric::MetricResults>>;
+
+void Add(Analysis &analysis, std::string filename, std::optional<std::string> class_name, std::string name) {
+    function::Function function{.filename = std::pmr::string(filename),
+                                .class_name = class_name ? std::optional<std::pmr::string>(*class_name) : std::nullopt,
+                                .name = std::pmr::string(name)};
+    analysis.emplace_back(std::move(function), metric::MetricResults{});
+}
+
+std::vector<std::vector<std::string>> Names(auto &&groups) {
+    std::vector<std::vector<std::string>> names;
+    for (const auto &group : groups) {
+        names.emplace_back();
+        for (const auto &[function, results] : group)
+            names.back().emplace_back(function.name);
+    }
+    return names;
+}
+}  // namespace
+
+TEST(AnalyseTest, SplitsAnalysisByFilesAndClasses) {
+    Analysis analysis;
+    Add(analysis, "a.py", std::nullopt, "f");
+    Add(analysis, "a.py", "A", "g");
+    Add(analysis, "a.py", "A", "h");
+    Add(analysis, "a.py", std::nullopt, "k");
+    Add(analysis, "b.py", "A", "m");
+    Add(analysis, "b.py", "B", "n");
+
+    using Groups = std::vector<std::vector<std::string>>;
+    EXPECT_EQ(Names(SplitByFiles(analysis)), (Groups{{"f", "g", "h", "k"}, {"m", "n"}}));
+    // Свободные функции отбрасываются, а одноимённые классы разных файлов не сливаются.
+    EXPECT_EQ(Names(SplitByClasses(analysis)), (Groups{{"g", "h"}, {"m"}, {"n"}}));
+    EXPECT_TRUE(Names(SplitByFiles(Analysis{})).empty());
+}
+
+}  // namespace analyzer::test
@@ -0,0 +1,61 @@
+#include "batch_parser.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "file.hpp"
+
+namespace analyzer::file::test {
+
+TEST(BatchParserTest, SplitTreesIgnoresTextBetweenTrees) {
+    auto trees = BatchParser::SplitTrees("(module [0, 0] - [1, 0]\n  (pass_statement [0, 0] - [0, 4]))\n"
+                                         "a.py\t0.1 ms\n"
+                                         "(module [0, 0] - [0, 1]\n  (MISSING \")\" [0, 0] - [0, 0]))\n"
+                                         "b.py\tParse: 0.1 ms\t(MISSING \")\" [0, 0] - [0, 0])\n");
+    ASSERT_EQ(trees.size(), 2);
+    EXPECT_EQ(trees[0], "(module [0, 0] - [1, 0]\n  (pass_statement [0, 0] - [0, 4]))");
+    EXPECT_EQ(trees[1], "(module [0, 0] - [0, 1]\n  (MISSING \")\" [0, 0] - [0, 0]))");
+}
+
+TEST(BatchParserTest, SplitTreesSkipsEscapedQuotes) {
+    // Экранированная кавычка не закрывает токен, поэтому скобка после неё остаётся внутри кавычек.
+    auto trees = BatchParser::SplitTrees("(module [0, 0] - [1, 0]\n  (MISSING \"\\\")\" [0, 0] - [0, 0]))\n"
+                                         "(module [0, 0] - [0, 1])\n");
+    ASSERT_EQ(trees.size(), 2);
+    EXPECT_EQ(trees[0], "(module [0, 0] - [1, 0]\n  (MISSING \"\\\")\" [0, 0] - [0, 0]))");
+    EXPECT_EQ(trees[1], "(module [0, 0] - [0, 1])");
+}
+
+TEST(BatchParserTest, BatchedAstsMatchPerFileAsts) {
+    const std::vector<std::string> filenames{"language_a.py", "language_b.py", "many_functions.py"};
+    // Три файла в пакетах по два, не более двух процессов одновременно.
+    BatchParser parser(2, 2);
+    auto parsed = parser.Parse(filenames);
+    EXPECT_EQ(parsed.outputs.size(), 2);
+    ASSERT_EQ(parsed.asts.size(), filenames.size());
+    ASSERT_EQ(parsed.parse_times.size(), filenames.size());
+    // Время пакета делится между его файлами по размеру AST: у меньшего файла доля меньше.
+    EXPECT_LT(parsed.parse_times[0], parsed.parse_times[1]);
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        EXPECT_GT(parsed.parse_times[i].count(), 0) << filenames[i];
+        ASSERT_TRUE(parsed.asts[i].has_value()) << filenames[i];
+        // Вывод tree-sitter для отдельного файла заканчивается переводом строки после дерева.
+        EXPECT_EQ(std::string(*parsed.asts[i]) + "\n", std::string_view(File(filenames[i]).ast)) << filenames[i];
+    }
+}
+
+TEST(BatchParserTest, FailingFileDoesNotCancelItsBatch) {
+    const std::vector<std::string> filenames{"language_a.py", "missing.py", "language_b.py", "many_functions.py"};
+    BatchParser parser(4, 1);
+    auto parsed = parser.Parse(filenames);
+    ASSERT_EQ(parsed.asts.size(), filenames.size());
+    EXPECT_FALSE(parsed.asts[1].has_value());
+    for (size_t i : {0, 2, 3}) {
+        ASSERT_TRUE(parsed.asts[i].has_value()) << filenames[i];
+        EXPECT_EQ(std::string(*parsed.asts[i]) + "\n", std::string_view(File(filenames[i]).ast)) << filenames[i];
+    }
+}
+
+}  // namespace analyzer::file::test
@@ -0,0 +1,131 @@
+#include "budget.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "analyse.hpp"
+#include "file.hpp"
+#include "metric.hpp"
+#include "metric_impl/parameters_count.hpp"
+#include "result_cache.hpp"
+
+namespace analyzer::file::test {
+
+TEST(BudgetTest, ZeroLimitsAllowEverything) {
+    Budget budget;
+    File file("many_functions.py");
+    EXPECT_FALSE(budget.CheckFile(file).has_value());
+    EXPECT_FALSE(budget.CheckDeadline(file.name, Budget::Clock::now() - std::chrono::hours(1)).has_value());
+}
+
+TEST(BudgetTest, RejectsLargeAstAndTooManyFunctions) {
+    File file("many_functions.py");
+
+    auto too_large = Budget{.max_ast_bytes = file.ast.size() - 1}.CheckFile(file);
+    ASSERT_TRUE(too_large.has_value());
+    EXPECT_EQ(too_large->reason, SkipReason::AstSize);
+    EXPECT_EQ(too_large->actual, file.ast.size());
+    EXPECT_FALSE(Budget{.max_ast_bytes = file.ast.size()}.CheckFile(file).has_value());
+
+    auto too_many = Budget{.max_functions = 10}.CheckFile(file);
+    ASSERT_TRUE(too_many.has_value());
+    EXPECT_EQ(too_many->reason, SkipReason::FunctionCount);
+    EXPECT_EQ(too_many->limit, 10);
+    EXPECT_EQ(too_many->actual, 64);
+    EXPECT_FALSE(Budget{.max_functions = 64}.CheckFile(file).has_value());
+}
+
+TEST(BudgetTest, DeadlineAndWarningFormat) {
+    Budget budget{.timeout = std::chrono::milliseconds(100)};
+    EXPECT_FALSE(budget.CheckDeadline("a.py", Budget::Clock::now()).has_value());
+
+    auto late = budget.CheckDeadline("a.py", Budget::Clock::now() - std::chrono::seconds(1));
+    ASSERT_TRUE(late.has_value());
+    EXPECT_EQ(late->reason, SkipReason::Timeout);
+    EXPECT_GE(late->actual, 1000);
+    EXPECT_EQ(FormatWarning({.filename = "a.py", .reason = SkipReason::AstSize, .limit = 10, .actual = 20}),
+              "warning: file skipped file=\"a.py\" reason=ast_size limit=10 actual=20");
+}
+
+TEST(BudgetTest, OverBudgetFileContributesNoFunctions) {
+    metric::MetricExtractor extractor;
+    extractor.RegisterMetric(std::make_unique<metric::metric_impl::CountParametersMetric>());
+    size_t consumed = 0;
+    auto count = [&consumed](const auto &, const auto &) { consumed++; };
+
+    File file("many_functions.py");
+    auto skipped = AnalyseFile(file, extractor, count, Budget{.max_functions = 1});
+    ASSERT_TRUE(skipped.has_value());
+    EXPECT_EQ(skipped->filename, "many_functions.py");
+    EXPECT_EQ(consumed, 0);
+
+    auto timed_out = AnalyseFile(file, extractor, count, Budget{.timeout = std::chrono::milliseconds(1)},
+                                 Budget::Clock::now() - std::chrono::seconds(1));
+    ASSERT_TRUE(timed_out.has_value());
+    EXPECT_EQ(timed_out->reason, SkipReason::Timeout);
+    EXPECT_EQ(consumed, 0);
+
+    EXPECT_FALSE(AnalyseFile(file, extractor, count).has_value());
+    EXPECT_EQ(consumed, 64);
+}
+
+TEST(BudgetTest, SkippedFileLeavesNothingInResultCache) {
+    // Метрика дольше таймаута: файл отвергается уже после подсчёта метрик первой функции.
+    struct SlowMetric : metric::IMetric {
+    protected:
+        metric::MetricResult::ValueType CalculateImpl(const function::Function &) const override {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            return 0;
+        }
+        std::string_view Name() const override { return "Slow"; }
+    };
+    metric::ResultCache cache;
+    metric::MetricExtractor extractor;
+    extractor.RegisterMetric(std::make_unique<SlowMetric>());
+    extractor.result_cache = &cache;
+    auto ignore = [](const auto &, const auto &) {};
+
+    File file("many_functions.py");
+    auto timed_out = AnalyseFile(file, extractor, ignore, Budget{.timeout = std::chrono::milliseconds(1)});
+    ASSERT_TRUE(timed_out.has_value());
+    EXPECT_EQ(cache.GetStats().hits + cache.GetStats().misses, 0);
+    EXPECT_TRUE(cache.DuplicateClusters().empty());
+
+    extractor.metrics.clear();
+    extractor.RegisterMetric(std::make_unique<metric::metric_impl::CountParametersMetric>());
+    EXPECT_FALSE(AnalyseFile(file, extractor, ignore).has_value());
+    EXPECT_EQ(cache.GetStats().hits + cache.GetStats().misses, 64);
+}
+
+TEST(BudgetTest, SmallFilesOfSlowBatchAreNotSkipped) {
+    // Один процесс tree-sitter на все файлы: маленькие файлы в пакете с большими.
+    std::vector<std::string> files(30, "many_functions.py");
+    files.insert(files.begin(), "language_a.py");
+    files.push_back("language_b.py");
+    const BatchParser parser(files.size(), 1);
+
+    const auto parsed = parser.Parse(files);
+    auto batch_time = Budget::Clock::duration::zero();
+    for (const auto &parse_time : parsed.parse_times)
+        batch_time += parse_time;
+    EXPECT_LT(parsed.parse_times.front() * 10, batch_time);
+
+    // Таймаут меньше времени пакета: отсчитывай его каждый файл от начала разбора пакета, маленькие
+    // файлы тоже были бы пропущены.
+    const Budget budget{.timeout = std::max(std::chrono::milliseconds(1),
+                                            std::chrono::duration_cast<std::chrono::milliseconds>(batch_time / 2))};
+    metric::MetricExtractor extractor;
+    extractor.RegisterMetric(std::make_unique<metric::metric_impl::CountParametersMetric>());
+    std::vector<SkippedFile> skipped;
+    StreamFunctions(files, extractor, [](const auto &, const auto &) {}, parser, 0, budget, &skipped);
+    for (const auto &file : skipped)
+        EXPECT_EQ(file.filename, "many_functions.py");
+}
+
+}  // namespace analyzer::file::test
@@ -0,0 +1,185 @@
+#include "call_graph.hpp"
+
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "function.hpp"
+#include "metric_impl/fan_in_out.hpp"
+
+namespace analyzer::call_graph {
+
+namespace {
+std::string Span(size_t start_row, size_t start_col, size_t end_row, size_t end_col) {
+    return "[" + std::to_string(start_row) + ", " + std::to_string(start_col) + "] - [" + std::to_string(end_row) +
+           ", " + std::to_string(end_col) + "]";
+}
+
+// def <name>():
+//     <call>()
+//     ...
+// Функция начинается со строки `line` и вызывает `calls` по одному в строке; `obj.f` — вызов метода f у obj.
+function::Function MakeFunction(std::string_view filename, std::optional<std::string_view> class_name,
+                                std::string_view name, size_t line, const std::vector<std::string> &calls) {
+    std::string source = "def " + std::string(name) + "():";
+    std::string body;
+    for (size_t i = 0; i < calls.size(); ++i) {
+        const size_t row = line + 1 + i;
+        const size_t size = calls[i].size();
+        const size_t dot = calls[i].rfind('.');
+        const std::string callee =
+            dot == std::string::npos
+                ? "(identifier " + Span(row, 4, row, 4 + size) + ")"
+                : "(attribute " + Span(row, 4, row, 4 + size) + " object: (identifier " + Span(row, 4, row, 4 + dot) +
+                      ") attribute: (identifier " + Span(row, 5 + dot, row, 4 + size) + "))";
+        source += "\n    " + calls[i] + "()";
+        body += "\n    (expression_statement " + Span(row, 4, row, 6 + size) + " (call " + Span(row, 4, row, 6 + size) +
+                " function: " + callee + " arguments: (argument_list " + Span(row, 4 + size, row, 6 + size) + ")))";
+    }
+    const size_t last_row = line + calls.size();
+    const size_t last_col = source.size() - source.rfind('\n') - 1;
+    const std::string ast = "(function_definition " + Span(line, 0, last_row, last_col) + " name: (identifier " +
+                            Span(line, 4, line, 4 + name.size()) + ") body: (block" + body + "))";
+    return {.filename = std::pmr::string(filename),
+            .class_name = class_name ? std::optional<std::pmr::string>(*class_name) : std::nullopt,
+            .name = std::pmr::string(name),
+            .ast = std::pmr::string(ast),
+            .language = &language::Python(),
+            .span = sexpr::Span{.start = {line, 0}, .end = {last_row, last_col}},
+            .source = std::pmr::string(source)};
+}
+
+std::vector<FunctionId> Ids(std::span<const FunctionId> ids) { return {ids.begin(), ids.end()}; }
+}  // namespace
+
+TEST(ExtractCalleesTest, TakesLastIdentifierOfCalledExpression) {
+    //     def run(self, x):
+    //         helper()
+    //         self.helper(len(x))
+    constexpr std::string_view kSource = "def run(self, x):\n        helper()\n        self.helper(len(x))";
+    constexpr std::string_view kAst =
+        "(function_definition [3, 4] - [5, 27]\n"
+        "  name: (identifier [3, 8] - [3, 11])\n"
+        "  parameters: (parameters [3, 11] - [3, 20] (identifier [3, 12] - [3, 16]) (identifier [3, 18] - [3, 19]))\n"
+        "  body: (block [4, 8] - [5, 27]\n"
+        "    (expression_statement [4, 8] - [4, 16]\n"
+        "      (call [4, 8] - [4, 16] function: (identifier [4, 8] - [4, 14])\n"
+        "        arguments: (argument_list [4, 14] - [4, 16])))\n"
+        "    (expression_statement [5, 8] - [5, 27]\n"
+        "      (call [5, 8] - [5, 27]\n"
+        "        function: (attribute [5, 8] - [5, 19]\n"
+        "          object: (identifier [5, 8] - [5, 12]) attribute: (identifier [5, 13] - [5, 19]))\n"
+        "        arguments: (argument_list [5, 19] - [5, 27]\n"
+        "          (call [5, 20] - [5, 26] function: (identifier [5, 20] - [5, 23])\n"
+        "            arguments: (argument_list [5, 23] - [5, 26] (identifier [5, 24] - [5, 25]))))))))";
+    const function::Function function{.filename = "a.py",
+                                      .class_name = "A",
+                                      .name = "run",
+                                      .ast = std::pmr::string(kAst),
+                                      .language = &language::Python(),
+                                      .span = sexpr::Span{.start = {3, 4}, .end = {5, 27}},
+                                      .source = std::pmr::string(kSource)};
+
+    // Вложенный вызов завершается раньше внешнего, а аргумент `x` не становится именем внешнего вызова.
+    EXPECT_EQ(ExtractCallees(function), (std::vector<std::string_view>{"helper", "len", "helper"}));
+    EXPECT_EQ(ExtractCallSites(function),
+              (std::vector<CallSite>{{"helper", ""}, {"len", ""}, {"helper", "self"}}));
+
+    auto without_source = function;
+    without_source.source.clear();
+    EXPECT_TRUE(ExtractCallees(without_source).empty());
+}
+
+TEST(CallGraphTest, PrefersFunctionsOfCallerFile) {
+    const std::vector<function::Function> functions = {
+        MakeFunction("a.py", std::nullopt, "helper", 0, {}),
+        MakeFunction("a.py", std::nullopt, "run", 3, {"helper", "helper", "len", "run"}),
+        MakeFunction("b.py", std::nullopt, "helper", 0, {}),
+        MakeFunction("b.py", std::nullopt, "use", 3, {"helper", "run"}),
+    };
+    std::vector<const function::Function *> pointers;
+    for (const auto &function : functions)
+        pointers.push_back(&function);
+
+    for (size_t jobs : {1, 4}) {
+        const auto graph = CallGraph::Build(pointers, jobs);
+        ASSERT_EQ(graph.FunctionCount(), 4);
+        // Повторный вызов, рекурсия и вызов len() рёбер не добавляют.
+        EXPECT_EQ(graph.EdgeCount(), 3);
+        EXPECT_EQ(Ids(graph.Callees(1)), std::vector<FunctionId>{0});
+        EXPECT_EQ(Ids(graph.Callees(3)), (std::vector<FunctionId>{1, 2}));
+        EXPECT_EQ(Ids(graph.Callers(1)), std::vector<FunctionId>{3});
+        EXPECT_EQ(graph.FanIn(0), 1);
+        EXPECT_EQ(graph.FanIn(2), 1);
+        EXPECT_EQ(graph.FanOut(3), 2);
+        EXPECT_EQ(graph.FanIn(3), 0);
+    }
+}
+
+TEST(CallGraphTest, NarrowsCallsByReceiverAndDropsAmbiguousOnes) {
+    const std::vector<function::Function> functions = {
+        MakeFunction("src/a.py", "A", "get", 1, {}),
+        MakeFunction("src/a.py", "A", "run", 4, {"self.get", "self.put"}),
+        MakeFunction("src/b.py", "B", "get", 1, {}),
+        MakeFunction("src/c.py", std::nullopt, "use", 0, {"get", "obj.get", "A.get", "b.get"}),
+        MakeFunction("src/c.py", std::nullopt, "put", 4, {}),
+    };
+    std::vector<const function::Function *> pointers;
+    for (const auto &function : functions)
+        pointers.push_back(&function);
+
+    for (size_t jobs : {1, 3}) {
+        const auto graph = CallGraph::Build(pointers, jobs);
+        // self.get() — метод своего класса, а не B.get; put() не метод A, хотя одноимённая функция есть.
+        EXPECT_EQ(Ids(graph.Callees(1)), std::vector<FunctionId>{0});
+        // A.get() — по классу, b.get() — по модулю; get() и obj.get() неоднозначны.
+        EXPECT_EQ(Ids(graph.Callees(3)), (std::vector<FunctionId>{0, 2}));
+        EXPECT_EQ(graph.FanIn(4), 0);
+        EXPECT_EQ(graph.UnresolvedCalls(), 3);
+    }
+}
+
+TEST(CallGraphTest, FindsFunctionsByLocation) {
+    const std::vector<function::Function> functions = {
+        MakeFunction("a.py", std::nullopt, "f", 0, {}),
+        MakeFunction("a.py", "A", "f", 4, {"f"}),
+    };
+    const std::vector<const function::Function *> pointers = {&functions[0], &functions[1]};
+    const auto graph = CallGraph::Build(pointers);
+
+    EXPECT_EQ(graph.Find(functions[0]), 0);
+    EXPECT_EQ(graph.Find(functions[1]), 1);
+    EXPECT_EQ(graph.Find(MakeFunction("a.py", std::nullopt, "f", 10, {})), std::nullopt);
+    // Метод A.f вызывает свободную функцию f того же файла, а не себя.
+    EXPECT_EQ(Ids(graph.Callees(1)), std::vector<FunctionId>{0});
+}
+
+TEST(CallGraphTest, CountsClassCouplingOverDistinctOutsideFunctions) {
+    const std::vector<function::Function> functions = {
+        MakeFunction("c.py", "C", "first", 1, {"second", "util"}),
+        MakeFunction("c.py", "C", "second", 5, {"util"}),
+        MakeFunction("c.py", std::nullopt, "util", 9, {"first", "second"}),
+        MakeFunction("d.py", std::nullopt, "other", 0, {"second"}),
+    };
+    std::vector<const function::Function *> pointers;
+    for (const auto &function : functions)
+        pointers.push_back(&function);
+    const auto graph = CallGraph::Build(pointers, 2);
+
+    const auto coupling = graph.ForClass("c.py", "C");
+    EXPECT_EQ(coupling.fan_in, 2);
+    EXPECT_EQ(coupling.fan_out, 1);
+    const auto missing = graph.ForClass("d.py", "C");
+    EXPECT_EQ(missing.fan_in + missing.fan_out, 0);
+
+    const metric::metric_impl::FanInMetric fan_in(graph);
+    const metric::metric_impl::FanOutMetric fan_out(graph);
+    EXPECT_EQ(fan_in.Calculate(functions[1]).value.AsInteger(), 3);
+    EXPECT_EQ(fan_out.Calculate(functions[0]).value.AsInteger(), 2);
+    EXPECT_EQ(fan_in.Calculate(MakeFunction("e.py", std::nullopt, "g", 0, {})).value.AsInteger(), 0);
+}
+
+}  // namespace analyzer::call_graph
@@ -0,0 +1,110 @@
+#include "clones.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "function.hpp"
+
+namespace analyzer::clones {
+
+namespace {
+constexpr std::string_view kTotal =
+    "def total(prices, count):\n"
+    "    result = 0\n"
+    "    for price in prices:\n"
+    "        if price > 0:\n"
+    "            result = result + price * count\n"
+    "    return result";
+
+// Та же функция с другими именами и литералами.
+constexpr std::string_view kRenamed =
+    "def sum_weights(items, factor):\n"
+    "    acc = 1.5\n"
+    "    for item in items:\n"
+    "        if item > 'a':\n"
+    "            acc = acc + item * factor\n"
+    "    return acc";
+
+constexpr std::string_view kOther =
+    "def lookup(table, key):\n"
+    "    try:\n"
+    "        return table[key]\n"
+    "    except KeyError:\n"
+    "        raise ValueError(f\"missing {key}\")";
+
+function::Function MakeFunction(std::string_view filename, std::string_view source) {
+    return {.filename = std::pmr::string(filename),
+            .class_name = std::nullopt,
+            .name = "f",
+            .ast = "",
+            .language = &language::Python(),
+            .span = std::nullopt,
+            .source = std::pmr::string(source)};
+}
+}  // namespace
+
+TEST(ClonesTest, NormalisationIgnoresNamesAndLiterals) {
+    EXPECT_EQ(NormalizedTokenHashes(MakeFunction("a.py", kTotal)),
+              NormalizedTokenHashes(MakeFunction("b.py", kRenamed)));
+    EXPECT_NE(NormalizedTokenHashes(MakeFunction("a.py", "def f(a):\n    return a * 2")),
+              NormalizedTokenHashes(MakeFunction("a.py", "def f(a):\n    return a + 2")));
+}
+
+TEST(ClonesTest, WinnowingSelectsFingerprintInEveryWindow) {
+    constexpr size_t kGram = 5;
+    constexpr size_t kWindow = 4;
+    std::mt19937_64 random(42);
+    std::vector<std::uint64_t> tokens(300);
+    std::ranges::generate(tokens, [&] { return random() % 16; });
+
+    const auto fingerprints = Winnow(tokens, kGram, kWindow);
+    ASSERT_FALSE(fingerprints.empty());
+    EXPECT_TRUE(std::ranges::is_sorted(fingerprints, {}, &Fingerprint::position));
+    for (size_t start = 0; start + kWindow <= tokens.size() - kGram + 1; ++start) {
+        EXPECT_TRUE(std::ranges::any_of(fingerprints, [&](const Fingerprint &fingerprint) {
+            return fingerprint.position >= start && fingerprint.position < start + kWindow;
+        })) << "window at " << start;
+    }
+
+    // Общий фрагмент длиной k + window - 1 в другой последовательности даёт общий отпечаток.
+    std::vector<std::uint64_t> other(100);
+    std::ranges::generate(other, [&] { return 100 + random() % 16; });
+    std::copy(tokens.begin() + 50, tokens.begin() + 50 + kGram + kWindow - 1, other.begin() + 30);
+    const auto other_fingerprints = Winnow(other, kGram, kWindow);
+    EXPECT_TRUE(std::ranges::any_of(other_fingerprints, [&](const Fingerprint &fingerprint) {
+        return std::ranges::find(fingerprints, fingerprint.hash, &Fingerprint::hash) != fingerprints.end();
+    }));
+
+    EXPECT_EQ(Winnow(std::vector<std::uint64_t>(kGram - 1, 1), kGram, kWindow).size(), 0);
+    EXPECT_EQ(Winnow(std::vector<std::uint64_t>(kGram + 1, 1), kGram, kWindow).size(), 1);
+}
+
+TEST(ClonesTest, FindsRenamedCopiesAcrossFiles) {
+    const std::vector<function::Function> functions = {
+        MakeFunction("a.py", kTotal),
+        MakeFunction("b.py", kOther),
+        MakeFunction("c.py", kRenamed),
+    };
+    const std::vector<const function::Function *> pointers = {&functions[0], &functions[1], &functions[2]};
+    const auto tokens = NormalizedTokenHashes(functions[0]).size();
+
+    for (size_t jobs : {1, 3}) {
+        const auto pairs = FindClones(pointers, {.min_tokens = 25}, jobs);
+        ASSERT_EQ(pairs.size(), 1);
+        EXPECT_EQ(pairs[0].first, 0);
+        EXPECT_EQ(pairs[0].second, 2);
+        EXPECT_GE(pairs[0].shared_tokens, tokens - CloneOptions{}.window * 2);
+        EXPECT_LE(pairs[0].shared_tokens, tokens);
+        EXPECT_GT(pairs[0].similarity, 0.8);
+    }
+
+    // Функция короче порога не может быть копией нужной длины.
+    EXPECT_TRUE(FindClones(pointers, {.min_tokens = tokens + 1}).empty());
+}
+
+}  // namespace analyzer::clones
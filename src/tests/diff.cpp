@@ -0,0 +1,112 @@
+#include "diff.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "analyse.hpp"
+#include "metric.hpp"
+#include "metric_impl/parameters_count.hpp"
+
+namespace analyzer::diff::test {
+
+std::vector<FileDiff> Parse(const std::string &text) {
+    std::istringstream in(text);
+    return ParseUnifiedDiff(in);
+}
+
+TEST(DiffTest, ParsesChangedLinesOfEveryFile) {
+    auto files = Parse(
+        "diff --git a/pkg/a.py b/pkg/a.py\n"
+        "index 1111111..2222222 100644\n"
+        "--- a/pkg/a.py\n"
+        "+++ b/pkg/a.py\n"
+        "@@ -3,4 +3,5 @@ def f():\n"
+        " context\n"
+        "-old\n"
+        "+new\n"
+        "+newer\n"
+        " context\n"
+        " context\n"
+        "@@ -20,0 +22,2 @@\n"
+        "+inserted\n"
+        "+inserted\n"
+        "--- /dev/null\n"
+        "+++ b/b.py\n"
+        "@@ -0,0 +1,2 @@\n"
+        "+x = 1\n"
+        "+y = 2\n");
+
+    ASSERT_EQ(files.size(), 2);
+    EXPECT_EQ(files[0].old_path, "pkg/a.py");
+    EXPECT_EQ(files[0].new_path, "pkg/a.py");
+    // Замена строки 4 на строки 4-5; чистая вставка после строки 20 старой версии (строки 22-23 новой).
+    EXPECT_EQ(files[0].old_lines, (std::vector<LineRange>{{3, 3}, {19, 19}}));
+    EXPECT_EQ(files[0].new_lines, (std::vector<LineRange>{{3, 4}, {21, 22}}));
+
+    EXPECT_EQ(files[1].old_path, kNullPath);
+    EXPECT_EQ(files[1].new_path, "b.py");
+    EXPECT_EQ(files[1].new_lines, (std::vector<LineRange>{{0, 1}}));
+}
+
+TEST(DiffTest, PureDeletionMarksPrecedingLineOfNewVersion) {
+    auto files = Parse(
+        "--- a.py\t2024-01-01 00:00:00\n"
+        "+++ a.py\t2024-01-02 00:00:00\n"
+        "@@ -5,3 +5,1 @@\n"
+        " keep\n"
+        "--- removed line that looks like a header\n"
+        "-+++ and another one\n");
+
+    ASSERT_EQ(files.size(), 1);
+    EXPECT_EQ(files[0].old_path, "a.py");
+    EXPECT_EQ(files[0].old_lines, (std::vector<LineRange>{{5, 6}}));
+    EXPECT_EQ(files[0].new_lines, (std::vector<LineRange>{{4, 4}}));
+}
+
+TEST(DiffTest, TouchesOverlappingSpans) {
+    const std::vector<LineRange> changed{{3, 4}, {10, 10}};
+    auto span = [](size_t first, size_t last) { return sexpr::Span{.start = {first, 0}, .end = {last, 5}}; };
+
+    EXPECT_TRUE(Touches(changed, span(0, 3)));
+    EXPECT_TRUE(Touches(changed, span(4, 8)));
+    EXPECT_TRUE(Touches(changed, span(10, 10)));
+    EXPECT_FALSE(Touches(changed, span(5, 9)));
+    EXPECT_FALSE(Touches(changed, span(11, 20)));
+    EXPECT_FALSE(Touches({}, span(0, 100)));
+}
+
+TEST(DiffTest, AnalysesOnlyTouchedFunctions) {
+    metric::MetricExtractor extractor;
+    extractor.RegisterMetric(std::make_unique<metric::metric_impl::CountParametersMetric>());
+
+    // Функция generated_function_i занимает строки 5i..5i+2, между функциями две пустые строки.
+    auto analysis = AnalyseChangedFunctions("many_functions.py", {{6, 6}, {13, 15}}, extractor);
+    ASSERT_EQ(analysis.size(), 2);
+    EXPECT_EQ(analysis[0].first.name, "generated_function_1");
+    EXPECT_EQ(analysis[1].first.name, "generated_function_3");
+    ASSERT_EQ(analysis[0].second.size(), 1);
+    EXPECT_EQ(std::string_view(analysis[0].second[0].metric_name), metric::metric_impl::CountParametersMetric::kName);
+
+    EXPECT_TRUE(AnalyseChangedFunctions("many_functions.py", {{3, 4}}, extractor).empty());
+}
+
+TEST(DiffTest, ExtractsChangedFunctionsLikeFullAnalysis) {
+    metric::MetricExtractor extractor;
+    extractor.RegisterMetric(std::make_unique<metric::metric_impl::CountParametersMetric>());
+
+    // Изменена строка внутри inner, вложенной в outer.
+    auto enclosing = AnalyseChangedFunctions("nested_functions.py", {{2, 2}}, extractor);
+    ASSERT_EQ(enclosing.size(), 1);
+    EXPECT_EQ(enclosing[0].first.name, "outer");
+
+    const function::FunctionExtractor nested{.nested_functions = true};
+    auto with_nested = AnalyseChangedFunctions("nested_functions.py", {{2, 2}}, extractor, nested);
+    ASSERT_EQ(with_nested.size(), 2);
+    EXPECT_EQ(with_nested[1].first.qualified_name, "outer.<locals>.inner");
+}
+
+}  // namespace analyzer::diff::test
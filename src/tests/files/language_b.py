@@ -0,0 +1,5 @@
+class Second:
+    def method(self, value):
+        if value:
+            return value
+        return None
@@ -0,0 +1,318 @@
+def generated_function_0(first_argument, second_argument):
+    result = first_argument + second_argument * 0
+    return result
+
+
+def generated_function_1(first_argument, second_argument):
+    result = first_argument + second_argument * 1
+    return result
+
+
+def generated_function_2(first_argument, second_argument):
+    result = first_argument + second_argument * 2
+    return result
+
+
+def generated_function_3(first_argument, second_argument):
+    result = first_argument + second_argument * 3
+    return result
+
+
+def generated_function_4(first_argument, second_argument):
+    result = first_argument + second_argument * 4
+    return result
+
+
+def generated_function_5(first_argument, second_argument):
+    result = first_argument + second_argument * 5
+    return result
+
+
+def generated_function_6(first_argument, second_argument):
+    result = first_argument + second_argument * 6
+    return result
+
+
+def generated_function_7(first_argument, second_argument):
+    result = first_argument + second_argument * 7
+    return result
+
+
+def generated_function_8(first_argument, second_argument):
+    result = first_argument + second_argument * 8
+    return result
+
+
+def generated_function_9(first_argument, second_argument):
+    result = first_argument + second_argument * 9
+    return result
+
+
+def generated_function_10(first_argument, second_argument):
+    result = first_argument + second_argument * 10
+    return result
+
+
+def generated_function_11(first_argument, second_argument):
+    result = first_argument + second_argument * 11
+    return result
+
+
+def generated_function_12(first_argument, second_argument):
+    result = first_argument + second_argument * 12
+    return result
+
+
+def generated_function_13(first_argument, second_argument):
+    result = first_argument + second_argument * 13
+    return result
+
+
+def generated_function_14(first_argument, second_argument):
+    result = first_argument + second_argument * 14
+    return result
+
+
+def generated_function_15(first_argument, second_argument):
+    result = first_argument + second_argument * 15
+    return result
+
+
+def generated_function_16(first_argument, second_argument):
+    result = first_argument + second_argument * 16
+    return result
+
+
+def generated_function_17(first_argument, second_argument):
+    result = first_argument + second_argument * 17
+    return result
+
+
+def generated_function_18(first_argument, second_argument):
+    result = first_argument + second_argument * 18
+    return result
+
+
+def generated_function_19(first_argument, second_argument):
+    result = first_argument + second_argument * 19
+    return result
+
+
+def generated_function_20(first_argument, second_argument):
+    result = first_argument + second_argument * 20
+    return result
+
+
+def generated_function_21(first_argument, second_argument):
+    result = first_argument + second_argument * 21
+    return result
+
+
+def generated_function_22(first_argument, second_argument):
+    result = first_argument + second_argument * 22
+    return result
+
+
+def generated_function_23(first_argument, second_argument):
+    result = first_argument + second_argument * 23
+    return result
+
+
+def generated_function_24(first_argument, second_argument):
+    result = first_argument + second_argument * 24
+    return result
+
+
+def generated_function_25(first_argument, second_argument):
+    result = first_argument + second_argument * 25
+    return result
+
+
+def generated_function_26(first_argument, second_argument):
+    result = first_argument + second_argument * 26
+    return result
+
+
+def generated_function_27(first_argument, second_argument):
+    result = first_argument + second_argument * 27
+    return result
+
+
+def generated_function_28(first_argument, second_argument):
+    result = first_argument + second_argument * 28
+    return result
+
+
+def generated_function_29(first_argument, second_argument):
+    result = first_argument + second_argument * 29
+    return result
+
+
+def generated_function_30(first_argument, second_argument):
+    result = first_argument + second_argument * 30
+    return result
+
+
+def generated_function_31(first_argument, second_argument):
+    result = first_argument + second_argument * 31
+    return result
+
+
+def generated_function_32(first_argument, second_argument):
+    result = first_argument + second_argument * 32
+    return result
+
+
+def generated_function_33(first_argument, second_argument):
+    result = first_argument + second_argument * 33
+    return result
+
+
+def generated_function_34(first_argument, second_argument):
+    result = first_argument + second_argument * 34
+    return result
+
+
+def generated_function_35(first_argument, second_argument):
+    result = first_argument + second_argument * 35
+    return result
+
+
+def generated_function_36(first_argument, second_argument):
+    result = first_argument + second_argument * 36
+    return result
+
+
+def generated_function_37(first_argument, second_argument):
+    result = first_argument + second_argument * 37
+    return result
+
+
+def generated_function_38(first_argument, second_argument):
+    result = first_argument + second_argument * 38
+    return result
+
+
+def generated_function_39(first_argument, second_argument):
+    result = first_argument + second_argument * 39
+    return result
+
+
+def generated_function_40(first_argument, second_argument):
+    result = first_argument + second_argument * 40
+    return result
+
+
+def generated_function_41(first_argument, second_argument):
+    result = first_argument + second_argument * 41
+    return result
+
+
+def generated_function_42(first_argument, second_argument):
+    result = first_argument + second_argument * 42
+    return result
+
+
+def generated_function_43(first_argument, second_argument):
+    result = first_argument + second_argument * 43
+    return result
+
+
+def generated_function_44(first_argument, second_argument):
+    result = first_argument + second_argument * 44
+    return result
+
+
+def generated_function_45(first_argument, second_argument):
+    result = first_argument + second_argument * 45
+    return result
+
+
+def generated_function_46(first_argument, second_argument):
+    result = first_argument + second_argument * 46
+    return result
+
+
+def generated_function_47(first_argument, second_argument):
+    result = first_argument + second_argument * 47
+    return result
+
+
+def generated_function_48(first_argument, second_argument):
+    result = first_argument + second_argument * 48
+    return result
+
+
+def generated_function_49(first_argument, second_argument):
+    result = first_argument + second_argument * 49
+    return result
+
+
+def generated_function_50(first_argument, second_argument):
+    result = first_argument + second_argument * 50
+    return result
+
+
+def generated_function_51(first_argument, second_argument):
+    result = first_argument + second_argument * 51
+    return result
+
+
+def generated_function_52(first_argument, second_argument):
+    result = first_argument + second_argument * 52
+    return result
+
+
+def generated_function_53(first_argument, second_argument):
+    result = first_argument + second_argument * 53
+    return result
+
+
+def generated_function_54(first_argument, second_argument):
+    result = first_argument + second_argument * 54
+    return result
+
+
+def generated_function_55(first_argument, second_argument):
+    result = first_argument + second_argument * 55
+    return result
+
+
+def generated_function_56(first_argument, second_argument):
+    result = first_argument + second_argument * 56
+    return result
+
+
+def generated_function_57(first_argument, second_argument):
+    result = first_argument + second_argument * 57
+    return result
+
+
+def generated_function_58(first_argument, second_argument):
+    result = first_argument + second_argument * 58
+    return result
+
+
+def generated_function_59(first_argument, second_argument):
+    result = first_argument + second_argument * 59
+    return result
+
+
+def generated_function_60(first_argument, second_argument):
+    result = first_argument + second_argument * 60
+    return result
+
+
+def generated_function_61(first_argument, second_argument):
+    result = first_argument + second_argument * 61
+    return result
+
+
+def generated_function_62(first_argument, second_argument):
+    result = first_argument + second_argument * 62
+    return result
+
+
+def generated_function_63(first_argument, second_argument):
+    result = first_argument + second_argument * 63
+    return result
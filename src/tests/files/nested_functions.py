@@ -0,0 +1,4 @@
+def outer(x):
+    def inner(y):
+        return y
+    return inner(x)
@@ -0,0 +1,197 @@
+#include "function.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory_resource>
+#include <string_view>
+
+#include "file.hpp"
+
+namespace analyzer::function {
+
+namespace {
+constexpr std::string_view kSource =
+    "class Outer:\n"
+    "    @staticmethod\n"
+    "    async def method(x):\n"
+    "        def inner():\n"
+    "            return lambda y: y\n"
+    "        return inner\n";
+
+constexpr std::string_view kAst =
+    "(module [0, 0] - [6, 0]\n"
+    "  (class_definition [0, 0] - [5, 20]\n"
+    "    name: (identifier [0, 6] - [0, 11])\n"
+    "    body: (block [1, 4] - [5, 20]\n"
+    "      (decorated_definition [1, 4] - [5, 20]\n"
+    "        (decorator [1, 4] - [1, 17]\n"
+    "          (identifier [1, 5] - [1, 17]))\n"
+    "        definition: (function_definition [2, 4] - [5, 20]\n"
+    "          name: (identifier [2, 14] - [2, 20])\n"
+    "          parameters: (parameters [2, 20] - [2, 23]\n"
+    "            (identifier [2, 21] - [2, 22]))\n"
+    "          body: (block [3, 8] - [5, 20]\n"
+    "            (function_definition [3, 8] - [4, 30]\n"
+    "              name: (identifier [3, 12] - [3, 17])\n"
+    "              parameters: (parameters [3, 17] - [3, 19])\n"
+    "              body: (block [4, 12] - [4, 30]\n"
+    "                (return_statement [4, 12] - [4, 30]\n"
+    "                  (lambda [4, 19] - [4, 30]\n"
+    "                    parameters: (lambda_parameters [4, 26] - [4, 27]\n"
+    "                      (identifier [4, 26] - [4, 27]))\n"
+    "                    body: (identifier [4, 29] - [4, 30])))))\n"
+    "            (return_statement [5, 8] - [5, 20]\n"
+    "              (identifier [5, 15] - [5, 20]))))))))\n";
+
+constexpr std::string_view kJsSource =
+    "(function () {\n"
+    "  function setup() {}\n"
+    "})();\n"
+    "describe(() => {\n"
+    "  class Suite {\n"
+    "    run() {}\n"
+    "  }\n"
+    "});\n";
+
+constexpr std::string_view kJsAst =
+    "(program [0, 0] - [8, 0]\n"
+    "  (expression_statement [0, 0] - [2, 5]\n"
+    "    (call_expression [0, 0] - [2, 4]\n"
+    "      function: (parenthesized_expression [0, 0] - [2, 2]\n"
+    "        (function_expression [0, 1] - [2, 1]\n"
+    "          parameters: (formal_parameters [0, 10] - [0, 12])\n"
+    "          body: (statement_block [0, 13] - [2, 1]\n"
+    "            (function_declaration [1, 2] - [1, 21]\n"
+    "              name: (identifier [1, 11] - [1, 16])\n"
+    "              parameters: (formal_parameters [1, 16] - [1, 18])\n"
+    "              body: (statement_block [1, 19] - [1, 21])))))\n"
+    "      arguments: (arguments [2, 2] - [2, 4])))\n"
+    "  (expression_statement [3, 0] - [7, 3]\n"
+    "    (call_expression [3, 0] - [7, 2]\n"
+    "      function: (identifier [3, 0] - [3, 8])\n"
+    "      arguments: (arguments [3, 8] - [7, 2]\n"
+    "        (arrow_function [3, 9] - [7, 1]\n"
+    "          parameters: (formal_parameters [3, 9] - [3, 11])\n"
+    "          body: (statement_block [3, 15] - [7, 1]\n"
+    "            (class_declaration [4, 2] - [6, 3]\n"
+    "              name: (identifier [4, 8] - [4, 13])\n"
+    "              body: (class_body [4, 14] - [6, 3]\n"
+    "                (method_definition [5, 4] - [5, 12]\n"
+    "                  name: (property_identifier [5, 4] - [5, 7])\n"
+    "                  parameters: (formal_parameters [5, 7] - [5, 9])\n"
+    "                  body: (statement_block [5, 10] - [5, 12])))))))))\n";
+
+constexpr std::string_view kCppSource =
+    "bool operator==(const A &other) { return true; }\n"
+    "template <class T>\n"
+    "void Foo<T>::bar() {}\n"
+    "A::~A() {}\n";
+
+constexpr std::string_view kCppAst =
+    "(translation_unit [0, 0] - [4, 0]\n"
+    "  (function_definition [0, 0] - [0, 48]\n"
+    "    type: (primitive_type [0, 0] - [0, 4])\n"
+    "    declarator: (function_declarator [0, 5] - [0, 31]\n"
+    "      declarator: (operator_name [0, 5] - [0, 15])\n"
+    "      parameters: (parameter_list [0, 15] - [0, 31]\n"
+    "        (parameter_declaration [0, 16] - [0, 30]\n"
+    "          (type_qualifier [0, 16] - [0, 21])\n"
+    "          type: (type_identifier [0, 22] - [0, 23])\n"
+    "          declarator: (reference_declarator [0, 24] - [0, 30]\n"
+    "            (identifier [0, 25] - [0, 30])))))\n"
+    "    body: (compound_statement [0, 32] - [0, 48]\n"
+    "      (return_statement [0, 34] - [0, 46] (true [0, 41] - [0, 45]))))\n"
+    "  (template_declaration [1, 0] - [2, 21]\n"
+    "    parameters: (template_parameter_list [1, 9] - [1, 18]\n"
+    "      (type_parameter_declaration [1, 10] - [1, 17] (type_identifier [1, 16] - [1, 17])))\n"
+    "    (function_definition [2, 0] - [2, 21]\n"
+    "      type: (primitive_type [2, 0] - [2, 4])\n"
+    "      declarator: (function_declarator [2, 5] - [2, 18]\n"
+    "        declarator: (qualified_identifier [2, 5] - [2, 16]\n"
+    "          scope: (template_type [2, 5] - [2, 11]\n"
+    "            name: (type_identifier [2, 5] - [2, 8])\n"
+    "            arguments: (template_argument_list [2, 8] - [2, 11]\n"
+    "              (type_descriptor [2, 9] - [2, 10] type: (type_identifier [2, 9] - [2, 10]))))\n"
+    "          name: (identifier [2, 13] - [2, 16]))\n"
+    "        parameters: (parameter_list [2, 16] - [2, 18]))\n"
+    "      body: (compound_statement [2, 19] - [2, 21])))\n"
+    "  (function_definition [3, 0] - [3, 10]\n"
+    "    declarator: (function_declarator [3, 0] - [3, 7]\n"
+    "      declarator: (qualified_identifier [3, 0] - [3, 5]\n"
+    "        scope: (namespace_identifier [3, 0] - [3, 1])\n"
+    "        name: (destructor_name [3, 3] - [3, 5] (identifier [3, 4] - [3, 5])))\n"
+    "      parameters: (parameter_list [3, 5] - [3, 7]))\n"
+    "    body: (compound_statement [3, 8] - [3, 10])))\n";
+}  // namespace
+
+TEST(FunctionExtractorTest, TopLevelFunctionsByDefault) {
+    std::pmr::monotonic_buffer_resource arena;
+    const file::File file("outer.py", kAst, kSource, &arena);
+
+    const auto functions = FunctionExtractor{}.Get(file);
+    ASSERT_EQ(functions.size(), 1);
+    EXPECT_EQ(functions[0].name, "method");
+    EXPECT_EQ(functions[0].class_name, "Outer");
+    EXPECT_EQ(functions[0].qualified_name, "Outer.method");
+    // Декоратор не входит в границы функции, а async — входит.
+    EXPECT_TRUE(functions[0].source.starts_with("async def method(x):"));
+}
+
+TEST(FunctionExtractorTest, NestedFunctionsAndLambdasGetQualifiedNames) {
+    std::pmr::monotonic_buffer_resource arena;
+    const file::File file("outer.py", kAst, kSource, &arena);
+
+    const auto nested = FunctionExtractor{.nested_functions = true}.Get(file);
+    ASSERT_EQ(nested.size(), 2);
+    EXPECT_EQ(nested[1].name, "inner");
+    EXPECT_EQ(nested[1].qualified_name, "Outer.method.<locals>.inner");
+    // Ближайший класс остаётся классом вложенной функции.
+    EXPECT_EQ(nested[1].class_name, "Outer");
+    EXPECT_EQ(nested[1].span->start.line, 3);
+
+    const auto with_lambdas = FunctionExtractor{.nested_functions = true, .lambdas = true}.Get(file);
+    ASSERT_EQ(with_lambdas.size(), 3);
+    EXPECT_EQ(with_lambdas[2].name, "<lambda>");
+    EXPECT_EQ(with_lambdas[2].qualified_name, "Outer.method.<locals>.inner.<locals>.<lambda>");
+    EXPECT_EQ(with_lambdas[2].source, "lambda y: y");
+    EXPECT_TRUE(with_lambdas[2].ast.starts_with("(lambda "));
+
+    // Лямбды внутри функций извлекаются только вместе с вложенными функциями.
+    EXPECT_EQ(FunctionExtractor{.lambdas = true}.Get(file).size(), 1);
+}
+
+TEST(FunctionExtractorTest, FunctionsInsideJavaScriptCallbacksAreTopLevel) {
+    std::pmr::monotonic_buffer_resource arena;
+    const file::File file("suite.js", kJsAst, kJsSource, &arena);
+
+    // Без извлечения лямбд IIFE и колбэк не делают свои функции вложенными.
+    const auto functions = FunctionExtractor{}.Get(file);
+    ASSERT_EQ(functions.size(), 2);
+    EXPECT_EQ(functions[0].name, "setup");
+    EXPECT_EQ(functions[0].qualified_name, "<lambda>.<locals>.setup");
+    EXPECT_EQ(functions[1].name, "run");
+    EXPECT_EQ(functions[1].class_name, "Suite");
+    EXPECT_EQ(functions[1].qualified_name, "<lambda>.<locals>.Suite.run");
+
+    // С лямбдами анализируются сами лямбды, а их содержимое становится вложенным.
+    const auto with_lambdas = FunctionExtractor{.lambdas = true}.Get(file);
+    ASSERT_EQ(with_lambdas.size(), 2);
+    EXPECT_EQ(with_lambdas[0].name, "<lambda>");
+    EXPECT_EQ(with_lambdas[1].name, "<lambda>");
+    const auto everything = FunctionExtractor{.nested_functions = true, .lambdas = true}.Get(file);
+    EXPECT_EQ(everything.size(), 4);
+}
+
+TEST(FunctionExtractorTest, CppNamesFollowTheDeclarator) {
+    std::pmr::monotonic_buffer_resource arena;
+    const file::File file("ops.cpp", kCppAst, kCppSource, &arena);
+
+    // Имя — то, что объявляется, а не первый идентификатор декларатора: не тип параметра и не область видимости.
+    const auto functions = FunctionExtractor{}.Get(file);
+    ASSERT_EQ(functions.size(), 3);
+    EXPECT_EQ(functions[0].name, "operator==");
+    EXPECT_EQ(functions[1].name, "bar");
+    EXPECT_EQ(functions[2].name, "~A");
+}
+
+}  // namespace analyzer::function
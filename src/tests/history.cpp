@@ -0,0 +1,166 @@
+#include "history.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "function.hpp"
+#include "metric.hpp"
+
+namespace analyzer::history {
+
+namespace {
+using Analysis = std::vector<std::pair<function::Function, metric::MetricResults>>;
+
+class HistoryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const std::string test_name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        directory = std::filesystem::temp_directory_path() / ("analyzer_history_" + test_name);
+        std::filesystem::remove_all(directory);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(directory); }
+
+    static void Add(Analysis &analysis, std::optional<std::string> class_name, std::string name, int complexity,
+                    double volume, std::string qualified_name = "") {
+        function::Function function{.filename = "a.py",
+                                    .class_name = class_name ? std::optional<std::pmr::string>(*class_name)
+                                                             : std::nullopt,
+                                    .name = std::pmr::string(name),
+                                    .qualified_name = std::pmr::string(qualified_name)};
+        metric::MetricResults results;
+        results.push_back({.metric_name = "Cyclomatic Complexity", .value = complexity});
+        results.push_back({.metric_name = "Halstead Volume", .value = volume});
+        results.push_back({.metric_name = "Naming style", .value = metric::MetricValue::FromCategory("snake_case")});
+        analysis.emplace_back(std::move(function), std::move(results));
+    }
+
+    std::filesystem::path directory;
+};
+
+const FunctionTrend *Find(const std::vector<FunctionTrend> &trends, const HistoryStore &store, std::string_view name) {
+    for (const auto &trend : trends) {
+        if (store.FunctionName(trend.function) == name)
+            return &trend;
+    }
+    return nullptr;
+}
+}  // namespace
+
+TEST_F(HistoryTest, TracksFunctionsAcrossRuns) {
+    {
+        HistoryStore store(directory);
+        Analysis first;
+        Add(first, std::nullopt, "f", 1, 10.5);
+        Add(first, "A", "g", 4, 20);
+        EXPECT_EQ(store.Append(first, 100), 1);
+
+        Analysis second;
+        Add(second, "A", "g", 3, 20);
+        Add(second, std::nullopt, "f", 2, 11);
+        // Вторая функция с той же личностью не перезаписывает первую.
+        Add(second, std::nullopt, "f", 50, 99);
+        EXPECT_EQ(store.Append(second, 200), 2);
+    }
+
+    // Новый экземпляр читает всё с диска и дописывает следующий запуск.
+    HistoryStore store(directory);
+    ASSERT_EQ(store.RunCount(), 2);
+    Analysis third;
+    Add(third, std::nullopt, "f", 5, 12);
+    Add(third, std::nullopt, "h", 7, 1);
+    EXPECT_EQ(store.Append(third, 300), 3);
+    EXPECT_EQ(store.RunTimestamp(2), 200);
+
+    const auto trends = store.Trends("Cyclomatic Complexity");
+    ASSERT_EQ(trends.size(), 3);
+    const auto *f = Find(trends, store, "a.py::f");
+    ASSERT_NE(f, nullptr);
+    EXPECT_EQ(f->first, 1);
+    EXPECT_EQ(f->previous, 2);
+    EXPECT_EQ(f->last, 5);
+    EXPECT_EQ(f->runs, 3);
+    EXPECT_EQ(f->last_run, 3);
+
+    const auto *g = Find(trends, store, "a.py::A::g");
+    ASSERT_NE(g, nullptr);
+    EXPECT_EQ(g->last, 3);
+    EXPECT_EQ(g->last_run, 2);
+
+    const auto *h = Find(trends, store, "a.py::h");
+    ASSERT_NE(h, nullptr);
+    EXPECT_EQ(h->first, h->previous);
+    EXPECT_EQ(h->runs, 1);
+
+    EXPECT_FLOAT_EQ(Find(store.Trends("Halstead Volume"), store, "a.py::f")->first, 10.5);
+    // Категориальные значения в историю не попадают.
+    EXPECT_TRUE(store.Trends("Naming style").empty());
+    EXPECT_TRUE(store.Trends("Unknown").empty());
+}
+
+TEST_F(HistoryTest, NestedFunctionsAreKeyedByQualifiedName) {
+    HistoryStore store(directory);
+    Analysis analysis;
+    Add(analysis, "A", "g", 1, 1, "A.g");
+    // Одноимённые вложенные функции разных методов — разные функции истории.
+    Add(analysis, "A", "helper", 2, 1, "A.g.<locals>.helper");
+    Add(analysis, "A", "helper", 3, 1, "A.h.<locals>.helper");
+    store.Append(analysis, 100);
+
+    const auto trends = store.Trends("Cyclomatic Complexity");
+    ASSERT_EQ(trends.size(), 3);
+    // Функции, полное имя которых — класс и имя, сохраняют прежний ключ.
+    ASSERT_NE(Find(trends, store, "a.py::A::g"), nullptr);
+    const auto *first = Find(trends, store, "a.py::A.g.<locals>.helper");
+    const auto *second = Find(trends, store, "a.py::A.h.<locals>.helper");
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(first->last, 2);
+    EXPECT_EQ(second->last, 3);
+}
+
+TEST_F(HistoryTest, StoresOpenedTogetherDoNotOverwriteEachOther) {
+    // Как два процесса CI: оба открыли хранилище до того, как кто-либо из них записал запуск.
+    HistoryStore first(directory);
+    HistoryStore second(directory);
+
+    Analysis from_first;
+    Add(from_first, std::nullopt, "f", 1, 1);
+    EXPECT_EQ(first.Append(from_first, 100), 1);
+
+    Analysis from_second;
+    Add(from_second, std::nullopt, "g", 2, 2);
+    Add(from_second, std::nullopt, "f", 3, 3);
+    EXPECT_EQ(second.Append(from_second, 200), 2);
+
+    const HistoryStore store(directory);
+    ASSERT_EQ(store.RunCount(), 2);
+    const auto trends = store.Trends("Cyclomatic Complexity");
+    ASSERT_EQ(trends.size(), 2);
+    const auto *f = Find(trends, store, "a.py::f");
+    ASSERT_NE(f, nullptr);
+    EXPECT_EQ(f->first, 1);
+    EXPECT_EQ(f->last, 3);
+    const auto *g = Find(trends, store, "a.py::g");
+    ASSERT_NE(g, nullptr);
+    EXPECT_EQ(g->runs, 1);
+    EXPECT_EQ(g->last_run, 2);
+}
+
+TEST_F(HistoryTest, RejectsCorruptedSegment) {
+    HistoryStore store(directory);
+    Analysis analysis;
+    Add(analysis, std::nullopt, "f", 1, 1);
+    store.Append(analysis, 0);
+
+    std::ofstream(directory / "run-00000001.seg", std::ios::trunc) << "garbage";
+    EXPECT_THROW(store.Trends("Cyclomatic Complexity"), std::runtime_error);
+}
+
+}  // namespace analyzer::history
@@ -0,0 +1,41 @@
+#include "language.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace analyzer::language::test {
+
+TEST(LanguageTest, PicksLanguageByExtension) {
+    EXPECT_EQ(LanguageForFile("dir/module.py").name, "python");
+    EXPECT_EQ(LanguageForFile("main.cpp").name, "cpp");
+    EXPECT_EQ(LanguageForFile("include/file.hpp").name, "cpp");
+    EXPECT_EQ(LanguageForFile("server.go").name, "go");
+    EXPECT_EQ(LanguageForFile("app.js").name, "javascript");
+    EXPECT_THROW(LanguageForFile("README.md"), std::invalid_argument);
+}
+
+TEST(LanguageTest, MapsNodeKindsToCategories) {
+    const auto &python = LanguageForFile("a.py");
+    EXPECT_EQ(python.Categorize("function_definition"), NodeCategory::Function);
+    EXPECT_EQ(python.Categorize("elif_clause"), NodeCategory::Branch);
+    EXPECT_EQ(python.Categorize("while_statement"), NodeCategory::Loop);
+    EXPECT_EQ(python.Categorize("identifier"), NodeCategory::Other);
+
+    const auto &go = LanguageForFile("a.go");
+    EXPECT_EQ(go.Categorize("method_declaration"), NodeCategory::Function);
+    EXPECT_EQ(go.Categorize("function_definition"), NodeCategory::Other);
+    EXPECT_EQ(go.KindsOf(NodeCategory::Parameters), (std::vector<std::string>{"parameter_list"}));
+    EXPECT_TRUE(go.KindsOf(NodeCategory::Class).empty());
+}
+
+TEST(LanguageTest, ForEachNodeKindVisitsEveryNode) {
+    std::vector<std::string> kinds;
+    ForEachNodeKind("(module [0, 0] - [1, 0]\n  (if_statement [0, 0] - [0, 5]\n    condition: (true [0, 3] - [0, 4])))",
+                    [&kinds](std::string_view kind, size_t) { kinds.emplace_back(kind); });
+    EXPECT_EQ(kinds, (std::vector<std::string>{"module", "if_statement", "true"}));
+}
+
+}  // namespace analyzer::language::test
@@ -0,0 +1,66 @@
+#include "metric_value.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <variant>
+#include <vector>
+
+namespace analyzer::metric::test {
+
+TEST(MetricValueTest, StoresEveryKindInSixteenBytes) {
+    static_assert(sizeof(MetricValue) == 16);
+
+    constexpr MetricValue integer = std::numeric_limits<std::int64_t>::min();
+    static_assert(integer.GetKind() == MetricValue::Kind::Integer);
+    static_assert(integer.AsInteger() == std::numeric_limits<std::int64_t>::min());
+
+    constexpr MetricValue real = 0.25;
+    static_assert(real.AsReal() == 0.25);
+
+    constexpr std::array<std::int32_t, 3> items{-1, 0, 7};
+    constexpr MetricValue distribution = MetricValue::FromItems(items);
+    static_assert(distribution.ItemsCount() == 3);
+    static_assert(distribution.Items() == items);
+
+    EXPECT_THROW(integer.AsReal(), std::bad_variant_access);
+    EXPECT_THROW(real.AsCategory(), std::bad_variant_access);
+    EXPECT_THROW(MetricValue::FromItems(std::vector<std::int32_t>(4)), std::length_error);
+}
+
+TEST(MetricValueTest, InternsCategoriesOnce) {
+    const MetricValue first = MetricValue::FromCategory("Snake Case");
+    const MetricValue second = MetricValue::FromCategory(std::string_view("Snake Case"));
+    const MetricValue other = MetricValue::FromCategory("Camel Case");
+
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, other);
+    EXPECT_EQ(first.CategoryName(), "Snake Case");
+    EXPECT_EQ(other.CategoryName(), "Camel Case");
+    EXPECT_THROW(CategoryRegistry::Name(std::numeric_limits<CategoryId>::max()), std::out_of_range);
+}
+
+TEST(MetricValueTest, ConcurrentInterningAgreesOnIds) {
+    constexpr int kThreads = 8;
+    std::vector<CategoryId> ids(kThreads);
+    {
+        std::vector<std::jthread> workers;
+        for (int thread = 0; thread < kThreads; ++thread) {
+            workers.emplace_back([&ids, thread] {
+                for (int i = 0; i < 100; ++i)
+                    CategoryRegistry::Intern("Category " + std::to_string(i));
+                ids[thread] = CategoryRegistry::Intern("Shared category");
+            });
+        }
+    }
+    for (CategoryId id : ids)
+        EXPECT_EQ(id, ids.front());
+    EXPECT_EQ(CategoryRegistry::Name(ids.front()), "Shared category");
+}
+
+}  // namespace analyzer::metric::test
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+#include "file.hpp"
+#include "function.hpp"
+#include "metric.hpp"
+#include "metric_impl/code_lines_count.hpp"
+#include "metric_impl/cognitive_complexity.hpp"
+#include "metric_impl/cyclomatic_complexity.hpp"
+#include "metric_impl/halstead.hpp"
+#include "metric_impl/maintainability_index.hpp"
+#include "metric_impl/naming_style.hpp"
+#include "metric_impl/nesting_depth.hpp"
+#include "metric_impl/parameters_count.hpp"
+
+namespace {
+std::atomic<size_t> allocations_count{0};
+
+void *CountedAllocate(std::size_t size) {
+    allocations_count.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+}  // namespace
+
+void *operator new(std::size_t size) { return CountedAllocate(size); }
+void *operator new[](std::size_t size) { return CountedAllocate(size); }
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    allocations_count.fetch_add(1, std::memory_order_relaxed);
+    const auto align = static_cast<std::size_t>(alignment);
+    if (void *ptr = std::aligned_alloc(align, (size + align - 1) / align * align))
+        return ptr;
+    throw std::bad_alloc();
+}
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+namespace analyzer::test {
+
+TEST(PerFileArenaTest, FunctionsAndResultsComeFromFileArena) {
+    std::pmr::monotonic_buffer_resource arena;
+    file::File file("many_functions.py", &arena);
+    EXPECT_EQ(file.ast.get_allocator().resource(), &arena);
+
+    function::FunctionExtractor function_extractor;
+    metric::MetricExtractor metric_extractor;
+    metric_extractor.RegisterMetric(std::make_unique<metric::metric_impl::CountParametersMetric>());
+
+    const size_t allocations_before = allocations_count.load();
+    auto functions = function_extractor.Get(file);
+    size_t parameters_total = 0;
+    for (const auto &function : functions) {
+        auto results = metric_extractor.Get(function);
+        EXPECT_EQ(results.get_allocator().resource(), &arena);
+        parameters_total += results.front().value.AsInteger();
+    }
+    const size_t allocations = allocations_count.load() - allocations_before;
+
+    ASSERT_EQ(functions.size(), 64);
+    EXPECT_EQ(functions.front().name, "generated_function_0");
+    EXPECT_EQ(parameters_total, 2 * functions.size());
+    // Арена запрашивает у кучи блоки геометрически растущего размера, поэтому на функцию
+    // приходится заметно меньше одного выделения памяти.
+    EXPECT_LT(allocations * 8, functions.size());
+}
+
+TEST(PerFileArenaTest, MetricResultsLeaveArenaWithoutAllocations) {
+    using namespace metric::metric_impl;
+    std::pmr::monotonic_buffer_resource arena;
+    const file::File file("many_functions.py", &arena);
+    const auto functions = function::FunctionExtractor{}.Get(file);
+
+    metric::MetricExtractor metric_extractor;
+    metric_extractor.RegisterMetric(std::make_unique<CyclomaticComplexityMetric>());
+    metric_extractor.RegisterMetric(std::make_unique<NamingStyleMetric>());
+    metric_extractor.RegisterMetric(std::make_unique<CodeLinesCountMetric>());
+    metric_extractor.RegisterMetric(std::make_unique<CountParametersMetric>());
+    metric_extractor.RegisterMetric(std::make_unique<CognitiveComplexityMetric>());
+    metric_extractor.RegisterMetric(std::make_unique<MaxNestingDepthMetric>());
+    metric_extractor.RegisterMetric(std::make_unique<HalsteadVolumeMetric>());
+    metric_extractor.RegisterMetric(std::make_unique<HalsteadDifficultyMetric>());
+    metric_extractor.RegisterMetric(std::make_unique<HalsteadEffortMetric>());
+    metric_extractor.RegisterMetric(std::make_unique<MaintainabilityIndexMetric>());
+
+    // Первый проход заполняет буферы потока и реестр категорий; дальше они только переиспользуются.
+    for (const auto &function : functions)
+        metric_extractor.Get(function);
+    for (const auto &function : functions) {
+        function.control_flow.summary.reset();
+        function.tokens.summary.reset();
+    }
+
+    std::vector<metric::MetricResults> analysis;
+    analysis.reserve(functions.size());
+    const size_t allocations_before = allocations_count.load();
+    for (const auto &function : functions) {
+        // Копия из арены в обычный вектор, как при сборе результатов всех файлов.
+        const auto results = metric_extractor.Get(function);
+        analysis.push_back(results);
+    }
+    const size_t allocations = allocations_count.load() - allocations_before;
+
+    ASSERT_EQ(functions.size(), 64);
+    ASSERT_EQ(analysis.back().size(), metric_extractor.metrics.size());
+    EXPECT_EQ(analysis.back()[0].metric_name, CyclomaticComplexityMetric::kName);
+    EXPECT_EQ(analysis.back().get_allocator().resource(), std::pmr::get_default_resource());
+    EXPECT_EQ(allocations, 0);
+}
+
+}  // namespace analyzer::test
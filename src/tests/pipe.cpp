@@ -0,0 +1,49 @@
+#include "pipe.hpp"
+
+#include <sys/wait.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+
+namespace analyzer::file::test {
+
+TEST(PipeTest, ReadsWholeOutputInLargeChunks) {
+    std::string output = "prefix:";
+    int status = RunCommand("head -c 1000000 /dev/zero | tr '\\0' 'a'", output);
+    EXPECT_TRUE(DescribeCommandFailure(status).empty());
+    ASSERT_EQ(output.size(), 7 + 1000000);
+    EXPECT_TRUE(output.starts_with("prefix:"));
+    EXPECT_EQ(std::ranges::count(output, 'a'), 1000000);
+}
+
+TEST(PipeTest, ReadsIntoArenaString) {
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::string output{&arena};
+    int status = RunCommand("printf '(module)'", output);
+    EXPECT_TRUE(DescribeCommandFailure(status).empty());
+    EXPECT_EQ(output, "(module)");
+    EXPECT_EQ(output.get_allocator().resource(), &arena);
+}
+
+TEST(PipeTest, ReportsFailedCommand) {
+    std::string output;
+    int status = RunCommand("exit 3", output);
+    EXPECT_EQ(DescribeCommandFailure(status), "Command failed with exit code 3");
+    EXPECT_TRUE(output.empty());
+}
+
+TEST(PipeTest, ReapsCommandWhenChunkHandlerThrows) {
+    std::string output;
+    auto reject = [](std::string_view) { throw std::runtime_error("malformed output"); };
+    EXPECT_THROW(RunCommand("printf '(module'", output, reject), std::runtime_error);
+    // Команда дождана при раскрутке стека: у процесса не осталось дочерних процессов, даже зомби.
+    EXPECT_EQ(waitpid(-1, nullptr, WNOHANG), -1);
+    EXPECT_EQ(errno, ECHILD);
+}
+
+}  // namespace analyzer::file::test
@@ -0,0 +1,95 @@
+#include "policy.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "metric.hpp"
+
+namespace analyzer::policy {
+
+namespace {
+Policy ParseString(const std::string &text) {
+    std::istringstream in(text);
+    return Policy::Parse(in);
+}
+
+metric::MetricResults Results(int complexity, int parameters) {
+    metric::MetricResults results;
+    results.push_back({.metric_name = "Cyclomatic Complexity", .value = complexity});
+    results.push_back({.metric_name = "Parameters count", .value = parameters});
+    results.push_back({.metric_name = "Naming style", .value = metric::MetricValue::FromCategory("snake_case")});
+    return results;
+}
+}  // namespace
+
+TEST(PolicyTest, ParsesRulesAndSections) {
+    const auto policy = ParseString(
+        "# Общие пределы\n"
+        "Cyclomatic Complexity = 10\n"
+        "\n"
+        "  Parameters count=4  \n"
+        "[tests/*]\n"
+        "Cyclomatic Complexity = 20.5\n");
+
+    ASSERT_EQ(policy.Rules().size(), 3);
+    EXPECT_EQ(policy.Rules()[0].glob, "*");
+    EXPECT_EQ(policy.Rules()[1].metric, "Parameters count");
+    EXPECT_EQ(policy.Rules()[1].threshold, 4);
+    EXPECT_EQ(policy.Rules()[2].glob, "tests/*");
+    EXPECT_EQ(policy.Rules()[2].threshold, 20.5);
+    EXPECT_EQ(policy.Rules()[2].line, 6);
+    EXPECT_TRUE(policy.UsesMetric("Parameters count"));
+    EXPECT_FALSE(policy.UsesMetric("Naming style"));
+}
+
+TEST(PolicyTest, ReportsLineOfMalformedRule) {
+    for (const std::string text : {"A = 1\nno threshold\n", "A = 1\nA = ten\n", "A = 1\n[]\n", "A = 1\n = 3\n"}) {
+        try {
+            ParseString(text);
+            ADD_FAILURE() << "accepted: " << text;
+        } catch (const std::invalid_argument &error) {
+            EXPECT_TRUE(std::string(error.what()).starts_with("Policy line 2:")) << error.what();
+        }
+    }
+}
+
+TEST(PolicyTest, RejectsUnknownMetrics) {
+    const auto policy = ParseString("Cyclomatic Complexity = 10\n[tests/*]\nCyclomatic Complexty = 20\n");
+    auto is_known = [](std::string_view metric) { return metric == "Cyclomatic Complexity"; };
+    try {
+        policy.RequireKnownMetrics(is_known);
+        ADD_FAILURE() << "accepted a misspelled metric";
+    } catch (const std::invalid_argument &error) {
+        EXPECT_TRUE(std::string(error.what()).starts_with("Policy line 3:")) << error.what();
+    }
+    EXPECT_NO_THROW(ParseString("Cyclomatic Complexity = 10\n").RequireKnownMetrics(is_known));
+}
+
+TEST(PolicyTest, LastMatchingRuleWins) {
+    const auto policy = ParseString(
+        "Cyclomatic Complexity = 10\n"
+        "Parameters count = 3\n"
+        "Naming style = 0\n"
+        "[tests/*]\n"
+        "Cyclomatic Complexity = 20\n");
+
+    const auto violations = policy.Check("src/a.py", Results(15, 4));
+    ASSERT_EQ(violations.size(), 2);
+    EXPECT_EQ(violations[0].rule->line, 1);
+    EXPECT_EQ(violations[0].value, 15);
+    EXPECT_EQ(violations[1].rule->metric, "Parameters count");
+
+    // Секция для тестов поднимает предел сложности, общий предел параметров остаётся.
+    const auto in_tests = policy.Check("tests/unit/a.py", Results(15, 4));
+    ASSERT_EQ(in_tests.size(), 1);
+    EXPECT_EQ(in_tests[0].rule->metric, "Parameters count");
+    EXPECT_EQ(policy.Check("tests/a.py", Results(21, 3)).size(), 1);
+
+    // Значение, равное пределу, не нарушение; категориальные значения не проверяются.
+    EXPECT_TRUE(policy.Check("src/a.py", Results(10, 3)).empty());
+}
+
+}  // namespace analyzer::policy
@@ -0,0 +1,130 @@
+#include "prefetcher.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bounded_queue.hpp"
+#include "file.hpp"
+
+namespace analyzer::file::test {
+
+TEST(BoundedQueueTest, ProducerWaitsForFreeSlot) {
+    BoundedQueue<int> queue(2);
+    std::atomic<int> pushed{0};
+    std::thread producer([&] {
+        for (int i = 0; i < 5; ++i) {
+            queue.Push(i);
+            pushed++;
+        }
+        queue.Close();
+    });
+
+    // Ждём, пока производитель не упрётся в заполненную очередь, без расчёта на время.
+    while (queue.BlockedProducers() == 0)
+        std::this_thread::yield();
+    EXPECT_EQ(queue.Size(), 2);
+    EXPECT_EQ(pushed, 2);
+
+    std::vector<int> popped;
+    while (auto value = queue.Pop()) {
+        popped.push_back(*value);
+    }
+    producer.join();
+    EXPECT_EQ(popped, (std::vector<int>{0, 1, 2, 3, 4}));
+}
+
+TEST(BoundedQueueTest, ClosedQueueRejectsPush) {
+    BoundedQueue<int> queue(1);
+    queue.Close();
+    EXPECT_FALSE(queue.Push(1));
+    EXPECT_FALSE(queue.Pop().has_value());
+}
+
+TEST(PrefetcherTest, YieldsFilesInOrderWithSourceAndAst) {
+    const std::vector<std::string> filenames{"language_a.py", "missing.py", "language_b.py", "many_functions.py"};
+    BatchParser parser(1, 2);
+    Prefetcher prefetcher(filenames, parser, 1);
+
+    std::vector<std::string> seen;
+    while (auto prefetched = prefetcher.Next()) {
+        seen.push_back(prefetched->filename);
+        if (prefetched->filename == "missing.py") {
+            EXPECT_FALSE(prefetched->source.has_value());
+            continue;
+        }
+        ASSERT_TRUE(prefetched->source.has_value());
+        ASSERT_TRUE(prefetched->ast.has_value());
+
+        std::ifstream in(prefetched->filename);
+        std::stringstream expected_source;
+        expected_source << in.rdbuf();
+        EXPECT_EQ(*prefetched->source, expected_source.str());
+
+        File prefetched_file(prefetched->filename, *prefetched->ast, *prefetched->source);
+        File disk_file(prefetched->filename, *prefetched->ast);
+        EXPECT_EQ(prefetched_file.source_lines, disk_file.source_lines);
+        EXPECT_EQ(prefetched_file.structure.size(), disk_file.structure.size());
+    }
+    EXPECT_EQ(seen, filenames);
+}
+
+TEST(PrefetcherTest, YieldsParsedBatchBeforeLaterBatchesFinish) {
+    // Второй пакет — именованный канал: его разбор и чтение не закончатся, пока в канал не напишут.
+    const auto fifo = std::filesystem::temp_directory_path() / "analyzer_prefetcher_fifo.py";
+    std::filesystem::remove(fifo);
+    ASSERT_EQ(mkfifo(fifo.c_str(), 0600), 0);
+    const std::vector<std::string> filenames{"language_a.py", fifo.string()};
+    // Оба файла поместились бы в один пакет, но тогда первый ждал бы разбора второго.
+    BatchParser parser(BatchParser::kDefaultBatchSize, 1);
+    Prefetcher prefetcher(filenames, parser, 4);
+
+    auto first = std::async(std::launch::async, [&] { return prefetcher.Next(); });
+    const bool yielded_early = first.wait_for(std::chrono::seconds(30)) == std::future_status::ready;
+
+    // Каждое открытие канала на запись отдаёт конец файла читателям, которые к этому моменту его открыли.
+    std::atomic<bool> drained{false};
+    std::thread writer([&] {
+        while (!drained) {
+            const int fd = open(fifo.c_str(), O_WRONLY | O_NONBLOCK);
+            if (fd != -1)
+                close(fd);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    EXPECT_TRUE(yielded_early);
+    const auto prefetched = first.get();
+    ASSERT_TRUE(prefetched.has_value());
+    EXPECT_EQ(prefetched->filename, "language_a.py");
+    EXPECT_TRUE(prefetched->ast.has_value());
+    auto last = prefetcher.Next();
+    ASSERT_TRUE(last.has_value());
+    EXPECT_EQ(last->filename, fifo.string());
+    EXPECT_FALSE(prefetcher.Next().has_value());
+
+    drained = true;
+    writer.join();
+    std::filesystem::remove(fifo);
+}
+
+TEST(PrefetcherTest, StopsReaderWhenConsumerLeavesEarly) {
+    const std::vector<std::string> filenames(16, "language_a.py");
+    BatchParser parser(2, 1);
+    Prefetcher prefetcher(filenames, parser, 1);
+    ASSERT_TRUE(prefetcher.Next().has_value());
+    // Деструктор не должен зависнуть, хотя фоновый поток ждёт места в очереди.
+}
+
+}  // namespace analyzer::file::test
@@ -0,0 +1,202 @@
+#include "result_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "function.hpp"
+#include "metric.hpp"
+
+namespace analyzer::metric::test {
+
+namespace {
+function::Function MakeFunction(const std::string &filename, const std::string &name, size_t first_line,
+                                size_t indent = 0) {
+    auto position = [&](size_t line, size_t col) {
+        return "[" + std::to_string(first_line + line) + ", " + std::to_string(indent + col) + "]";
+    };
+    function::Function function{.filename = std::pmr::string(filename),
+                                .class_name = std::nullopt,
+                                .name = std::pmr::string(name),
+                                .ast = std::pmr::string("(function_definition " + position(0, 0) + " - " +
+                                                        position(2, 12) + "\n  body: (block " + position(1, 4) +
+                                                        " - " + position(2, 12) + "\n    (return_statement " +
+                                                        position(2, 4) + " - " + position(2, 12) + ")))")};
+    function.span = sexpr::Span{.start = {first_line, indent}, .end = {first_line + 2, indent + 12}};
+    return function;
+}
+
+struct CountingMetric : IMetric {
+    explicit CountingMetric(std::atomic<int> &calls) : calls{calls} {}
+
+protected:
+    MetricResult::ValueType CalculateImpl(const function::Function &) const override { return ++calls; }
+    std::string_view Name() const override { return "Calls"; }
+
+private:
+    std::atomic<int> &calls;
+};
+}  // namespace
+
+TEST(FingerprintTest, IgnoresPositionButNotStructureOrName) {
+    const auto fingerprint = FingerprintFunction(MakeFunction("a.py", "f", 0));
+    EXPECT_EQ(FingerprintFunction(MakeFunction("b.py", "f", 40)), fingerprint);
+    EXPECT_EQ(FingerprintFunction(MakeFunction("b.py", "f", 7, 4)), fingerprint);
+    EXPECT_NE(FingerprintFunction(MakeFunction("a.py", "g", 0)), fingerprint);
+
+    auto longer = MakeFunction("a.py", "f", 0);
+    longer.ast.replace(longer.ast.find("[2, 12])))"), 10, "[3, 12])))");
+    EXPECT_NE(FingerprintFunction(longer), fingerprint);
+
+    auto other_statement = MakeFunction("a.py", "f", 0);
+    other_statement.ast.replace(other_statement.ast.find("return_statement"), 16, "pass_statement");
+    EXPECT_NE(FingerprintFunction(other_statement), fingerprint);
+}
+
+TEST(FingerprintTest, IncludesSourceUpToWhitespace) {
+    auto sum = MakeFunction("a.py", "f", 0);
+    sum.source = "def f():\n    x = 1\n    return a + b";
+    auto indented = MakeFunction("b.py", "f", 7, 4);
+    indented.source = "    def f():\n        x = 1\n        return a + b";
+    EXPECT_EQ(FingerprintFunction(indented), FingerprintFunction(sum));
+
+    // AST тот же, но лексемы другие: метрики Холстеда различаются.
+    auto product = MakeFunction("a.py", "f", 0);
+    product.source = "def f():\n    x = 1\n    return a * b";
+    EXPECT_NE(FingerprintFunction(product), FingerprintFunction(sum));
+}
+
+TEST(ResultCacheTest, ComputesMetricsOncePerFingerprint) {
+    std::atomic<int> calls{0};
+    ResultCache cache;
+    MetricExtractor extractor;
+    extractor.RegisterMetric(std::make_unique<CountingMetric>(calls));
+    extractor.result_cache = &cache;
+
+    auto first = extractor.Get(MakeFunction("a.py", "f", 0));
+    auto copy = extractor.Get(MakeFunction("b.py", "f", 10));
+    auto other = extractor.Get(MakeFunction("b.py", "g", 20));
+    auto another_copy = extractor.Get(MakeFunction("c.py", "f", 3));
+
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(copy.front().value.AsInteger(), first.front().value.AsInteger());
+    EXPECT_EQ(another_copy.front().value.AsInteger(), first.front().value.AsInteger());
+    EXPECT_NE(other.front().value.AsInteger(), first.front().value.AsInteger());
+    EXPECT_EQ(std::string_view(copy.front().metric_name), "Calls");
+
+    const auto stats = cache.GetStats();
+    EXPECT_EQ(stats.hits, 2);
+    EXPECT_EQ(stats.misses, 2);
+    EXPECT_DOUBLE_EQ(stats.HitRate(), 0.5);
+
+    const auto clusters = cache.DuplicateClusters();
+    ASSERT_EQ(clusters.size(), 1);
+    EXPECT_EQ(clusters.front().locations,
+              (std::vector<ResultCache::Location>{{"a.py", "f", 1}, {"b.py", "f", 11}, {"c.py", "f", 4}}));
+}
+
+TEST(ResultCacheTest, RepeatedAnalysisKeepsResultsButNotLocations) {
+    std::atomic<int> calls{0};
+    ResultCache cache;
+    MetricExtractor extractor;
+    extractor.RegisterMetric(std::make_unique<CountingMetric>(calls));
+    extractor.result_cache = &cache;
+
+    // Та же функция, проанализированная дважды, — не дубликат самой себя.
+    extractor.Get(MakeFunction("a.py", "f", 0));
+    extractor.Get(MakeFunction("a.py", "f", 0));
+    EXPECT_TRUE(cache.DuplicateClusters().empty());
+
+    cache.BeginAnalysis();
+    EXPECT_EQ(cache.GetStats().hits + cache.GetStats().misses, 0);
+    extractor.Get(MakeFunction("a.py", "f", 0));
+    extractor.Get(MakeFunction("b.py", "f", 5));
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(cache.GetStats().hits, 2);
+    ASSERT_EQ(cache.DuplicateClusters().size(), 1);
+    EXPECT_EQ(cache.DuplicateClusters().front().locations,
+              (std::vector<ResultCache::Location>{{"a.py", "f", 1}, {"b.py", "f", 6}}));
+}
+
+TEST(ResultCacheTest, BeginAnalysisDropsFunctionsMissingFromLastAnalysis) {
+    std::atomic<int> calls{0};
+    ResultCache cache;
+    MetricExtractor extractor;
+    extractor.RegisterMetric(std::make_unique<CountingMetric>(calls));
+    extractor.result_cache = &cache;
+
+    extractor.Get(MakeFunction("a.py", "f", 0));
+    extractor.Get(MakeFunction("a.py", "g", 5));
+    cache.BeginAnalysis();
+    extractor.Get(MakeFunction("a.py", "f", 0));
+    EXPECT_EQ(calls, 2);
+
+    // g не встретилась во втором анализе и выброшена, f осталась.
+    cache.BeginAnalysis();
+    extractor.Get(MakeFunction("a.py", "g", 5));
+    extractor.Get(MakeFunction("a.py", "f", 0));
+    EXPECT_EQ(calls, 3);
+    EXPECT_EQ(cache.GetStats().hits, 1);
+}
+
+TEST(ResultCacheTest, LocationsUseQualifiedNames) {
+    std::atomic<int> calls{0};
+    ResultCache cache;
+    MetricExtractor extractor;
+    extractor.RegisterMetric(std::make_unique<CountingMetric>(calls));
+    extractor.result_cache = &cache;
+
+    // Одноимённые вложенные классы различаются только полным именем.
+    for (const std::string outer : {"First", "Second"}) {
+        auto method = MakeFunction("a.py", "m", outer == "First" ? 0 : 10, 8);
+        method.class_name = "Inner";
+        method.qualified_name = outer + ".Inner.m";
+        extractor.Get(method);
+    }
+    ASSERT_EQ(cache.DuplicateClusters().size(), 1);
+    EXPECT_EQ(cache.DuplicateClusters().front().locations,
+              (std::vector<ResultCache::Location>{{"a.py", "First.Inner.m", 1}, {"a.py", "Second.Inner.m", 11}}));
+}
+
+TEST(ResultCacheTest, ConcurrentLookupsCountEveryFunction) {
+    constexpr size_t kThreads = 8;
+    constexpr size_t kFunctionsPerThread = 200;
+    constexpr size_t kUniqueNames = 10;
+
+    std::atomic<int> calls{0};
+    ResultCache cache;
+    MetricExtractor extractor;
+    extractor.RegisterMetric(std::make_unique<CountingMetric>(calls));
+    extractor.result_cache = &cache;
+
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < kThreads; ++thread) {
+        threads.emplace_back([&, thread] {
+            for (size_t i = 0; i < kFunctionsPerThread; ++i) {
+                auto name = "f" + std::to_string(i % kUniqueNames);
+                extractor.Get(MakeFunction("t" + std::to_string(thread) + ".py", name, i * 3));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    const auto stats = cache.GetStats();
+    EXPECT_EQ(stats.hits + stats.misses, kThreads * kFunctionsPerThread);
+    // Одновременные промахи по одному отпечатку возможны, но не больше, чем по одному на поток.
+    EXPECT_GE(stats.misses, kUniqueNames);
+    EXPECT_LE(stats.misses, kUniqueNames * kThreads);
+
+    const auto clusters = cache.DuplicateClusters();
+    ASSERT_EQ(clusters.size(), kUniqueNames);
+    for (const auto &cluster : clusters) {
+        EXPECT_EQ(cluster.locations.size(), kThreads * kFunctionsPerThread / kUniqueNames);
+    }
+}
+
+}  // namespace analyzer::metric::test
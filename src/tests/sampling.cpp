@@ -0,0 +1,99 @@
+#include "sampling.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "function.hpp"
+#include "metric.hpp"
+
+namespace analyzer::sampling {
+
+namespace {
+std::vector<std::string> MakeFiles(size_t count) {
+    std::vector<std::string> files;
+    for (size_t i = 0; i < count; ++i)
+        files.push_back("src/module_" + std::to_string(i) + ".py");
+    return files;
+}
+
+function::Function MakeFunction(const std::string &filename) {
+    return {.filename = std::pmr::string(filename), .class_name = std::nullopt, .name = "f"};
+}
+
+metric::MetricResults Results(int lines, std::string_view style) {
+    metric::MetricResults results;
+    results.push_back({.metric_name = "Code lines count", .value = lines});
+    results.push_back({.metric_name = "Naming style", .value = metric::MetricValue::FromCategory(style)});
+    return results;
+}
+}  // namespace
+
+TEST(SamplingTest, SampleIsDeterministicAndIgnoresFileOrder) {
+    const auto files = MakeFiles(1000);
+    EXPECT_EQ(SampleSize(files.size(), 0.05), 50);
+    EXPECT_EQ(SampleSize(3, 0.01), 1);
+    EXPECT_THROW(SampleSize(3, 1.5), std::invalid_argument);
+
+    const auto sample = SampleFiles(files, 50, 7);
+    ASSERT_EQ(sample.size(), 50);
+    EXPECT_EQ(sample, SampleFiles(files, 50, 7));
+    EXPECT_NE(sample, SampleFiles(files, 50, 8));
+    // Выбранные файлы идут в исходном порядке.
+    EXPECT_TRUE(std::ranges::is_sorted(sample, {}, [&](const std::string &file) {
+        return std::ranges::find(files, file) - files.begin();
+    }));
+
+    auto reversed = files;
+    std::ranges::reverse(reversed);
+    auto reversed_sample = SampleFiles(reversed, 50, 7);
+    std::ranges::reverse(reversed_sample);
+    EXPECT_EQ(reversed_sample, sample);
+
+    EXPECT_EQ(SampleFiles(files, 2000, 7), files);
+}
+
+TEST(SamplingTest, ExtrapolatesTotalsWithConfidenceInterval) {
+    // 4 файла из 10: суммы строк по файлам 10, 20, 30 и 0 (в файле нет функций).
+    TotalEstimator estimator(10, 4);
+    estimator.Add(MakeFunction("a.py"), Results(4, "snake_case"));
+    estimator.Add(MakeFunction("a.py"), Results(6, "snake_case"));
+    estimator.Add(MakeFunction("b.py"), Results(20, "camelCase"));
+    estimator.Add(MakeFunction("c.py"), Results(30, "snake_case"));
+    estimator.Finalize();
+
+    // Среднее 15, выборочная дисперсия 500/3, поправка на конечность 1 - 4/10.
+    const auto lines = estimator.Sum("Code lines count");
+    EXPECT_DOUBLE_EQ(lines.total, 150);
+    EXPECT_NEAR(lines.margin, 1.96 * 10 * std::sqrt(0.6 * 500.0 / 3 / 4), 0.01);
+    EXPECT_EQ(estimator.Sum("Unknown").total, 0);
+
+    const auto styles = estimator.Categories("Naming style");
+    ASSERT_EQ(styles.size(), 2);
+    EXPECT_EQ(styles[0].first, "snake_case");
+    EXPECT_DOUBLE_EQ(styles[0].second.total, 7.5);
+    EXPECT_EQ(styles[1].first, "camelCase");
+    EXPECT_DOUBLE_EQ(styles[1].second.total, 2.5);
+    EXPECT_GT(styles[1].second.margin, 0);
+}
+
+TEST(SamplingTest, FullSampleIsExact) {
+    TotalEstimator estimator(2, 2);
+    estimator.Add(MakeFunction("a.py"), Results(3, "snake_case"));
+    estimator.Add(MakeFunction("b.py"), Results(5, "snake_case"));
+    estimator.Finalize();
+    EXPECT_EQ(estimator.Sum("Code lines count").total, 8);
+    EXPECT_EQ(estimator.Sum("Code lines count").margin, 0);
+
+    TotalEstimator single(5, 1);
+    single.Add(MakeFunction("a.py"), Results(3, "snake_case"));
+    single.Finalize();
+    EXPECT_EQ(single.Sum("Code lines count").total, 15);
+    EXPECT_TRUE(std::isinf(single.Sum("Code lines count").margin));
+}
+
+}  // namespace analyzer::sampling
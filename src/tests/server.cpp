@@ -0,0 +1,116 @@
+#include "server.hpp"
+
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace analyzer::server::test {
+
+namespace {
+std::string SocketPath() {
+    return (std::filesystem::temp_directory_path() / ("analyzer-test-" + std::to_string(getpid()) + ".sock")).string();
+}
+
+// Вызывает клиента и возвращает напечатанный им отчёт.
+std::string RunClientToString(const std::string &socket_path, const std::vector<std::string> &args, int &exit_code) {
+    char *buffer = nullptr;
+    size_t size = 0;
+    std::FILE *out = open_memstream(&buffer, &size);
+    exit_code = RunClient(socket_path, args, out);
+    std::fclose(out);
+    std::string report(buffer, size);
+    std::free(buffer);
+    return report;
+}
+}  // namespace
+
+TEST(ServerTest, AnswersRequestsAndKeepsStateBetweenThem) {
+    size_t requests = 0;
+    std::string working_directory;
+    Server server(SocketPath(), [&](const std::vector<std::string> &args, std::FILE *out) {
+        requests++;
+        working_directory = std::filesystem::current_path().string();
+        for (const auto &arg : args) {
+            std::fprintf(out, "[%s]", arg.c_str());
+        }
+        std::fprintf(out, " request %zu", requests);
+        return args.empty() ? 0 : 3;
+    });
+
+    std::thread serving([&server] {
+        server.ServeOne();
+        server.ServeOne();
+    });
+
+    int exit_code = -1;
+    EXPECT_EQ(RunClientToString(SocketPath(), {"-f", "a b.py", ""}, exit_code), "[-f][a b.py][] request 1");
+    EXPECT_EQ(exit_code, 3);
+    EXPECT_EQ(working_directory, std::filesystem::current_path().string());
+
+    EXPECT_EQ(RunClientToString(SocketPath(), {}, exit_code), " request 2");
+    EXPECT_EQ(exit_code, 0);
+    serving.join();
+}
+
+TEST(ServerTest, ReportsHandlerErrorsToClient) {
+    Server server(SocketPath(), [](const std::vector<std::string> &, std::FILE *) -> int {
+        throw std::runtime_error("Can't open file missing.py");
+    });
+    std::thread serving([&server] { server.ServeOne(); });
+
+    int exit_code = 0;
+    EXPECT_EQ(RunClientToString(SocketPath(), {"-f", "missing.py"}, exit_code),
+              "Error: Can't open file missing.py\n");
+    EXPECT_EQ(exit_code, 1);
+    serving.join();
+}
+
+TEST(ServerTest, SurvivesClientThatLeavesBeforeReply) {
+    std::promise<void> client_left;
+    auto left = client_left.get_future();
+    size_t requests = 0;
+    Server server(SocketPath(), [&](const std::vector<std::string> &, std::FILE *out) {
+        // Первый клиент закрывает сокет, пока запрос ещё обрабатывается.
+        if (++requests == 1)
+            left.wait();
+        std::fprintf(out, "report %zu", requests);
+        return 0;
+    });
+    std::thread serving([&server] {
+        server.ServeOne();
+        server.ServeOne();
+    });
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, SocketPath().c_str(), sizeof(address.sun_path) - 1);
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_NE(fd, -1);
+    ASSERT_EQ(connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)), 0);
+    const std::string request = std::filesystem::current_path().string() + '\0' + "0" + '\0';
+    ASSERT_EQ(write(fd, request.data(), request.size()), static_cast<ssize_t>(request.size()));
+    close(fd);
+    client_left.set_value();
+
+    // Ответ ушёл в закрытый сокет, но демон жив и отвечает следующему клиенту.
+    int exit_code = -1;
+    EXPECT_EQ(RunClientToString(SocketPath(), {}, exit_code), "report 2");
+    EXPECT_EQ(exit_code, 0);
+    serving.join();
+}
+
+TEST(ServerTest, ClientFailsWithoutDaemon) {
+    EXPECT_THROW(RunClient(SocketPath() + ".absent", {}), std::runtime_error);
+}
+
+}  // namespace analyzer::server::test
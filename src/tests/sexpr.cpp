@@ -0,0 +1,158 @@
+#include "sexpr.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "language.hpp"
+
+namespace analyzer::sexpr::test {
+
+namespace {
+constexpr std::string_view kAst = R"((module [0, 0] - [7, 0]
+  (class_definition [0, 0] - [6, 20]
+    name: (identifier [0, 6] - [0, 9])
+    body: (block [1, 4] - [6, 20]
+      (function_definition [1, 4] - [4, 16]
+        name: (identifier [1, 8] - [1, 14])
+        parameters: (parameters [1, 14] - [1, 20]
+          (identifier [1, 15] - [1, 19]))
+        body: (block [2, 8] - [4, 16]
+          (expression_statement [2, 8] - [2, 21]
+            (string [2, 8] - [2, 21]))
+          (function_definition [3, 8] - [4, 16]
+            name: (identifier [3, 12] - [3, 17])
+            parameters: (parameters [3, 17] - [3, 19])
+            body: (block [4, 12] - [4, 16]
+              (pass_statement [4, 12] - [4, 16])))))
+      (ERROR [5, 4] - [5, 8]
+        (MISSING ")(" [5, 4] - [5, 4]))
+      (function_definition [6, 4] - [6, 20]
+        name: (identifier [6, 8] - [6, 10])
+        parameters: (parameters [6, 10] - [6, 12])
+        body: (block [6, 14] - [6, 20]
+          (pass_statement [6, 14] - [6, 18]))))))
+)";
+
+struct RecordingHandler {
+    void OnOpen(const Node &node) { opened.push_back(std::string(node.field) + std::string(node.kind)); }
+    void OnClose(size_t, size_t depth) { closed_depths.push_back(depth); }
+
+    std::vector<std::string> opened;
+    std::vector<size_t> closed_depths;
+};
+
+StructureIndex BuildIndex(std::string_view ast, size_t chunk_size) {
+    StructureIndex index;
+    StructureIndexBuilder builder(language::Python(), index);
+    Tokenizer tokenizer(builder);
+    for (size_t pos = 0; pos < ast.size(); pos += chunk_size) {
+        tokenizer.Feed(ast.substr(pos, chunk_size));
+    }
+    tokenizer.Finish();
+    return index;
+}
+}  // namespace
+
+TEST(DecodeSpanTest, DecodesConsecutiveSpans) {
+    constexpr std::string_view text = "(block [12, 4] - [130, 16]\n  (pass_statement [13, 8] - [13, 12]))";
+    size_t pos = 0;
+    auto block = DecodeSpan(text, pos);
+    ASSERT_TRUE(block.has_value());
+    EXPECT_EQ(block->start.line, 12);
+    EXPECT_EQ(block->start.col, 4);
+    EXPECT_EQ(block->end.line, 130);
+    EXPECT_EQ(block->end.col, 16);
+    EXPECT_EQ(text[pos - 1], ']');
+
+    auto pass = DecodeSpan(text, pos);
+    ASSERT_TRUE(pass.has_value());
+    EXPECT_EQ(pass->start.line, 13);
+    EXPECT_EQ(pass->end.col, 12);
+
+    EXPECT_FALSE(DecodeSpan(text, pos).has_value());
+}
+
+TEST(DecodeSpanTest, RejectsMalformedSpans) {
+    for (std::string_view text : {"(a [1 - [2, 3])", "(a [1, x] - [2, 3])", "(a [1, 2] - [2, 3", "(a)"}) {
+        size_t pos = 0;
+        EXPECT_FALSE(DecodeSpan(text, pos).has_value()) << text;
+        EXPECT_EQ(pos, 0) << text;
+    }
+}
+
+TEST(SexprTokenizerTest, ReportsNodesWithFieldsAndDepth) {
+    RecordingHandler handler;
+    Tokenizer tokenizer(handler);
+    tokenizer.Feed("(module [0, 0] - [1, 0] (expression_statement [0, 0] - [0, 5] ");
+    tokenizer.Feed("value: (MISSING \"(\" [0, 5] - [0, 5])))");
+    tokenizer.Finish();
+
+    EXPECT_EQ(handler.opened, (std::vector<std::string>{"module", "expression_statement", "value:MISSING"}));
+    EXPECT_EQ(handler.closed_depths, (std::vector<size_t>{2, 1, 0}));
+}
+
+TEST(SexprTokenizerTest, IndexesFunctionsAndClasses) {
+    auto index = BuildIndex(kAst, kAst.size());
+    ASSERT_EQ(index.size(), 4);
+
+    EXPECT_EQ(index[0].category, language::NodeCategory::Class);
+    EXPECT_EQ(index[0].parent, StructureNode::kNoParent);
+    ASSERT_TRUE(index[0].name.has_value());
+    EXPECT_EQ(index[0].name->start.col, 6);
+
+    const auto &method = index[1];
+    EXPECT_EQ(method.category, language::NodeCategory::Function);
+    EXPECT_EQ(method.parent, 0);
+    EXPECT_EQ(method.span.start.line, 1);
+    EXPECT_EQ(method.span.end.line, 4);
+    EXPECT_EQ(method.span.end.col, 16);
+    ASSERT_TRUE(method.name.has_value());
+    EXPECT_EQ(method.name->start.col, 8);
+    EXPECT_EQ(method.name->end.col, 14);
+
+    std::string_view method_ast = kAst.substr(method.begin, method.end - method.begin);
+    EXPECT_TRUE(method_ast.starts_with("(function_definition [1, 4]"));
+    EXPECT_TRUE(method_ast.ends_with("(pass_statement [4, 12] - [4, 16])))))"));
+
+    EXPECT_EQ(index[2].parent, 1);
+    EXPECT_EQ(FindAncestor(index, index[2], language::NodeCategory::Function), &index[1]);
+    EXPECT_EQ(FindAncestor(index, index[2], language::NodeCategory::Class), &index[0]);
+
+    // Скобки в кавычках внутри ERROR не сбивают вложенность: последний метод тоже принадлежит классу.
+    EXPECT_EQ(index[3].parent, 0);
+    EXPECT_EQ(index[3].name->start.line, 6);
+    EXPECT_GT(index[3].end, index[3].begin);
+}
+
+TEST(SexprTokenizerTest, ChunkBoundariesDoNotChangeIndex) {
+    auto expected = BuildIndex(kAst, kAst.size());
+    for (size_t chunk_size : {1, 2, 3, 7, 64}) {
+        auto index = BuildIndex(kAst, chunk_size);
+        ASSERT_EQ(index.size(), expected.size()) << chunk_size;
+        for (size_t i = 0; i < index.size(); ++i) {
+            EXPECT_EQ(index[i].begin, expected[i].begin) << chunk_size;
+            EXPECT_EQ(index[i].end, expected[i].end) << chunk_size;
+            EXPECT_EQ(index[i].parent, expected[i].parent) << chunk_size;
+            EXPECT_EQ(index[i].span.end.col, expected[i].span.end.col) << chunk_size;
+            EXPECT_EQ(index[i].name->start.col, expected[i].name->start.col) << chunk_size;
+        }
+    }
+}
+
+TEST(WalkNodesTest, ReportsSameEventsAsTokenizer) {
+    RecordingHandler streamed;
+    Tokenizer tokenizer(streamed);
+    tokenizer.Feed(kAst);
+    tokenizer.Finish();
+
+    RecordingHandler walked;
+    WalkNodes(kAst, walked);
+
+    EXPECT_EQ(walked.opened, streamed.opened);
+    EXPECT_EQ(walked.closed_depths, streamed.closed_depths);
+}
+
+}  // namespace analyzer::sexpr::test